@@ -4,12 +4,13 @@ from nora_contrib.player_controller import PlayerController
 
 class FPSDisplayComponent(Component):
     def start(self):
-        self.last_fps = 0.0
+        self.subscription = EventBus.subscribe(FrameRateEvent, self.on_frame_rate)
 
-    def update(self):
-        if self.last_fps != Time.fps:
-            self.owner.get_component(Text).text = f"{Time.fps} FPS"
-            self.last_fps = Time.fps
+    def on_destroy(self):
+        EventBus.unsubscribe(self.subscription)
+
+    def on_frame_rate(self, events):
+        self.owner.get_component(Text).text = f"{events[-1].fps} FPS"
 
 
 def init_cuboid(t: Texture):
@@ -23,16 +24,21 @@ def init_cuboid(t: Texture):
         Vec3(1.5,  2.0, -2.5),
     ]
 
+    cube_entity = Entity()
+    cube_component = CuboidMesh()
+    cube_component.texture = t
+    cube_entity.add_component(cube_component)
+    cube_prefab = Prefab(cube_entity)
+
+    transforms = []
     for i in range(len(cube_positions)):
-        cube_entity = Entity()
-        cube_entity.transform.local_position = cube_positions[i]
+        transform = Transform()
+        transform.local_position = cube_positions[i]
         angle = 20 * i
-        cube_entity.transform.local_rotation = Vec3(angle, angle, angle)
-        cube_component = CuboidMesh()
-        cube_component.texture = t
-        cube_component.set_owner(cube_entity)
-        cube_entity.add_component(cube_component)
-        Window.scene.add_entity(cube_entity)
+        transform.local_rotation = Vec3(angle, angle, angle)
+        transforms.append(transform)
+
+    Window.scene.instantiate(cube_prefab, transforms)
 
 
 def init_sphere(t: Texture):
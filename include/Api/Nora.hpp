@@ -1,13 +1,21 @@
 #include <iostream>
 #include <pybind11/embed.h>
 #include <pybind11/operators.h>
+#include <pybind11/numpy.h>
 #include "Core/Time.hpp"
 #include "Core/Input.hpp"
 #include "Core/Key.hpp"
 #include "Core/Debug.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/Events.hpp"
 #include "Graphics/Color.hpp"
 #include "Graphics/Sprite.hpp"
 #include "World/Entity.hpp"
+#include "World/EntityCommandBuffer.hpp"
+#include "World/Prefab.hpp"
+#include "World/ComponentPool.hpp"
+#include "World/Registry.hpp"
 #include "World/Component.hpp"
 #include "World/Camera.hpp"
 #include "World/Transform.hpp"
@@ -24,6 +32,112 @@
 
 namespace py = pybind11;
 
+// Tags from Python: a name ("enemy"), a mask (int) or a sequence of either
+inline TagMask ToTagMask(const py::handle& tags) {
+    if (py::isinstance<py::str>(tags)) {
+        return SceneIndex::Tag(tags.cast<std::string>());
+    }
+    if (py::isinstance<py::int_>(tags)) {
+        return tags.cast<TagMask>();
+    }
+
+    TagMask mask = 0;
+    for (const py::handle tag : tags) {
+        mask |= ToTagMask(tag);
+    }
+    return mask;
+}
+
+// True when obj is an instance of a bound native component class (CuboidMesh, Camera...),
+// false for Python classes deriving from Component, which have to go through PythonComponentWrapper.
+inline bool IsNativeComponent(const py::handle& obj) {
+    ComponentTypeId type;
+    return Registry::FindPythonType(Py_TYPE(obj.ptr()), type) && !Registry::IsScriptType(type);
+}
+
+// Native components are attached as is, Python ones through a PythonComponentWrapper
+inline std::shared_ptr<Component> ToComponent(const py::object& obj) {
+    if (IsNativeComponent(obj)) {
+        return obj.cast<std::shared_ptr<Component>>();
+    }
+    return std::make_shared<PythonComponentWrapper>(obj);
+}
+
+// Gives T (and its component bases) a registry type id and maps its Python class onto it
+template<typename T, typename... Bases>
+void RegisterComponentType() {
+    const ComponentTypeId type = Registry::RegisterType<T, Bases...>();
+    Registry::BindPythonType(py::type::of<T>().ptr(), type);
+}
+
+// Subscribes a Python callable to T events, called with a list holding the frame's batch
+template<typename T>
+SubscriptionId SubscribePython(const py::function& callback) {
+    return EventBus::Subscribe<T>([callback](const T* events, std::size_t count) {
+        try {
+            py::list batch(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                batch[i] = py::cast(events[i]);
+            }
+            callback(batch);
+        }
+        catch (const py::error_already_set& e) {
+            std::cerr << "Python exception in event callback: " << e.what() << std::endl;
+        }
+    });
+}
+
+// Engine events known to Python, dispatched from their bound class
+template<typename... Events>
+SubscriptionId SubscribePython(const py::handle& type, const py::function& callback) {
+    SubscriptionId id = 0;
+    const bool found = ((type.is(py::type::of<Events>()) && (id = SubscribePython<Events>(callback), true)) || ...);
+    if (!found) {
+        throw py::type_error("EventBus.subscribe: not an event type");
+    }
+    return id;
+}
+
+template<typename... Events>
+void PublishPython(const py::handle& event) {
+    const bool found = ((py::isinstance<Events>(event) && (EventBus::Publish(event.cast<const Events&>()), true)) || ...);
+    if (!found) {
+        throw py::type_error("EventBus.publish: not an event");
+    }
+}
+
+// Instance transforms for Scene.instantiate: an (N, 3 | 6 | 9) float array, or a list of Vec3
+// (positions) or of Transform (position, rotation and scale)
+inline std::vector<EntityHandle> InstantiatePython(Scene& scene, const Prefab& prefab, const py::handle& transforms) {
+    if (py::hasattr(transforms, "__array_interface__")) {
+        auto array = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(transforms);
+        if (!array || array.ndim() != 2 || (array.shape(1) != 3 && array.shape(1) != 6 && array.shape(1) != 9)) {
+            throw py::value_error("Scene.instantiate: expected an (N, 3), (N, 6) or (N, 9) float array");
+        }
+        return scene.Instantiate(prefab, array.data(), static_cast<std::size_t>(array.shape(0)), static_cast<std::size_t>(array.shape(1)));
+    }
+
+    const py::sequence items = py::reinterpret_borrow<py::sequence>(transforms);
+    const std::size_t count = items.size();
+    const std::size_t stride = count > 0 && py::isinstance<Transform>(items[0]) ? 9 : 3;
+
+    std::vector<float> rows;
+    rows.reserve(count * stride);
+    for (const py::handle item : items) {
+        if (stride == 9) {
+            const Transform& transform = item.cast<const Transform&>();
+            for (const glm::vec3& part : { transform.GetLocalPosition(), transform.GetLocalRotation(), transform.GetLocalScale() }) {
+                rows.insert(rows.end(), { part.x, part.y, part.z });
+            }
+        }
+        else {
+            const glm::vec3& position = item.cast<const glm::vec3&>();
+            rows.insert(rows.end(), { position.x, position.y, position.z });
+        }
+    }
+    return scene.Instantiate(prefab, rows.data(), count, stride);
+}
+
 PYBIND11_EMBEDDED_MODULE(nora, m) {
     py::class_<Debug>(m, "Debug")
         .def_static("info", &Debug::Info, py::arg("message"))
@@ -48,6 +162,7 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
 
     py::class_<glm::mat4>(m, "Mat4")
         .def(py::init<>())
+        .def(py::self * py::self)
         .def("__repr__", [](const glm::mat4& mat) {
             std::string s = "<Mat4\n";
             for (int i = 0; i < 4; ++i) {
@@ -69,6 +184,7 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
         .def_property("local_scale", &Transform::GetLocalScale, &Transform::SetLocalScale)
         .def_property_readonly("global_position", &Transform::GetGlobalPosition)
         .def_property_readonly("model_matrix", &Transform::GetModelMatrix)
+        .def_property_readonly("render_matrix", &Transform::GetRenderMatrix)
         .def_property_readonly("right", &Transform::GetRight)
         .def_property_readonly("up", &Transform::GetUp)
         .def_property_readonly("backward", &Transform::GetBackward)
@@ -97,7 +213,117 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
 
     py::class_<Time>(m, "Time")
         .def_property_readonly_static("delta_time", [](py::object) { return Time::DeltaTime(); }, "Delta time between frames.")
-        .def_property_readonly_static("fps", [](py::object) { return Time::FPS(); }, "Current frames per second.");
+        .def_property_readonly_static("fps", [](py::object) { return Time::FPS(); }, "Current frames per second.")
+        .def_property_static("fixed_delta_time",
+            [](py::object) { return Time::FixedDeltaTime(); },
+            [](py::object, float value) { Time::SetFixedDeltaTime(value); },
+            "Time between two fixed updates.")
+        .def_property_static("max_fixed_steps",
+            [](py::object) { return Time::MaxFixedSteps(); },
+            [](py::object, int value) { Time::SetMaxFixedSteps(value); },
+            "Maximum number of fixed updates run in one frame.")
+        .def_property_readonly_static("interpolation_alpha", [](py::object) { return Time::InterpolationAlpha(); }, "Progress towards the next fixed update, in [0, 1].");
+
+    py::class_<JobSystem>(m, "JobSystem")
+        .def_property_readonly_static("worker_count", [](py::object) { return JobSystem::WorkerCount(); }, "Number of worker threads.")
+        .def_property_readonly_static("steal_rate", [](py::object) { return JobSystem::GetStats().StealRate(); }, "Fraction of jobs executed by a thief.")
+        .def_property_readonly_static("idle_time", [](py::object) { return JobSystem::GetStats().idleSeconds; }, "Seconds spent idle, summed over the workers.")
+        .def_static("reset_stats", &JobSystem::ResetStats);
+
+    py::class_<WindowResizeEvent>(m, "WindowResizeEvent")
+        .def(py::init<>())
+        .def_readonly("width", &WindowResizeEvent::width)
+        .def_readonly("height", &WindowResizeEvent::height);
+
+    py::class_<FrameRateEvent>(m, "FrameRateEvent")
+        .def(py::init<>())
+        .def_readonly("fps", &FrameRateEvent::fps);
+
+    py::class_<KeyEvent>(m, "KeyEvent")
+        .def(py::init<>())
+        .def_readonly("key", &KeyEvent::key)
+        .def_readonly("pressed", &KeyEvent::pressed)
+        .def_readonly("repeat", &KeyEvent::repeat);
+
+    py::class_<MouseButtonEvent>(m, "MouseButtonEvent")
+        .def(py::init<>())
+        .def_readonly("button", &MouseButtonEvent::button)
+        .def_readonly("pressed", &MouseButtonEvent::pressed);
+
+    py::class_<EntitySpawnedEvent>(m, "EntitySpawnedEvent")
+        .def(py::init<>())
+        .def_readonly("entity", &EntitySpawnedEvent::entity);
+
+    py::class_<CollisionEvent>(m, "CollisionEvent")
+        .def(py::init<EntityHandle, EntityHandle>(), py::arg("first"), py::arg("second"))
+        .def_readonly("first", &CollisionEvent::first)
+        .def_readonly("second", &CollisionEvent::second);
+
+    py::class_<EventBus>(m, "EventBus")
+        .def_static("subscribe", [](const py::handle& type, const py::function& callback) {
+            return SubscribePython<WindowResizeEvent, FrameRateEvent, KeyEvent, MouseButtonEvent, EntitySpawnedEvent, CollisionEvent>(type, callback);
+        }, py::arg("event_type"), py::arg("callback"), "Calls callback once per frame with the list of pending events of that type.")
+        .def_static("unsubscribe", &EventBus::Unsubscribe, py::arg("subscription"))
+        .def_static("publish", [](const py::handle& event) {
+            PublishPython<WindowResizeEvent, FrameRateEvent, KeyEvent, MouseButtonEvent, EntitySpawnedEvent, CollisionEvent>(event);
+        }, py::arg("event"), "Queues the event for the next dispatch.");
+
+    py::class_<FrameGraph>(m, "FrameGraph")
+        .def("add_node", [](FrameGraph& self, const std::string& name, const py::function& callback, const std::vector<std::string>& reads, const std::vector<std::string>& writes) {
+            // Python nodes hold the GIL, they stay on the main thread
+            self.AddNode(name, [callback]() {
+                try {
+                    callback();
+                }
+                catch (const py::error_already_set& e) {
+                    std::cerr << "Python error in frame graph node: " << e.what() << std::endl;
+                }
+            }, reads, writes);
+        }, py::arg("name"), py::arg("callback"), py::arg("reads") = std::vector<std::string>(), py::arg("writes") = std::vector<std::string>())
+        .def_property_readonly("nodes", [](const FrameGraph& self) {
+            std::vector<std::string> names;
+            for (FrameNodeId id = 0; id < self.Size(); ++id) {
+                names.push_back(self.Name(id));
+            }
+            return names;
+        })
+        .def("node_time", [](const FrameGraph& self, const std::string& name) {
+            const FrameNodeId id = self.Find(name);
+            if (id == FrameGraph::INVALID_NODE) {
+                throw py::key_error("No frame graph node named '" + name + "'");
+            }
+            return self.NodeTime(id);
+        }, py::arg("name"), "Milliseconds the node took last frame.")
+        .def_property_readonly("critical_path", [](const FrameGraph& self) {
+            std::vector<std::string> names;
+            for (FrameNodeId id : self.CriticalPath()) {
+                names.push_back(self.Name(id));
+            }
+            return names;
+        }, "Names of the chain of dependent nodes that took the longest last frame.")
+        .def_property_readonly("critical_path_time", &FrameGraph::CriticalPathTime, "Milliseconds of the critical path last frame.")
+        .def_property_readonly("frame_time", &FrameGraph::FrameTime, "Milliseconds the whole graph took last frame.");
+
+    py::class_<FrustumCuller::Stats>(m, "CullStats")
+        .def_readonly("tested", &FrustumCuller::Stats::tested)
+        .def_readonly("visible", &FrustumCuller::Stats::visible)
+        .def_readonly("culled", &FrustumCuller::Stats::culled)
+        .def_readonly("hidden", &FrustumCuller::Stats::hidden);
+
+    py::class_<OcclusionCuller::Stats>(m, "OcclusionStats")
+        .def_readonly("occluders", &OcclusionCuller::Stats::occluders)
+        .def_readonly("triangles", &OcclusionCuller::Stats::triangles)
+        .def_readonly("tested", &OcclusionCuller::Stats::tested)
+        .def_readonly("occluded", &OcclusionCuller::Stats::occluded);
+
+    py::class_<RenderQueue::Stats>(m, "RenderStats")
+        .def_readonly("draws", &RenderQueue::Stats::draws)
+        .def_readonly("program_binds", &RenderQueue::Stats::programBinds)
+        .def_readonly("texture_binds", &RenderQueue::Stats::textureBinds)
+        .def_readonly("vertex_array_binds", &RenderQueue::Stats::vertexArrayBinds)
+        .def_readonly("program_binds_skipped", &RenderQueue::Stats::programBindsSkipped)
+        .def_readonly("texture_binds_skipped", &RenderQueue::Stats::textureBindsSkipped)
+        .def_readonly("vertex_array_binds_skipped", &RenderQueue::Stats::vertexArrayBindsSkipped);
 
     py::class_<Window>(m, "Window", py::module_local())
         .def_property_static(
@@ -131,6 +357,43 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
                 Window::GetInstance().SetScene(scene);
             },
             "The current scene of the window."
+        )
+        .def_property_readonly_static(
+            "commands",
+            [](py::object) -> EntityCommandBuffer& {
+                return Window::GetInstance().GetCommands();
+            },
+            py::return_value_policy::reference,
+            "Structural changes applied at the start of the next frame."
+        )
+        .def_property_readonly_static(
+            "frame_graph",
+            [](py::object) -> FrameGraph& {
+                return Window::GetInstance().GetFrameGraph();
+            },
+            py::return_value_policy::reference,
+            "The nodes run each frame."
+        )
+        .def_property_readonly_static(
+            "cull_stats",
+            [](py::object) {
+                return Window::GetInstance().GetCullStats();
+            },
+            "Meshes tested against the camera frustum, drawn and culled last frame."
+        )
+        .def_property_readonly_static(
+            "occlusion_stats",
+            [](py::object) {
+                return Window::GetInstance().GetOcclusionStats();
+            },
+            "Occluders drawn and meshes hidden behind them last frame."
+        )
+        .def_property_readonly_static(
+            "render_stats",
+            [](py::object) {
+                return Window::GetInstance().GetRenderStats();
+            },
+            "Draws issued and state binds made or skipped last frame."
         );
 
     py::enum_<Key>(m, "Key")
@@ -232,17 +495,40 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
             "Returns current mouse scroll delta."
         );
 
+    py::enum_<UpdatePriority>(m, "UpdatePriority")
+        .value("Critical", UpdatePriority::Critical)
+        .value("High", UpdatePriority::High)
+        .value("Normal", UpdatePriority::Normal)
+        .value("Low", UpdatePriority::Low);
+
+    py::class_<UpdateScheduler>(m, "UpdateScheduler")
+        .def_property("budget", &UpdateScheduler::Budget, &UpdateScheduler::SetBudget, "Milliseconds of Python update per frame, 0 for no limit.")
+        .def_property("near_distance", &UpdateScheduler::NearDistance, [](UpdateScheduler& self, float value) {
+            self.SetDistances(value, self.FarDistance());
+        })
+        .def_property("far_distance", &UpdateScheduler::FarDistance, [](UpdateScheduler& self, float value) {
+            self.SetDistances(self.NearDistance(), value);
+        })
+        .def_property_readonly("updated", &UpdateScheduler::Updated, "Python updates run last frame.")
+        .def_property_readonly("deferred", &UpdateScheduler::Deferred, "Python updates pushed to a later frame last frame.");
+
     py::class_<Component, std::shared_ptr<Component>>(m, "Component")
         .def(py::init<>())
         .def("start", &Component::Start)
         .def("update", &Component::Update)
+        .def("fixed_update", &Component::FixedUpdate)
+        .def("late_update", &Component::LateUpdate)
+        .def("on_destroy", &Component::OnDestroy)
         .def("set_owner", &Component::SetOwner)
         .def_property_readonly("owner", [](const Component& self) {
             return self.GetOwner();
-        });
+        })
+        .def_property_readonly("owner_handle", &Component::GetOwnerHandle)
+        .def_property("update_priority", &Component::GetUpdatePriority, &Component::SetUpdatePriority, "How often update runs, see UpdateScheduler.")
+        .def_property_readonly("delta_time", &Component::GetDeltaTime, "Frame time covered by the current update.");
 
     py::class_<Camera, Component, std::shared_ptr<Camera>>(m, "Camera")
-        .def(py::init<>())
+        .def(py::init([]() { return ComponentPool<Camera>::Create(); }))
         .def_property_readonly("front", [](const Camera& cam) {
             return cam.GetFront();
         }, "Direction vector the camera is facing.")
@@ -253,32 +539,228 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
         .def_property("yaw", &Camera::GetYaw, &Camera::SetYaw, "Camera field of view in degrees.")
         .def_property("pitch", &Camera::GetPitch, &Camera::SetPitch, "Camera field of view in degrees.");
 
+    py::class_<SceneQuery>(m, "Query")
+        .def("__len__", &SceneQuery::Size)
+        // Index based so the sequence protocol stays valid if entities are added while iterating
+        .def("__getitem__", [](const SceneQuery& self, std::size_t index) -> Entity* {
+            if (index >= self.Size()) {
+                throw py::index_error();
+            }
+            return self.Entities()[index];
+        }, py::return_value_policy::reference);
+
+    py::class_<SceneSnapshot>(m, "Snapshot")
+        .def_property_readonly("entity_count", &SceneSnapshot::EntityCount)
+        .def_property_readonly("chunk_count", &SceneSnapshot::ChunkCount)
+        .def_property_readonly("shared_chunks", &SceneSnapshot::SharedChunks)
+        .def_property_readonly("own_bytes", &SceneSnapshot::OwnBytes);
+
+    py::class_<BoundingVolumeHierarchy>(m, "Bvh")
+        .def("__len__", &BoundingVolumeHierarchy::Size)
+        .def("query_box", [](const BoundingVolumeHierarchy& self, const glm::vec3& min, const glm::vec3& max) {
+            std::vector<Entity*> entities;
+            self.Query(Aabb(min, max), entities);
+            return entities;
+        }, py::arg("min"), py::arg("max"), py::return_value_policy::reference)
+        .def("query_sphere", [](const BoundingVolumeHierarchy& self, const glm::vec3& center, float radius) {
+            std::vector<Entity*> entities;
+            self.QuerySphere(center, radius, entities);
+            return entities;
+        }, py::arg("center"), py::arg("radius"), py::return_value_policy::reference)
+        .def("query_frustum", [](const BoundingVolumeHierarchy& self, const glm::mat4& viewProjection) {
+            std::vector<Entity*> entities;
+            self.Query(Frustum(viewProjection), entities);
+            return entities;
+        }, py::arg("view_projection"), py::return_value_policy::reference)
+        .def("nearest", [](const BoundingVolumeHierarchy& self, const glm::vec3& point, std::size_t k, float maxDistance) {
+            std::vector<Entity*> entities;
+            self.Nearest(point, k, entities, maxDistance);
+            return entities;
+        }, py::arg("point"), py::arg("k") = 1, py::arg("max_distance") = std::numeric_limits<float>::max(),
+            py::return_value_policy::reference)
+        .def("bounds", [](const BoundingVolumeHierarchy& self, const Entity& entity) {
+            const Aabb bounds = self.GetBounds(entity.GetId());
+            return py::make_tuple(bounds.min, bounds.max);
+        }, py::arg("entity"))
+        .def("rebuild", &BoundingVolumeHierarchy::Rebuild)
+        .def_property_readonly("depth", &BoundingVolumeHierarchy::Depth)
+        .def_property_readonly("cost", &BoundingVolumeHierarchy::Cost);
+
+    py::class_<PotentiallyVisibleSet>(m, "Pvs")
+        .def("cell_at", [](const PotentiallyVisibleSet& self, const glm::vec3& position) -> py::object {
+            const std::uint32_t cell = self.CellAt(position);
+            return cell == PotentiallyVisibleSet::NONE ? py::none() : py::cast(cell);
+        }, py::arg("position"), "Cell containing the point, None outside the level or in a solid cell.")
+        .def("visible", [](const PotentiallyVisibleSet& self, const glm::vec3& position) {
+            return self.VisibleEntities(self.CellAt(position));
+        }, py::arg("position"), py::return_value_policy::reference, "The static meshes that may be seen from the point.")
+        .def("save", &PotentiallyVisibleSet::Save, py::arg("path"))
+        .def_property_readonly("bounds", [](const PotentiallyVisibleSet& self) {
+            return py::make_tuple(self.GetBounds().min, self.GetBounds().max);
+        })
+        .def_property_readonly("cell_count", [](const PotentiallyVisibleSet& self) { return self.GetStats().cells; })
+        .def_property_readonly("open_cells", [](const PotentiallyVisibleSet& self) { return self.GetStats().openCells; })
+        .def_property_readonly("object_count", [](const PotentiallyVisibleSet& self) { return self.GetStats().objects; })
+        .def_property_readonly("size", [](const PotentiallyVisibleSet& self) { return self.GetStats().bytes; })
+        .def_property_readonly("bake_seconds", [](const PotentiallyVisibleSet& self) { return self.GetStats().bakeSeconds; });
+
     py::class_<Scene>(m, "Scene")
         .def(py::init<>())
         .def("add_entity", &Scene::AddEntity)
-        .def("get_root_entities", &Scene::GetRootEntities);
+        .def("get_root_entities", &Scene::GetRootEntities)
+        .def("find", &Scene::FindEntity, py::arg("name"), py::return_value_policy::reference,
+            "An entity with that name, None when there is none.")
+        .def("find_all", &Scene::FindEntities, py::arg("name"), py::return_value_policy::reference)
+        .def("find_tagged", [](const Scene& self, const py::handle& tags) {
+            return self.FindTagged(ToTagMask(tags));
+        }, py::arg("tags"), py::return_value_policy::reference, "Entities carrying every one of the tags.")
+        .def("snapshot", [](const Scene& self, const SceneSnapshot* previous) {
+            return self.Snapshot(previous);
+        }, py::arg("previous") = nullptr, "Captures the scene, sharing what did not change with `previous`.")
+        .def("restore", &Scene::Restore, py::arg("snapshot"))
+        .def("save", &Scene::Save, py::arg("path"), "Writes the scene to a binary scene file.")
+        .def("load", &Scene::Load, py::arg("path"), "Adds the entities of a binary scene file, returns the handles of its roots.")
+        .def_property_readonly("scheduler", &Scene::GetScheduler, py::return_value_policy::reference_internal)
+        .def_property_readonly("bvh", &Scene::GetBvh, py::return_value_policy::reference_internal)
+        .def("bake_pvs", [](Scene& self, float cellSize, int voxelsPerCell, int raysPerPair) -> PotentiallyVisibleSet& {
+            PotentiallyVisibleSet::Settings settings;
+            settings.cellSize = cellSize;
+            settings.voxelsPerCell = voxelsPerCell;
+            settings.raysPerPair = raysPerPair;
+            return self.BakePvs(settings);
+        }, py::arg("cell_size") = 4.0f, py::arg("voxels_per_cell") = 8, py::arg("rays_per_pair") = 32,
+            py::return_value_policy::reference_internal, "Bakes the visibility of the static meshes and attaches it.")
+        .def_property_readonly("pvs", &Scene::GetPvs, py::return_value_policy::reference_internal)
+        .def("instantiate", [](Scene& self, const Prefab& prefab, const py::handle& transforms) {
+            const std::vector<EntityHandle> instances = InstantiatePython(self, prefab, transforms);
+            py::list handles(instances.size());
+            for (std::size_t i = 0; i < instances.size(); ++i) {
+                handles[i] = py::cast(instances[i]);
+            }
+            return handles;
+        }, py::arg("prefab"), py::arg("transforms"), "Adds one copy of the prefab per transform, returns their handles.")
+        .def("query", [](Scene& self, const py::args& types) -> SceneQuery& {
+            std::vector<ComponentTypeId> type_ids;
+            for (const py::handle type : types) {
+                ComponentTypeId type_id;
+                if (!Registry::FindPythonType(type.ptr(), type_id)) {
+                    // A Python class that has no instance yet: give it an id so later instances match
+                    type.inc_ref();
+                    type_id = Registry::RegisterScriptType(type.ptr());
+                }
+                type_ids.push_back(type_id);
+            }
+            return self.Query(std::move(type_ids));
+        }, py::return_value_policy::reference_internal);
 
-    py::class_<Entity, std::shared_ptr<Entity>>(m, "Entity")
+    py::class_<EntityHandle>(m, "EntityHandle")
         .def(py::init<>())
+        .def_readonly("index", &EntityHandle::index)
+        .def_readonly("generation", &EntityHandle::generation)
+        .def_property_readonly("valid", [](const EntityHandle& self) {
+            return Registry::Resolve(self) != nullptr;
+        })
+        .def("get", [](const EntityHandle& self) {
+            return Registry::Resolve(self);
+        }, py::return_value_policy::reference)
+        .def(py::self == py::self)
+        .def(py::self != py::self)
+        .def("__hash__", [](const EntityHandle& self) {
+            return std::hash<EntityHandle>()(self);
+        })
+        .def("__repr__", [](const EntityHandle& self) {
+            return "<EntityHandle index=" + std::to_string(self.index) + " generation=" + std::to_string(self.generation) + ">";
+        });
+
+    py::class_<Entity, std::shared_ptr<Entity>>(m, "Entity")
+        .def(py::init(&Entity::Create))
+        .def_property_readonly("handle", &Entity::GetHandle)
+        .def_property("enabled", &Entity::IsEnabled, &Entity::SetEnabled)
+        .def_property_readonly("active", &Entity::IsActive)
+        .def_property("static", &Entity::IsStatic, &Entity::SetStatic)
+        .def_property("name", &Entity::GetName, &Entity::SetName)
+        .def_property("tags", &Entity::GetTags, [](Entity& self, const py::handle& tags) {
+            self.SetTags(ToTagMask(tags));
+        })
+        .def("add_tag", [](Entity& self, const py::handle& tags) { self.AddTags(ToTagMask(tags)); }, py::arg("tags"))
+        .def("remove_tag", [](Entity& self, const py::handle& tags) { self.RemoveTags(ToTagMask(tags)); }, py::arg("tags"))
+        .def("has_tag", [](const Entity& self, const py::handle& tags) { return self.HasTags(ToTagMask(tags)); }, py::arg("tags"))
+        .def_static("tag", &SceneIndex::Tag, py::arg("name"), "Bit of a named tag.")
         .def("add_component", [](Entity& self, const py::object& py_comp) {
-            auto comp = std::make_shared<PythonComponentWrapper>(py_comp);
-            comp->SetOwner(&self);
-            self.AddComponent(comp);
+            // Native components go straight into the registry storages, anything else is scripted
+            self.AddComponent(ToComponent(py_comp));
         })
-        .def("get_component", [](const Entity& self, const py::object& type) -> py::object {
-            for (const auto& comp : self.Components()) {
-                if (auto py_wrapper = dynamic_cast<PythonComponentWrapper*>(comp.get())) {
-                    if (py::isinstance(py_wrapper->PyComponent(), type)) {
-                        return py_wrapper->PyComponent();
-                    }
-                }
+        // Python runs inside the scene updates: removals wait for the next sync point
+        .def("destroy", [](const Entity& self) {
+            Window::GetInstance().GetCommands().Destroy(self.GetHandle());
+        })
+        .def("remove_component", [](const Entity& self, const py::handle& type) {
+            ComponentTypeId type_id;
+            if (Registry::FindPythonType(type.ptr(), type_id)) {
+                Window::GetInstance().GetCommands().RemoveComponent(self.GetHandle(), type_id);
+            }
+        }, py::arg("type"))
+        .def("get_component", [](const Entity& self, const py::handle& type) -> py::object {
+            // Classes never attached to any entity have no id yet, so nothing can match them
+            ComponentTypeId type_id;
+            if (!Registry::FindPythonType(type.ptr(), type_id)) {
+                return py::none();
+            }
+
+            std::shared_ptr<Component> component = Registry::GetSharedComponent(self.GetId(), type_id);
+            if (!component) {
+                return py::none();
+            }
+
+            if (Registry::IsScriptType(type_id)) {
+                return static_cast<PythonComponentWrapper*>(component.get())->PyComponent();
             }
-            return py::none();
+
+            return py::cast(component);
         }, py::return_value_policy::reference)
         .def_property_readonly("transform", [](const Entity& self) -> const Transform& {
             return self.GetTransform();
         });
 
+    py::class_<Prefab>(m, "Prefab")
+        .def(py::init<const Entity&>(), py::arg("root"))
+        .def("__len__", &Prefab::Size);
+
+    py::class_<EntityCommandBuffer::PendingEntity>(m, "PendingEntity")
+        .def_readonly("index", &EntityCommandBuffer::PendingEntity::index);
+
+    using PendingEntity = EntityCommandBuffer::PendingEntity;
+    py::class_<EntityCommandBuffer>(m, "CommandBuffer")
+        .def("create", [](EntityCommandBuffer& self) { return self.Create(); })
+        .def("create", [](EntityCommandBuffer& self, const Entity& parent) { return self.Create(parent.GetHandle()); }, py::arg("parent"))
+        .def("create", [](EntityCommandBuffer& self, EntityHandle parent) { return self.Create(parent); }, py::arg("parent"))
+        .def("create", [](EntityCommandBuffer& self, PendingEntity parent) { return self.Create(parent); }, py::arg("parent"))
+        .def("destroy", [](EntityCommandBuffer& self, const Entity& entity) { self.Destroy(entity.GetHandle()); })
+        .def("destroy", [](EntityCommandBuffer& self, EntityHandle entity) { self.Destroy(entity); })
+        .def("add_component", [](EntityCommandBuffer& self, const Entity& entity, const py::object& component) {
+            self.AddComponent(entity.GetHandle(), ToComponent(component));
+        })
+        .def("add_component", [](EntityCommandBuffer& self, EntityHandle entity, const py::object& component) {
+            self.AddComponent(entity, ToComponent(component));
+        })
+        .def("add_component", [](EntityCommandBuffer& self, PendingEntity entity, const py::object& component) {
+            self.AddComponent(entity, ToComponent(component));
+        })
+        .def("remove_component", [](EntityCommandBuffer& self, EntityHandle entity, const py::handle& type) {
+            // Classes never attached to any entity have no id yet, so nothing can match them
+            ComponentTypeId type_id;
+            if (Registry::FindPythonType(type.ptr(), type_id)) {
+                self.RemoveComponent(entity, type_id);
+            }
+        })
+        .def("remove_component", [](EntityCommandBuffer& self, const Entity& entity, const py::handle& type) {
+            ComponentTypeId type_id;
+            if (Registry::FindPythonType(type.ptr(), type_id)) {
+                self.RemoveComponent(entity.GetHandle(), type_id);
+            }
+        })
+        .def("__len__", &EntityCommandBuffer::Size);
+
         py::class_<Texture, std::shared_ptr<Texture>>(m, "Texture")
             .def(py::init<const std::string&, bool>(), py::arg("path"), py::arg("flip_vertically") = false);
 
@@ -286,23 +768,28 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
             .def(py::init<const std::string&, unsigned int>(), py::arg("font_path"), py::arg("font_size") = 48);
 
         py::class_<RenderComponent, Component, std::shared_ptr<RenderComponent>>(m, "RenderComponent")
-            .def_property("texture", &RenderComponent::GetTexture, &RenderComponent::SetTexture);
+            .def_property("texture", &RenderComponent::GetTexture, &RenderComponent::SetTexture)
+            .def_property("occluder", &RenderComponent::IsOccluder, &RenderComponent::SetOccluder);
 
         py::class_<CuboidMesh, RenderComponent, std::shared_ptr<CuboidMesh>>(m, "CuboidMesh")
-            .def(py::init<>());
+            .def(py::init([]() { return ComponentPool<CuboidMesh>::Create(); }));
 
         py::class_<SphereMesh, RenderComponent, std::shared_ptr<SphereMesh>>(m, "SphereMesh")
-            .def(py::init<unsigned int, unsigned int>(), py::arg("sector_count") = 36, py::arg("stack_count") = 18);
+            .def(py::init([](unsigned int sectorCount, unsigned int stackCount) {
+                return ComponentPool<SphereMesh>::Create(sectorCount, stackCount);
+            }), py::arg("sector_count") = 36, py::arg("stack_count") = 18);
 
         py::class_<CapsuleMesh, RenderComponent, std::shared_ptr<CapsuleMesh>>(m, "CapsuleMesh")
             .def(
-                py::init<float, float, unsigned int, unsigned int, unsigned int>(),
+                py::init([](float radius, float cylinderHeight, unsigned int sectorCount, unsigned int hemisphereStacks, unsigned int cylinderStacks) {
+                    return ComponentPool<CapsuleMesh>::Create(radius, cylinderHeight, sectorCount, hemisphereStacks, cylinderStacks);
+                }),
                 py::arg("radius") = 0.5f, py::arg("cylinder_height") = 1.0f, py::arg("sector_count") = 36,
                 py::arg("hemisphere_stacks") = 18, py::arg("cylinder_stacks") = 10
             );
 
         py::class_<Model, RenderComponent, std::shared_ptr<Model>>(m, "Model")
-            .def(py::init<std::string>(), py::arg("path") = "")
+            .def(py::init([](std::string path) { return ComponentPool<Model>::Create(path); }), py::arg("path") = "")
             .def_property("path", 
                 [](Model& self) -> std::string {
                     return self.path;
@@ -315,7 +802,7 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
         py::class_<GuiComponent, Component, std::shared_ptr<GuiComponent>>(m, "GuiComponent");
 
         py::class_<Text, GuiComponent, std::shared_ptr<Text>>(m, "Text")
-            .def(py::init<>())
+            .def(py::init([]() { return ComponentPool<Text>::Create(); }))
             .def_property("font",
                 [](Text& self) -> std::shared_ptr<Font> { // Getter
                     return self.font; // Retourne directement le shared_ptr
@@ -334,5 +821,15 @@ PYBIND11_EMBEDDED_MODULE(nora, m) {
                 "The color of the text.");
 
         py::class_<Sprite, RenderComponent, std::shared_ptr<Sprite>>(m, "Sprite")
-            .def(py::init<>());
+            .def(py::init([]() { return ComponentPool<Sprite>::Create(); }));
+
+        RegisterComponentType<Camera>();
+        RegisterComponentType<RenderComponent>();
+        RegisterComponentType<CuboidMesh, RenderComponent>();
+        RegisterComponentType<SphereMesh, RenderComponent>();
+        RegisterComponentType<CapsuleMesh, RenderComponent>();
+        RegisterComponentType<Model, RenderComponent>();
+        RegisterComponentType<Sprite, RenderComponent>();
+        RegisterComponentType<GuiComponent>();
+        RegisterComponentType<Text, GuiComponent>();
 }
@@ -2,7 +2,13 @@
 #define PYTHON_COMPONENT_WRAPPER_HPP
 
 #include "World/Component.hpp"
+#include "World/ComponentStorage.hpp"
+#include "World/UpdatePhase.hpp"
+#include "World/UpdateScheduler.hpp"
 #include <pybind11/pybind11.h>
+#include <array>
+#include <memory>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -12,11 +18,60 @@ class PythonComponentWrapper : public Component {
 
         void Start() override;
         void Update() override;
+        void FixedUpdate() override;
+        void LateUpdate() override;
+        void OnDestroy() override;
+
+        // New instance of the same Python class sharing a shallow copy of the attributes
+        std::shared_ptr<Component> Clone() const override;
+
+        // Copy of the Python attributes for a SceneSnapshot: `__getstate__()` when the class defines
+        // `__setstate__`, a shallow copy of `__dict__` otherwise
+        py::object GetPythonState() const;
+        void SetPythonState(const py::object& state);
+
+        // Phases implemented by the Python class or by the native component it derives from
+        PhaseMask Phases() const;
 
         py::object PyComponent() const;
 
+        // Registry type ids of the Python class and of every class it derives from
+        const std::vector<ComponentTypeId>& TypeIds() const;
+
+        // Underlying C++ object when the Python class derives from a native component
+        const std::shared_ptr<Component>& NativeComponent() const;
+
+        // Priority and delta time live on the Python object, when it derives from nora.Component
+        UpdatePriority GetUpdatePriority() const;
+        void SetDeltaTime(float deltaTime);
+
+        ScheduleState& Schedule() {
+            return schedule_;
+        }
+
+        // Position in Registry::Scripts(phase), maintained by the Registry
+        std::uint32_t PhaseSlot(UpdatePhase phase) const {
+            return phase_slots_[static_cast<std::size_t>(phase)];
+        }
+
+        void SetPhaseSlot(UpdatePhase phase, std::uint32_t slot) {
+            phase_slots_[static_cast<std::size_t>(phase)] = slot;
+        }
+
     private:
+        static const std::vector<ComponentTypeId>& ResolveTypeIds(const py::handle& type);
+        static PhaseMask ResolvePythonPhases(const py::handle& type);
+
+        // Calls the Python method when the class defines it, the native one otherwise
+        void Dispatch(UpdatePhase phase, const char* name);
+
         py::object py_component_;
+        const std::vector<ComponentTypeId>* type_ids_;
+        std::shared_ptr<Component> native_component_;
+        PhaseMask python_phases_ = 0;
+        PhaseMask native_phases_ = 0;
+        ScheduleState schedule_;
+        std::array<std::uint32_t, UPDATE_PHASE_COUNT> phase_slots_ {};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "Graphics/Shader.hpp"
+#include "Graphics/Texture.hpp"
 
 class AssetsManager {
     public:
@@ -12,8 +13,12 @@ class AssetsManager {
 
         static Shader* GetShader(const std::string& name);
 
+        // Loaded once per path, later calls share it
+        static std::shared_ptr<Texture> LoadTexture(const std::string& path, bool hasAlpha = false);
+
     private:
         static std::map<std::string, std::unique_ptr<Shader>> m_shaders;
+        static std::map<std::string, std::shared_ptr<Texture>> m_textures;
 };
 
 #endif
\ No newline at end of file
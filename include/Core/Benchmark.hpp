@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <cstddef>
+
+// Headless micro-benchmarks, run with `NoraEngine --benchmark`
+class Benchmark {
+    public:
+        static int RunAll();
+
+        // World matrices per second: legacy Euler path against ComputeModelMatrix with cached quaternions
+        static void TransformPropagation(std::size_t entityCount);
+
+        // Entities destroyed and respawned per second in a scene of `liveCount`, and whether the pools grew
+        static void SpawnDestroy(std::size_t liveCount);
+
+        // Render extraction in a scene where `movingPercent` of the entities move: changed entities
+        // read through the Registry change log against copying every render matrix
+        static void ChangeTracking(std::size_t entityCount, float movingPercent);
+
+        // Scene::Snapshot (full, then sharing the chunks of the previous one) and Scene::Restore times
+        static void SnapshotRestore(std::size_t entityCount);
+
+        // Scene::Load of a saved scene against reading the file and against building it entity by entity
+        static void SceneFileLoad(std::size_t entityCount);
+
+        // Scene BVH: build, box and k-nearest queries against a linear scan of the same boxes, and
+        // the sync after 1% of the entities moved
+        static void BvhQueries(std::size_t entityCount);
+
+        // Scene::GetBvh called every `framesBetween` frames while 1% of the entities move each frame, the
+        // way gameplay queries it: sync time against a full build, and how many syncs had to rebuild
+        static void BvhSync(std::size_t entityCount, int framesBetween);
+
+        // FrustumCuller (cached bounds, batched sphere/box tests) against transforming and testing
+        // every mesh's box each frame
+        static void FrustumCulling(std::size_t entityCount);
+
+        // OcclusionCuller behind the frustum culler in a street of walls: rasterization and test times,
+        // meshes left to draw with and without it
+        static void OcclusionCulling(std::size_t entityCount);
+
+        // PotentiallyVisibleSet of a grid of closed rooms joined by doors: bake time and size, then the
+        // frustum culler from inside a room with and without it
+        static void PvsCulling(int roomsPerSide, std::size_t propsPerRoom);
+
+        // RenderQueue push and radix sort of a frame's packets against std::sort, and the texture and
+        // vertex array changes left in scene order and in sorted order
+        static void RenderQueueSort(std::size_t packetCount);
+};
+
+#endif
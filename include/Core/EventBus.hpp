@@ -0,0 +1,203 @@
+#ifndef EVENT_BUS_HPP
+#define EVENT_BUS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using SubscriptionId = std::uint32_t;
+
+// Type-erased side of a channel, what EventBus::Dispatch walks
+class EventChannelBase {
+    public:
+        virtual ~EventChannelBase() = default;
+
+        virtual void Flush() = 0;
+        virtual bool Unsubscribe(SubscriptionId id) = 0;
+        virtual void Clear() = 0;
+};
+
+// Events of one type, kept in a ring buffer allocated by the first subscription (a type nobody
+// listens to stores nothing). Publishing copies the event into the
+// next slot (a full buffer drops it and counts it), Flush hands the pending ones to every
+// subscriber as at most two contiguous batches. Events published during a flush wait for the next.
+// Callbacks may subscribe and unsubscribe (themselves included) while being called: the flush walks
+// a copy of the list, new subscribers get the next batches and removed ones aren't called again.
+template<typename T>
+class EventChannel : public EventChannelBase {
+    public:
+        using Callback = std::function<void(const T* events, std::size_t count)>;
+
+        static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+        // Drops the pending events, meant to be called at setup
+        void SetCapacity(std::size_t capacity) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = std::max<std::size_t>(capacity, 1);
+            if (!m_buffer.empty()) {
+                m_buffer.assign(m_capacity, T{});
+            }
+            m_head = 0;
+            m_count = 0;
+        }
+
+        std::size_t Capacity() const {
+            return m_capacity;
+        }
+
+        bool HasSubscribers() const {
+            return m_hasSubscribers;
+        }
+
+        void Publish(const T& event) {
+            // Nobody listens: nothing is stored
+            if (!m_hasSubscribers.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_count == m_buffer.size()) {
+                ++m_dropped;
+                return;
+            }
+
+            m_buffer[(m_head + m_count) % m_buffer.size()] = event;
+            ++m_count;
+        }
+
+        SubscriptionId Subscribe(SubscriptionId id, Callback callback) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_buffer.empty()) {
+                    m_buffer.assign(m_capacity, T{});
+                }
+            }
+
+            m_subscribers.push_back(std::make_shared<Subscriber>(Subscriber { id, std::move(callback) }));
+            m_hasSubscribers = true;
+            return id;
+        }
+
+        bool Unsubscribe(SubscriptionId id) override {
+            auto it = std::find_if(m_subscribers.begin(), m_subscribers.end(), [id](const auto& subscriber) {
+                return subscriber->id == id;
+            });
+            if (it == m_subscribers.end()) {
+                return false;
+            }
+
+            // A flush holding it keeps the callback alive, possibly the one running now
+            (*it)->active = false;
+            m_subscribers.erase(it);
+            m_hasSubscribers = !m_subscribers.empty();
+            return true;
+        }
+
+        void Flush() override {
+            std::size_t head, count;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                head = m_head;
+                count = m_count;
+            }
+            if (count == 0) {
+                return;
+            }
+
+            const std::size_t first = std::min(count, m_buffer.size() - head);
+            const std::vector<std::shared_ptr<Subscriber>> subscribers = m_subscribers;
+            for (const auto& subscriber : subscribers) {
+                if (subscriber->active) {
+                    subscriber->callback(&m_buffer[head], first);
+                }
+                if (subscriber->active && first < count) {
+                    subscriber->callback(&m_buffer[0], count - first);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_head = (m_head + count) % m_buffer.size();
+            m_count -= count;
+        }
+
+        void Clear() override {
+            for (const auto& subscriber : m_subscribers) {
+                subscriber->active = false;
+            }
+            m_subscribers.clear();
+            m_hasSubscribers = false;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_head = 0;
+            m_count = 0;
+        }
+
+        // Events lost because the buffer was full
+        std::uint64_t Dropped() const {
+            return m_dropped;
+        }
+
+    private:
+        std::vector<T> m_buffer;
+        std::size_t m_capacity = DEFAULT_CAPACITY;
+        std::size_t m_head = 0;
+        std::size_t m_count = 0;
+        std::uint64_t m_dropped = 0;
+        std::mutex m_mutex;
+
+        struct Subscriber {
+            SubscriptionId id;
+            Callback callback;
+            bool active = true;
+        };
+
+        std::vector<std::shared_ptr<Subscriber>> m_subscribers;
+        std::atomic<bool> m_hasSubscribers { false };
+};
+
+// Engine-wide typed event bus (see Core/Events.hpp for the engine events).
+// Publish is safe from any thread and never allocates; Subscribe, Unsubscribe and Dispatch are
+// main thread only. Window::Run calls Dispatch once per frame, after the command buffer playback,
+// so every subscriber gets the events of the previous frame in one batch per type.
+class EventBus {
+    public:
+        template<typename T>
+        static void Publish(const T& event) {
+            Channel<T>().Publish(event);
+        }
+
+        template<typename T>
+        static SubscriptionId Subscribe(typename EventChannel<T>::Callback callback) {
+            EventChannel<T>& channel = Channel<T>();
+            Register(channel);
+            return channel.Subscribe(++s_nextSubscription, std::move(callback));
+        }
+
+        static void Unsubscribe(SubscriptionId id);
+
+        // Delivers the pending events of every channel with subscribers
+        static void Dispatch();
+
+        // Drops every subscriber (e.g. before the Python interpreter goes away)
+        static void Clear();
+
+        template<typename T>
+        static EventChannel<T>& Channel() {
+            static EventChannel<T> channel;
+            return channel;
+        }
+
+    private:
+        static void Register(EventChannelBase& channel);
+
+        inline static std::vector<EventChannelBase*> s_channels;
+        inline static SubscriptionId s_nextSubscription = 0;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include <GLFW/glfw3.h>
+#include "Core/Key.hpp"
+#include "World/EntityHandle.hpp"
+
+// Events published by the engine on the EventBus
+
+struct WindowResizeEvent {
+    int width = 0;
+    int height = 0;
+};
+
+// Published once a second, when Time::FPS() is refreshed
+struct FrameRateEvent {
+    float fps = 0.0f;
+};
+
+struct KeyEvent {
+    Key key = Key::Unknown;
+    bool pressed = false;
+    bool repeat = false;
+};
+
+struct MouseButtonEvent {
+    MouseCode button = MouseCode::Left;
+    bool pressed = false;
+};
+
+// An entity joined a scene (created, attached as a child or moved in by a scene change)
+struct EntitySpawnedEvent {
+    EntityHandle entity;
+};
+
+// For collision systems to publish, the engine itself has none yet
+struct CollisionEvent {
+    EntityHandle first;
+    EntityHandle second;
+};
+
+#endif
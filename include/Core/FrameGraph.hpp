@@ -0,0 +1,101 @@
+#ifndef FRAME_GRAPH_HPP
+#define FRAME_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using FrameNodeId = std::uint32_t;
+
+// Where a node may run
+enum class FrameAffinity : std::uint8_t {
+    MainThread, // GL, GLFW and Python calls
+    Worker // any thread of the JobSystem
+};
+
+// The work of one frame as nodes that declare the resources (plain names) they read and write.
+// Dependencies follow declaration order: a node waits for the last earlier writer of what it
+// reads or writes, and a writer also waits for the earlier readers. Nodes are grouped in levels,
+// the nodes of a level have no dependency between them, the worker ones run on the JobSystem while
+// the main thread runs the others in declaration order.
+// Every node is timed, which gives the critical path of the frame (the chain of dependent nodes
+// that took the longest).
+class FrameGraph {
+    public:
+        static constexpr FrameNodeId INVALID_NODE = 0xFFFFFFFFu;
+
+        FrameNodeId AddNode(const std::string& name, std::function<void()> function,
+                            const std::vector<std::string>& reads, const std::vector<std::string>& writes,
+                            FrameAffinity affinity = FrameAffinity::MainThread);
+
+        // INVALID_NODE when there is no node with that name
+        FrameNodeId Find(const std::string& name) const;
+
+        // Adds an ordering the resources don't express, `node` runs after `dependency`
+        void AddDependency(FrameNodeId node, FrameNodeId dependency);
+
+        void Clear();
+
+        // Runs every node once
+        void Run();
+
+        std::size_t Size() const {
+            return m_nodes.size();
+        }
+
+        const std::string& Name(FrameNodeId node) const;
+        const std::vector<FrameNodeId>& Dependencies(FrameNodeId node);
+
+        // Timings of the last Run, in milliseconds
+        float NodeTime(FrameNodeId node) const;
+        float FrameTime() const {
+            return m_frameTime;
+        }
+
+        float CriticalPathTime() const {
+            return m_criticalPathTime;
+        }
+
+        // From the first node of the chain to the last
+        const std::vector<FrameNodeId>& CriticalPath() const {
+            return m_criticalPath;
+        }
+
+    private:
+        struct Node {
+            std::string name;
+            std::function<void()> function;
+            std::vector<std::uint32_t> reads;
+            std::vector<std::uint32_t> writes;
+            FrameAffinity affinity = FrameAffinity::MainThread;
+
+            // Set by AddDependency, kept when the graph is rebuilt
+            std::vector<FrameNodeId> explicitDependencies;
+
+            std::vector<FrameNodeId> dependencies;
+            std::uint32_t level = 0;
+
+            float time = 0.0f;
+        };
+
+        std::uint32_t Resource(const std::string& name);
+        void Build();
+        void ComputeCriticalPath();
+
+        std::vector<Node> m_nodes;
+        std::unordered_map<std::string, std::uint32_t> m_resources;
+
+        // Per level, the worker nodes and the main thread ones
+        std::vector<std::vector<FrameNodeId>> m_workerLevels;
+        std::vector<std::vector<FrameNodeId>> m_mainLevels;
+        bool m_dirty = true;
+
+        float m_frameTime = 0.0f;
+        float m_criticalPathTime = 0.0f;
+        std::vector<FrameNodeId> m_criticalPath;
+};
+
+#endif
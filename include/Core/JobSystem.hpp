@@ -0,0 +1,106 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Engine-wide work-stealing job system.
+// Each worker owns a deque: it pops its own jobs from the back while idle workers steal
+// from the front of the others. The thread that called Initialize (the main thread, which
+// also holds the GIL) gets a deque too and works on its own ParallelFor while waiting.
+// Jobs must not touch Python.
+class JobSystem {
+    private:
+        struct Task {
+            const std::function<void(std::size_t, std::size_t)>* function = nullptr;
+            std::atomic<std::size_t> remaining { 0 };
+            std::mutex errorMutex;
+            std::exception_ptr error;
+        };
+
+    public:
+        // Jobs queued by Start, finished by Wait. Stays in place until Wait returns.
+        class Group {
+            public:
+                Group() = default;
+                Group(const Group&) = delete;
+                Group& operator=(const Group&) = delete;
+
+            private:
+                friend class JobSystem;
+                Task task;
+        };
+
+        struct Stats {
+            std::uint64_t jobs = 0;
+            std::uint64_t steals = 0;
+            std::uint64_t stealAttempts = 0;
+            double idleSeconds = 0.0; // summed over the workers
+
+            double StealRate() const {
+                return jobs ? static_cast<double>(steals) / static_cast<double>(jobs) : 0.0;
+            }
+        };
+
+        // 0 workers means one per hardware thread, minus the main thread
+        static void Initialize(unsigned workerCount = 0);
+        static void Shutdown();
+
+        static unsigned WorkerCount();
+
+        // Calls function(begin, end) on chunks of at most `grain` indices covering [0, count)
+        // and returns once all of them ran. Runs inline when there are no workers, when
+        // everything fits in one chunk, or when called from a thread the system doesn't know.
+        // The first exception thrown by a chunk is rethrown here.
+        static void ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function);
+
+        // ParallelFor split in two, so the caller can do its own work in between: Start queues the
+        // chunks (or runs them right away in the cases ParallelFor runs inline) and returns, Wait helps
+        // until they are done. `function` has to outlive the Wait.
+        static void Start(Group& group, std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function);
+        static void Wait(Group& group);
+
+        static Stats GetStats();
+        static void ResetStats();
+
+    private:
+        struct Job {
+            Task* task = nullptr;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        static void WorkerLoop(unsigned index);
+        static bool PopOrSteal(unsigned index, Job& job);
+        static void Execute(const Job& job);
+
+        inline static std::vector<std::thread> s_workers;
+        inline static std::vector<std::unique_ptr<Queue>> s_queues; // workers first, the main thread last
+        inline static thread_local int t_queueIndex = -1;
+
+        inline static std::mutex s_wakeMutex;
+        inline static std::condition_variable s_wake;
+        inline static std::atomic<std::size_t> s_pending { 0 };
+        inline static std::atomic<bool> s_running { false };
+
+        inline static std::atomic<std::uint64_t> s_jobs { 0 };
+        inline static std::atomic<std::uint64_t> s_steals { 0 };
+        inline static std::atomic<std::uint64_t> s_stealAttempts { 0 };
+        inline static std::atomic<std::uint64_t> s_idleNanoseconds { 0 };
+};
+
+#endif
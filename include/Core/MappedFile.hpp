@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file, unmapped when destroyed. Pages are read in
+// by the OS as they are touched, nothing is copied. Throws when the file can't be mapped.
+class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* Data() const {
+            return m_data;
+        }
+
+        std::size_t Size() const {
+            return m_size;
+        }
+
+    private:
+        const unsigned char* m_data = nullptr;
+        std::size_t m_size = 0;
+
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+};
+
+#endif
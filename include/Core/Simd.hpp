@@ -0,0 +1,13 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+// SSE is part of every x86-64 target (and of MSVC's /arch:AVX2 build), other
+// architectures fall back to the scalar code paths.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NORA_SIMD_SSE 1
+    #include <emmintrin.h>
+#else
+    #define NORA_SIMD_SSE 0
+#endif
+
+#endif
@@ -8,12 +8,29 @@ class Time {
         static float DeltaTime();
         static float FPS();
 
+        // Fixed-step simulation
+        static void SetFixedDeltaTime(float fixedDeltaTime);
+        static float FixedDeltaTime();
+        static void SetMaxFixedSteps(int maxFixedSteps);
+        static int MaxFixedSteps();
+
+        // Adds this frame's delta time to the accumulator and returns how many fixed steps to run,
+        // at most MaxFixedSteps() (the extra time is dropped so a slow frame can't snowball)
+        static int ConsumeFixedSteps();
+
+        // Fraction of a fixed step left in the accumulator, used to interpolate rendering
+        static float InterpolationAlpha();
+
     private:
         static double lastTime;
         static double fpsLastTime;
         static float fps;
         static float deltaTime;
         static int frameCount;
+
+        static float fixedDeltaTime;
+        static int maxFixedSteps;
+        static float accumulator;
 };
 
 #endif
\ No newline at end of file
@@ -13,8 +13,14 @@
 #include "Graphics/Color.hpp"
 #include "Graphics/Shader.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/TransformBuffer.hpp"
+#include "Graphics/FrustumCuller.hpp"
+#include "Graphics/OcclusionCuller.hpp"
+#include "Graphics/RenderQueue.hpp"
 #include "Core/Input.hpp"
+#include "Core/FrameGraph.hpp"
 #include "World/Scene.hpp"
+#include "World/EntityCommandBuffer.hpp"
 
 namespace py = pybind11;
 
@@ -37,6 +43,21 @@ class Window {
         Scene& GetScene();
         void SetScene(const Scene& scene);
 
+        // Structural changes recorded during a frame, applied at the start of the next one
+        EntityCommandBuffer& GetCommands();
+
+        // What runs each frame, systems can add their own nodes
+        FrameGraph& GetFrameGraph();
+
+        // Meshes tested against the camera frustum, drawn and skipped last frame
+        const FrustumCuller::Stats& GetCullStats() const;
+
+        // Occluders drawn and meshes found hidden behind them last frame
+        const OcclusionCuller::Stats& GetOcclusionStats() const;
+
+        // Draws issued last frame, and the binds the render queue's order saved
+        const RenderQueue::Stats& GetRenderStats() const;
+
         FT_Library FT();
 
         Color BackgroundColor;
@@ -54,9 +75,17 @@ class Window {
         void Update();
         void Render();
         void Shutdown();
+        void BuildFrameGraph();
 
         FT_Library m_ft;
         Scene m_scene;
+        EntityCommandBuffer m_commands;
+        FrameGraph m_frameGraph;
+        TransformBuffer m_transforms;
+        FrustumCuller m_culler;
+        OcclusionCuller m_occlusion;
+        std::vector<Entity*> m_visible; // meshes drawn this frame
+        RenderQueue m_queue;
 
         void OnResize(int width, int height);
         static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
@@ -0,0 +1,63 @@
+#ifndef FRUSTUM_CULLER_HPP
+#define FRUSTUM_CULLER_HPP
+
+#include "World/Bounds.hpp"
+#include "World/Registry.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class SceneQuery; // Forward declaration
+class PotentiallyVisibleSet; // Forward declaration
+
+// Picks the render components to draw. The world bounds of each mesh (RenderComponent::LocalBounds
+// through its render matrix) are cached by entity id and only recomputed for the entities the
+// Registry logged as changed. Each frame the active candidates are packed into flat arrays and
+// tested four at a time: their bounding spheres first, which settle most of them, then the boxes
+// of those a sphere leaves straddling a plane.
+class FrustumCuller {
+    public:
+        struct Stats {
+            std::size_t tested = 0;
+            std::size_t visible = 0;
+            std::size_t culled = 0;
+            std::size_t hidden = 0; // left out by the PVS, not tested
+        };
+
+        // Appends the active entities of `candidates` (owning a RenderComponent) that may be
+        // inside the frustum to `visible`, in the order of `candidates`. With a PVS (its viewpoint
+        // set), the meshes it hides are left out before testing.
+        void Cull(const SceneQuery& candidates, const Frustum& frustum, std::vector<Entity*>& visible,
+            const PotentiallyVisibleSet* pvs = nullptr);
+
+        // Counts of the last Cull
+        const Stats& GetStats() const {
+            return m_stats;
+        }
+
+    private:
+        // Bounds of an entity in world space, the sphere being the one around the box
+        struct WorldBounds {
+            glm::vec3 center;
+            float radius;
+            glm::vec3 extents;
+        };
+
+        void UpdateBounds(const SceneQuery& candidates);
+        void ComputeBounds(const Entity& entity);
+        void Test(const Frustum& frustum, std::vector<Entity*>& visible);
+
+        std::vector<WorldBounds> m_bounds; // by entity id
+        std::vector<EntityId> m_changed;
+        ChangeCursor m_changes;
+
+        // Candidates of the frame, structure of arrays padded to a multiple of 4
+        std::vector<Entity*> m_entities;
+        std::vector<float> m_centerX, m_centerY, m_centerZ;
+        std::vector<float> m_extentX, m_extentY, m_extentZ;
+        std::vector<float> m_radius;
+
+        Stats m_stats;
+};
+
+#endif
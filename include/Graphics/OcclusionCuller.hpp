@@ -0,0 +1,79 @@
+#ifndef OCCLUSION_CULLER_HPP
+#define OCCLUSION_CULLER_HPP
+
+#include "World/Bounds.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Entity; // Forward declaration
+class RenderComponent; // Forward declaration
+
+// Software occlusion culling, entirely on the CPU. The occluders (RenderComponent::IsOccluder) covering
+// enough of the screen are rasterized into a small depth buffer, largest first and up to a triangle
+// budget; then the box of every other mesh is projected and compared with the depth under it: if each
+// pixel there holds something nearer than the box's nearest point, the mesh is hidden.
+// Triangles go through a half-space rasterizer working on 4 pixels at a time. Occluder triangles
+// crossing the near plane are dropped and boxes crossing it are always visible, so mistakes only
+// ever keep a mesh that could have been culled.
+class OcclusionCuller {
+    public:
+        static constexpr int WIDTH = 256;
+        static constexpr int HEIGHT = 128;
+
+        // Occluders whose box covers less of the screen than this (fraction of its area) are skipped
+        static constexpr float MIN_OCCLUDER_AREA = 1.0f / 64.0f;
+        static constexpr std::size_t TRIANGLE_BUDGET = 16384;
+
+        struct Stats {
+            std::size_t occluders = 0;
+            std::size_t triangles = 0;
+            std::size_t tested = 0;
+            std::size_t occluded = 0;
+        };
+
+        // Clears the depth buffer for a new view
+        void Begin(const glm::mat4& viewProjection);
+
+        // Draws triangles (three vertices each) placed by the model matrix; returns how many were drawn
+        std::size_t RenderTriangles(const std::vector<glm::vec3>& triangles, const glm::mat4& model);
+
+        // False when the world-space box is hidden behind what was drawn since Begin
+        bool IsVisible(const Aabb& box) const;
+
+        // A whole frame: picks and draws the occluders among `visible` (the output of frustum
+        // culling), then removes the meshes they hide from it. Occluders themselves stay.
+        void Cull(const glm::mat4& viewProjection, std::vector<Entity*>& visible);
+
+        // Counts of the last Cull
+        const Stats& GetStats() const {
+            return m_stats;
+        }
+
+        // Depth (0 near, 1 far) of each pixel, rows bottom to top
+        const std::vector<float>& GetDepth() const {
+            return m_depth;
+        }
+
+    private:
+        struct Occluder {
+            std::size_t index; // in the visible list
+            float area;
+        };
+
+        // Screen rectangle (pixels, inclusive, empty off screen) and nearest depth of a box, false
+        // when it crosses the near plane
+        bool Project(const Aabb& box, int& minX, int& minY, int& maxX, int& maxY, float& depth) const;
+        void RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+        glm::mat4 m_viewProjection = glm::mat4(1.0f);
+        std::vector<float> m_depth = std::vector<float>(WIDTH * HEIGHT, 1.0f);
+        std::vector<Occluder> m_occluders;
+        // By index in the visible list
+        std::vector<const RenderComponent*> m_meshes;
+        std::vector<char> m_drawn;
+        Stats m_stats;
+};
+
+#endif
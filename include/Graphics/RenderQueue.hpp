@@ -0,0 +1,111 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+class Mesh; // Forward declaration
+class RenderComponent; // Forward declaration
+class Shader; // Forward declaration
+
+// Draws of a frame, queued by the render components (RenderComponent::Enqueue) then sorted and
+// submitted at once. Each packet gets a 64-bit key:
+//   opaque:      pass (2) | shader (8) | texture (16) | vertex array (16) | depth, near first (22)
+//   transparent: pass (2) | depth, far first (22) | shader (8) | texture (16) | vertex array (16)
+// so opaque draws sharing a program, texture and vertex array follow each other, and transparent ones
+// come last from back to front. Keys are sorted with an LSD radix sort (8 bits per pass, the passes
+// where every key has the same byte skipped), then Submit only binds what differs from the previous
+// draw. Texture and vertex array names are truncated in the key: a collision costs a bind, not a
+// wrong draw, since the state itself is compared.
+class RenderQueue {
+    public:
+        enum class Pass : std::uint8_t {
+            Opaque,
+            Transparent
+        };
+
+        struct Packet {
+            Shader* shader = nullptr;
+            unsigned int texture = 0; // on unit 0, 0 for none
+            // Meshes of a Model bind their own textures, over several units
+            const Mesh* material = nullptr;
+            unsigned int vertexArray = 0;
+            GLenum primitive = GL_TRIANGLES;
+            GLsizei count = 0;
+            bool indexed = false; // unsigned int indices in the vertex array's element buffer
+            int instance = 0; // the entity id, picks the render matrix (see TransformBuffer)
+            // Drawn by calling its Render instead, for the components that queue nothing of their own
+            RenderComponent* immediate = nullptr;
+        };
+
+        // Per frame, the binds counted against one of each per draw
+        struct Stats {
+            std::size_t draws = 0;
+            std::size_t programBinds = 0;
+            std::size_t textureBinds = 0;
+            std::size_t vertexArrayBinds = 0;
+            std::size_t programBindsSkipped = 0;
+            std::size_t textureBindsSkipped = 0;
+            std::size_t vertexArrayBindsSkipped = 0;
+        };
+
+        // Starts a frame: drops the previous packets. Depths are distances along the view direction,
+        // `farPlane` mapping to the largest.
+        void Begin(const glm::mat4& view, const glm::mat4& projection, float farPlane);
+
+        // Queues a draw of something at `position` (world space)
+        void Push(Pass pass, const Packet& packet, const glm::vec3& position);
+
+        void Sort();
+
+        // Issues the sorted draws, leaving no vertex array and no texture on unit 0 bound
+        void Submit();
+
+        std::size_t Size() const {
+            return m_packets.size();
+        }
+
+        // After Sort, the packets in the order Submit draws them
+        const Packet& Sorted(std::size_t i) const {
+            return m_packets[m_entries[i].index];
+        }
+
+        // Counts of the last Submit
+        const Stats& GetStats() const {
+            return m_stats;
+        }
+
+    private:
+        static constexpr int DEPTH_BITS = 22;
+
+        struct Entry {
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+
+        struct Program {
+            const Shader* shader;
+            int instanceLocation;
+        };
+
+        // Small id of the shader, its uniform looked up the first time it is seen
+        std::uint32_t ProgramSlot(const Shader* shader);
+
+        glm::vec4 m_depthRow = glm::vec4(0.0f); // -view row 2: position -> distance along the view
+        glm::mat4 m_view = glm::mat4(1.0f);
+        glm::mat4 m_projection = glm::mat4(1.0f);
+        float m_depthScale = 0.0f;
+
+        std::vector<Program> m_programs; // kept from frame to frame
+        std::vector<Packet> m_packets;
+        std::vector<std::uint32_t> m_slots; // of each packet's shader
+        std::vector<Entry> m_entries;
+        std::vector<Entry> m_scratch;
+
+        Stats m_stats;
+};
+
+#endif
@@ -11,10 +11,25 @@ class Sprite : public RenderComponent {
         Sprite();
         ~Sprite();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
+        void Enqueue(RenderQueue& queue, Shader& shader) override;
         std::string ShaderType() override;
 
+        // Flat in the xy plane
+        Aabb LocalBounds() const override {
+            return Aabb(glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f));
+        }
+
+        const std::vector<glm::vec3>& OccluderTriangles() const override {
+            static const std::vector<glm::vec3> triangles = {
+                { -0.5f, -0.5f, 0.0f }, { 0.5f, -0.5f, 0.0f }, { 0.5f, 0.5f, 0.0f },
+                { 0.5f, 0.5f, 0.0f }, { -0.5f, 0.5f, 0.0f }, { -0.5f, -0.5f, 0.0f }
+            };
+            return triangles;
+        }
+
     private:
         void SetupMesh();
         unsigned int m_VAO = 0;
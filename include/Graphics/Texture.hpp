@@ -12,12 +12,14 @@ class Texture {
         Texture(const std::string& path, bool hasAlpha = false, std::string type = "");
         void Bind(unsigned int unit = 0) const;
         void Unbind(unsigned int unit = 0) const;
-        std::string Path();
-        std::string Type();
+        std::string Path() const;
+        std::string Type() const;
+        bool HasAlpha() const;
 
     private:
         std::string m_path;
         std::string m_type;
+        bool m_hasAlpha;
 };
 
 #endif
\ No newline at end of file
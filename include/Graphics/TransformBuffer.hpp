@@ -0,0 +1,50 @@
+#ifndef TRANSFORM_BUFFER_HPP
+#define TRANSFORM_BUFFER_HPP
+
+#include "World/Registry.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Render matrices of every entity, indexed by entity id, in a texture buffer that stays on the GPU
+// (4 RGBA32F texels per matrix, read with texelFetch by the mesh shaders). Each frame only the entities
+// the Registry logged as changed are copied, and uploaded in runs of neighbouring ids: in a mostly
+// static scene the cost follows what moved, not the size of the scene.
+class TransformBuffer {
+    public:
+        // Texture unit the buffer is bound to, above the ones the materials use
+        static constexpr unsigned int TEXTURE_UNIT = 15;
+
+        // Ids closer than this are uploaded together rather than in two calls
+        static constexpr std::size_t MERGE_GAP = 8;
+
+        // Main thread, with the GL context current
+        void Update();
+        void Bind() const;
+
+        // GL objects are freed here, before the context goes away
+        void Release();
+
+        // Matrices uploaded by the last Update
+        std::size_t Uploaded() const {
+            return m_uploaded;
+        }
+
+    private:
+        void Reallocate(std::size_t capacity);
+        void Upload(std::size_t begin, std::size_t end);
+
+        GLuint m_buffer = 0;
+        GLuint m_texture = 0;
+        std::size_t m_capacity = 0;
+
+        // CPU copy, the source of the uploads
+        std::vector<glm::mat4> m_matrices;
+        std::vector<EntityId> m_changed;
+        ChangeCursor m_changes;
+        std::size_t m_uploaded = 0;
+};
+
+#endif
@@ -15,6 +15,7 @@ class Text: public GuiComponent {
         Text();
         ~Text();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader) override;
 
@@ -0,0 +1,122 @@
+#ifndef BOUNDING_VOLUME_HIERARCHY_HPP
+#define BOUNDING_VOLUME_HIERARCHY_HPP
+
+#include "World/Bounds.hpp"
+#include "World/ComponentStorage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Entity; // Forward declaration
+
+// Dynamic AABB tree over the world bounds of entities, see Scene::GetBvh.
+// Leaves keep a box slightly larger than the entity (MARGIN), so small moves change nothing; bigger
+// ones enlarge the leaf and queue its ancestors for Refit. Insertion walks down to the sibling that
+// grows the tree's surface area the least. The tree is rebuilt top-down (binned SAH) once refits
+// and insertions have made it noticeably worse than after its last build.
+// Queries test the nodes' boxes and the entities' exact ones, and take every leaf of a subtree
+// lying entirely inside the query volume without testing it further.
+class BoundingVolumeHierarchy {
+    public:
+        static constexpr float MARGIN = 0.1f;
+
+        // Sets (or moves) the bounds of an entity
+        void Set(Entity* entity, const Aabb& bounds);
+        void Remove(EntityId entity);
+
+        bool Contains(EntityId entity) const {
+            return entity < m_leaves.size() && m_leaves[entity] != NULL_NODE;
+        }
+
+        // Exact bounds last set for the entity, empty when it is not in the tree
+        Aabb GetBounds(EntityId entity) const;
+
+        // Replaces the whole tree, built top-down
+        void Build(const std::vector<std::pair<Entity*, Aabb>>& entities);
+
+        // Fits the ancestors of the leaves enlarged since the last call, then rebuilds the tree
+        // if it degraded too much
+        void Refit();
+        void Rebuild();
+        void Clear();
+
+        void Query(const Aabb& box, std::vector<Entity*>& out) const;
+        void Query(const Frustum& frustum, std::vector<Entity*>& out) const;
+        void QuerySphere(const glm::vec3& center, float radius, std::vector<Entity*>& out) const;
+
+        // Up to k entities closest to the point (distance to their box), closest first
+        void Nearest(const glm::vec3& point, std::size_t k, std::vector<Entity*>& out,
+            float maxDistance = std::numeric_limits<float>::max()) const;
+
+        std::size_t Size() const {
+            return m_leafCount;
+        }
+
+        // Longest path from the root to a leaf, in nodes
+        std::size_t Depth() const;
+
+        // Summed area of the internal nodes over the root's: what a query pays on average
+        float Cost() const;
+
+        // Trees built top-down (Build, Rebuild) and Refit calls since the tree was created
+        struct Stats {
+            std::size_t builds = 0;
+            std::size_t refits = 0;
+        };
+
+        const Stats& GetStats() const {
+            return m_stats;
+        }
+
+    private:
+        static constexpr std::int32_t NULL_NODE = -1;
+
+        // Rebuilt past this times the cost of the last build
+        static constexpr float REBUILD_RATIO = 1.5f;
+        static constexpr std::size_t SAH_BINS = 16;
+
+        struct Node {
+            Aabb box;
+            std::int32_t parent = NULL_NODE; // next free node when unused
+            std::int32_t left = NULL_NODE;
+            std::int32_t right = NULL_NODE;
+            Entity* entity = nullptr;
+
+            bool IsLeaf() const {
+                return left == NULL_NODE;
+            }
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<Aabb> m_bounds; // exact bounds of the leaves, by node
+        std::vector<std::int32_t> m_leaves; // entity id -> leaf node
+        std::vector<std::int32_t> m_enlarged; // leaves enlarged since the last Refit
+        std::int32_t m_root = NULL_NODE;
+        std::int32_t m_free = NULL_NODE;
+        std::size_t m_leafCount = 0;
+
+        // Summed area of the internal nodes, kept up to date by SetBox
+        double m_internalArea = 0.0;
+        float m_builtCost = 0.0f;
+
+        Stats m_stats;
+
+        std::int32_t AllocateNode();
+        void FreeNode(std::int32_t node);
+        void SetBox(std::int32_t node, const Aabb& box);
+
+        void InsertLeaf(std::int32_t leaf);
+        void RemoveLeaf(std::int32_t leaf);
+
+        // Fits the ancestors of `node`, stopping where nothing changes
+        void FitUpwards(std::int32_t node);
+
+        // Links the leaves in a new tree, returns its root
+        std::int32_t BuildTopDown(std::vector<std::int32_t>& leaves);
+
+        void CollectLeaves(std::int32_t node, std::vector<Entity*>& out) const;
+};
+
+#endif
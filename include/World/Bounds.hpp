@@ -0,0 +1,144 @@
+#ifndef BOUNDS_HPP
+#define BOUNDS_HPP
+
+#include <glm/glm.hpp>
+#include <limits>
+
+// Axis-aligned box. Default constructed it is empty: it contains nothing and
+// expanding it by anything gives that thing.
+struct Aabb {
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+    Aabb() = default;
+    Aabb(const glm::vec3& min_, const glm::vec3& max_) : min(min_), max(max_) {}
+
+    bool IsEmpty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    glm::vec3 Center() const {
+        return (min + max) * 0.5f;
+    }
+
+    // Half size along each axis
+    glm::vec3 Extents() const {
+        return (max - min) * 0.5f;
+    }
+
+    float SurfaceArea() const {
+        if (IsEmpty()) {
+            return 0.0f;
+        }
+        const glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void Expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Expand(const Aabb& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    Aabb Inflated(float margin) const {
+        return Aabb(min - glm::vec3(margin), max + glm::vec3(margin));
+    }
+
+    bool Contains(const Aabb& other) const {
+        return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+    }
+
+    bool Intersects(const Aabb& other) const {
+        return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+    }
+
+    // 0 inside the box
+    float DistanceSquared(const glm::vec3& point) const {
+        const glm::vec3 outside = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+        return glm::dot(outside, outside);
+    }
+
+    bool Intersects(const glm::vec3& center, float radius) const {
+        return DistanceSquared(center) <= radius * radius;
+    }
+
+    // Box around the transformed box (Arvo): the center moves with the matrix, the extents
+    // through its absolute value
+    Aabb Transformed(const glm::mat4& matrix) const {
+        if (IsEmpty()) {
+            return *this;
+        }
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(Center(), 1.0f));
+        const glm::vec3 extents = Extents();
+        const glm::vec3 world =
+            glm::abs(glm::vec3(matrix[0])) * extents.x +
+            glm::abs(glm::vec3(matrix[1])) * extents.y +
+            glm::abs(glm::vec3(matrix[2])) * extents.z;
+        return Aabb(center - world, center + world);
+    }
+
+    static Aabb Union(const Aabb& a, const Aabb& b) {
+        return Aabb(glm::min(a.min, b.min), glm::max(a.max, b.max));
+    }
+};
+
+// The six planes of a view volume, normals pointing inwards
+struct Frustum {
+    enum class Test { Outside, Intersects, Inside };
+
+    glm::vec4 planes[6];
+
+    Frustum() = default;
+
+    // Planes of a view x projection matrix (Gribb and Hartmann), in the space the matrix maps from
+    explicit Frustum(const glm::mat4& viewProjection) {
+        const glm::mat4 m = glm::transpose(viewProjection);
+        planes[0] = m[3] + m[0]; // left
+        planes[1] = m[3] - m[0]; // right
+        planes[2] = m[3] + m[1]; // bottom
+        planes[3] = m[3] - m[1]; // top
+        planes[4] = m[3] + m[2]; // near
+        planes[5] = m[3] - m[2]; // far
+        for (glm::vec4& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    // Conservative: boxes near a corner of the frustum may be reported as intersecting it
+    Test Classify(const Aabb& box) const {
+        const glm::vec3 center = box.Center();
+        const glm::vec3 extents = box.Extents();
+        Test result = Test::Inside;
+        for (const glm::vec4& plane : planes) {
+            const glm::vec3 normal(plane);
+            const float distance = glm::dot(normal, center) + plane.w;
+            const float radius = glm::dot(glm::abs(normal), extents);
+            if (distance < -radius) {
+                return Test::Outside;
+            }
+            if (distance < radius) {
+                result = Test::Intersects;
+            }
+        }
+        return result;
+    }
+
+    bool Intersects(const Aabb& box) const {
+        return Classify(box) != Test::Outside;
+    }
+
+    bool Intersects(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif
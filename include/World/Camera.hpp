@@ -44,6 +44,12 @@ class Camera : public Component {
             float pitch = 0.0f
         );
 
+        std::shared_ptr<Component> Clone() const override;
+
+        std::size_t StateSize() const override;
+        void SaveState(void* out) const override;
+        void LoadState(const void* in) override;
+
         glm::mat4 GetViewMatrix() const;
 
         float GetYaw() const;
@@ -56,7 +62,8 @@ class Camera : public Component {
 
         glm::vec3 GetFront() const;
         glm::vec3 GetRight() const;
-        void Update() override;
+        // Late so the vectors follow yaw / pitch changes made by controllers during Update
+        void LateUpdate() override;
 };
 
 #endif
\ No newline at end of file
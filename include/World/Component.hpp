@@ -1,14 +1,27 @@
 #ifndef COMPONENT_HPP
 #define COMPONENT_HPP
 
+#include "World/EntityHandle.hpp"
+#include "World/Registry.hpp"
+#include "World/UpdateScheduler.hpp"
+
 #include <iostream>
+#include <memory>
 
 class Entity; // Forward declaration
 
 // Base class for all components
 class Component {
     protected:
-        Entity* m_owner = nullptr;
+        // Generational handle: a component outliving its entity sees a null owner instead of a dangling pointer
+        EntityHandle m_owner;
+
+        // Scripted components only, see UpdateScheduler
+        UpdatePriority m_updatePriority = UpdatePriority::Normal;
+        float m_deltaTime = 0.0f;
+
+        // Tick of the last MarkChanged
+        ChangeTick m_changeTick = 0;
 
     public:
         virtual ~Component() = default;
@@ -19,14 +32,65 @@ class Component {
         // Optional update method
         virtual void Update() {};
 
-        // Getter for owner
+        // Optional fixed-rate update, called Time::FixedDeltaTime() apart before Update
+        virtual void FixedUpdate() {};
+
+        // Optional update called once every component has run Update (e.g. cameras following a target)
+        virtual void LateUpdate() {};
+
+        // Optional, called when the component is removed or its entity destroyed, owner still set.
+        // Structural changes made from here have to go through an EntityCommandBuffer.
+        virtual void OnDestroy() {};
+
+        // Unattached copy of this component's settings, used by Prefab. Null for types that can't be copied.
+        virtual std::shared_ptr<Component> Clone() const {
+            return nullptr;
+        }
+
+        // Plain data captured by Scene::Snapshot and put back by Scene::Restore: SaveState writes
+        // StateSize() bytes, LoadState reads them. The size is the same for every component of a type;
+        // types without state to roll back keep the defaults.
+        virtual std::size_t StateSize() const {
+            return 0;
+        }
+
+        virtual void SaveState(void* /*out*/) const {}
+        virtual void LoadState(const void* /*in*/) {}
+
+        // Getter for owner, null when unset or destroyed
         Entity* GetOwner() const {
+            return Registry::Resolve(m_owner);
+        }
+
+        EntityHandle GetOwnerHandle() const {
             return m_owner;
         }
 
-        void SetOwner(Entity* owner) {
-            m_owner = owner;
+        void SetOwner(Entity* owner);
+
+        UpdatePriority GetUpdatePriority() const {
+            return m_updatePriority;
+        }
+
+        void SetUpdatePriority(UpdatePriority priority) {
+            m_updatePriority = priority;
+        }
+
+        // Frame time covered by the last scheduled Update: more than Time::DeltaTime() when frames were skipped
+        float GetDeltaTime() const {
+            return m_deltaTime;
+        }
+
+        void SetDeltaTime(float deltaTime) {
+            m_deltaTime = deltaTime;
+        }
+
+        // Called by the mutators of data others read (the renderer...), logs the owner in the Registry
+        void MarkChanged();
+
+        ChangeTick GetChangeTick() const {
+            return m_changeTick;
         }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,161 @@
+#ifndef COMPONENT_POOL_HPP
+#define COMPONENT_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template<typename T>
+class ComponentPool;
+
+// Standard allocator over ComponentPool, so std::allocate_shared places the shared_ptr
+// control block together with the object in a pool slot
+template<typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t count) {
+        if (count != 1) {
+            return std::allocator<T>().allocate(count);
+        }
+        return static_cast<T*>(ComponentPool<T>::Allocate());
+    }
+
+    void deallocate(T* pointer, std::size_t count) {
+        if (count != 1) {
+            std::allocator<T>().deallocate(pointer, count);
+            return;
+        }
+        ComponentPool<T>::Deallocate(pointer);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const {
+        return false;
+    }
+};
+
+// Typed slab allocator: every object of type T lives in fixed-size chunks of
+// contiguous slots, so instances created one after the other end up next to
+// each other in memory. Chunks are never moved, which keeps the addresses
+// handed to Python and to the registry stable. Freed slots are recycled.
+template<typename T>
+class ComponentPool {
+    public:
+        static constexpr std::size_t CHUNK_SIZE = 256;
+
+        // Raw slot, for class-level operator new and PoolAllocator
+        static void* Allocate() {
+            return Instance().AcquireSlot();
+        }
+
+        static void Deallocate(void* slot) {
+            Instance().m_freeSlots.push_back(static_cast<Slot*>(slot));
+        }
+
+        template<typename... Args>
+        static T* New(Args&&... args) {
+            void* slot = Allocate();
+            try {
+                return new (slot) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                Deallocate(slot);
+                throw;
+            }
+        }
+
+        static void Delete(T* object) {
+            if (!object) {
+                return;
+            }
+            object->~T();
+            Deallocate(object);
+        }
+
+        // Shared ownership flavour used by the Python bindings (pybind11 holds components by shared_ptr).
+        // The object and its control block share one pooled slot.
+        template<typename... Args>
+        static std::shared_ptr<T> Create(Args&&... args) {
+            return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+        }
+
+        // Allocates the chunks for `count` more objects up front, handed out in address order
+        static void Reserve(std::size_t count) {
+            Instance().ReserveSlots(count);
+        }
+
+        static std::size_t Capacity() {
+            return Instance().m_chunks.size() * CHUNK_SIZE;
+        }
+
+    private:
+        using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+        ComponentPool() = default;
+
+        // Intentionally leaked: components owned by static objects (the Window's scene)
+        // may be released after every function-local static has been destroyed.
+        static ComponentPool& Instance() {
+            static ComponentPool* instance = new ComponentPool();
+            return *instance;
+        }
+
+        void* AcquireSlot() {
+            if (!m_freeSlots.empty()) {
+                Slot* slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+                return slot;
+            }
+
+            if (m_chunks.empty() || m_used == CHUNK_SIZE) {
+                m_chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+                m_used = 0;
+            }
+
+            return &m_chunks.back()[m_used++];
+        }
+
+        void ReserveSlots(std::size_t count) {
+            const std::size_t left = m_chunks.empty() ? 0 : CHUNK_SIZE - m_used;
+            if (m_freeSlots.size() + left >= count) {
+                return;
+            }
+
+            // The rest of the current chunk and the new chunks go under the recycled slots, so they
+            // are used afterwards, in order (the free list is popped from the back)
+            std::vector<Slot*> reserved;
+            reserved.reserve(count + CHUNK_SIZE);
+            for (std::size_t i = m_used; i < CHUNK_SIZE && !m_chunks.empty(); ++i) {
+                reserved.push_back(&m_chunks.back()[i]);
+            }
+            while (m_freeSlots.size() + reserved.size() < count) {
+                m_chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+                for (std::size_t i = 0; i < CHUNK_SIZE; ++i) {
+                    reserved.push_back(&m_chunks.back()[i]);
+                }
+            }
+            m_used = CHUNK_SIZE;
+
+            m_freeSlots.insert(m_freeSlots.begin(), reserved.rbegin(), reserved.rend());
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> m_chunks;
+        std::vector<Slot*> m_freeSlots;
+        std::size_t m_used = 0;
+};
+
+#endif
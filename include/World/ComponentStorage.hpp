@@ -0,0 +1,68 @@
+#ifndef COMPONENT_STORAGE_HPP
+#define COMPONENT_STORAGE_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "World/EntityHandle.hpp"
+
+class Component; // Forward declaration
+
+using EntityId = std::uint32_t;
+using ComponentTypeId = std::uint32_t;
+
+constexpr EntityId INVALID_ENTITY = std::numeric_limits<EntityId>::max();
+constexpr std::size_t MAX_COMPONENT_TYPES = 64;
+
+// One bit per native component type attached to an entity
+using ComponentSignature = std::bitset<MAX_COMPONENT_TYPES>;
+
+// Sparse set holding every component of a single native type.
+// The dense arrays are packed (swap-remove), so iterating a type only touches live components,
+// while the sparse array gives O(1) entity -> component lookups.
+class ComponentStorage {
+    public:
+        bool Contains(EntityId entity) const {
+            return entity < m_sparse.size() && m_sparse[entity] != INVALID_INDEX;
+        }
+
+        Component* Get(EntityId entity) const {
+            return Contains(entity) ? m_components[m_sparse[entity]].get() : nullptr;
+        }
+
+        std::shared_ptr<Component> GetShared(EntityId entity) const {
+            return Contains(entity) ? m_components[m_sparse[entity]] : nullptr;
+        }
+
+        // Room for `count` more components, and ids up to `maxEntity`
+        void Reserve(std::size_t count, EntityId maxEntity);
+
+        // False, leaving the storage as it was, when the entity already has a component here
+        bool Insert(EntityId entity, std::shared_ptr<Component> component);
+        std::shared_ptr<Component> Remove(EntityId entity);
+
+        std::size_t Size() const {
+            return m_components.size();
+        }
+
+        const std::vector<EntityId>& Entities() const {
+            return m_entities;
+        }
+
+        const std::vector<std::shared_ptr<Component>>& Components() const {
+            return m_components;
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::vector<std::uint32_t> m_sparse;
+        std::vector<EntityId> m_entities;
+        std::vector<std::shared_ptr<Component>> m_components;
+};
+
+#endif
@@ -3,8 +3,12 @@
 
 #include "World/Transform.hpp"
 #include "World/Component.hpp"
+#include "World/ComponentPool.hpp"
+#include "World/Registry.hpp"
+#include "World/SceneIndex.hpp"
 #include "Api/PythonComponentWrapper.hpp"
 
+#include <string>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -12,40 +16,115 @@
 #include <typeinfo>
 #include <iostream>
 
+class Scene; // Forward declaration
+
+// Thin handle over the Registry: components live in the per-type storages,
+// the transform in the Transform pool, only the hierarchy is kept here.
+// Entities themselves are allocated from their own pool (see operator new and Create).
 class Entity {
     private:
-        Transform m_transform;
+        EntityId m_id;
+        Transform* m_transform;
         Entity* m_parent = nullptr;
 
-        std::vector<std::shared_ptr<Component>> m_components;
         std::vector<std::unique_ptr<Entity>> m_children;
+        std::vector<std::shared_ptr<PythonComponentWrapper>> m_scripts;
+
+        // Optional, indexed by the scene (see Scene::FindEntity and Scene::FindTagged)
+        std::string m_name;
+        TagMask m_tags = 0;
 
     public:
-        Entity() = default;
-        ~Entity() = default;
+        Entity() : m_id(Registry::CreateEntity(this)), m_transform(ComponentPool<Transform>::New()) {
+            m_transform->SetEntity(m_id);
+        }
+
+        ~Entity() {
+            m_children.clear();
+            Registry::DestroyEntity(m_id);
+            ComponentPool<Transform>::Delete(m_transform);
+        }
 
         Entity(const Entity&) = delete;
         Entity& operator=(const Entity&) = delete;
 
-        const std::vector<std::shared_ptr<Component>> Components() const {
-            return m_components;
+        // Pooled allocation, also used by std::make_unique for children
+        static void* operator new(std::size_t size) {
+            return size == sizeof(Entity) ? ComponentPool<Entity>::Allocate() : ::operator new(size);
+        }
+
+        static void operator delete(void* pointer, std::size_t size) {
+            if (size == sizeof(Entity)) {
+                ComponentPool<Entity>::Deallocate(pointer);
+            }
+            else {
+                ::operator delete(pointer);
+            }
+        }
+
+        // Shared root entity, the entity and its control block come from the pool
+        static std::shared_ptr<Entity> Create() {
+            return ComponentPool<Entity>::Create();
+        }
+
+        EntityId GetId() const {
+            return m_id;
+        }
+
+        EntityHandle GetHandle() const {
+            return Registry::GetHandle(m_id);
+        }
+
+        // Native components attached to this entity, gathered from the registry
+        std::vector<std::shared_ptr<Component>> Components() const {
+            std::vector<std::shared_ptr<Component>> components;
+            const ComponentSignature& signature = Registry::Signature(m_id);
+            for (ComponentTypeId type = 0; type < Registry::TypeCount(); ++type) {
+                if (signature.test(type)) {
+                    components.push_back(Registry::Storage(type).GetShared(m_id));
+                }
+            }
+            return components;
+        }
+
+        const std::vector<std::shared_ptr<PythonComponentWrapper>>& Scripts() const {
+            return m_scripts;
         }
 
         // Transform Access
         Transform& GetTransform() {
-            return m_transform;
+            return *m_transform;
         }
 
         const Transform& GetTransform() const {
-            return m_transform;
+            return *m_transform;
         }
 
         // Hierarchy
         void AddChild(std::unique_ptr<Entity> child) {
             child->m_parent = this;
+            child->m_transform->MarkDirty();
+            Registry::InheritFlags(child->m_id);
+            child->SetScene(GetScene());
             m_children.push_back(std::move(child));
         }
 
+        // Detaches this entity from its parent or scene. Unless something else still holds the root
+        // (e.g. a Python variable), the subtree is destroyed right away: OnDestroy on every component,
+        // then the storage slots, ids and pooled memory go back to their free lists.
+        // Not while the scene is being updated: use an EntityCommandBuffer there.
+        void Destroy();
+
+        // Destroys the child and its subtree
+        void RemoveChild(const Entity* child) {
+            auto it = std::find_if(m_children.begin(), m_children.end(), [child](const std::unique_ptr<Entity>& c) {
+                return c.get() == child;
+            });
+            if (it != m_children.end()) {
+                m_children.erase(it);
+            }
+        }
+
         const std::vector<std::unique_ptr<Entity>>& GetChildren() const {
             return m_children;
         }
@@ -54,37 +133,140 @@ class Entity {
             return m_parent;
         }
 
+        // Scene membership, propagated to the whole subtree
+        Scene* GetScene() const {
+            return Registry::GetScene(m_id);
+        }
+
+        void SetScene(Scene* scene) {
+            Registry::SetScene(m_id, scene);
+            for (auto& child : m_children) {
+                child->SetScene(scene);
+            }
+        }
+
+        // Disabled entities and their children are neither updated, moved nor rendered
+        void SetEnabled(bool enabled) {
+            if (enabled && !Registry::IsEnabled(m_id)) {
+                // Its subtree was skipped while disabled, refresh it
+                m_transform->MarkDirty();
+            }
+            Registry::SetEnabled(m_id, enabled);
+        }
+
+        bool IsEnabled() const {
+            return Registry::IsEnabled(m_id);
+        }
+
+        // Enabled, and so are all its ancestors
+        bool IsActive() const {
+            return Registry::IsActiveInHierarchy(m_id);
+        }
+
+        // Static entities (and their children) leave the update lists, their world matrix is
+        // baked once and only recomputed when they are explicitly moved
+        void SetStatic(bool isStatic) {
+            if (isStatic && !Registry::IsStatic(m_id)) {
+                m_transform->MarkDirty();
+            }
+            Registry::SetStatic(m_id, isStatic);
+        }
+
+        bool IsStatic() const {
+            return Registry::IsStatic(m_id);
+        }
+
+        // Name and tags, the scene's index follows their changes
+        const std::string& GetName() const {
+            return m_name;
+        }
+
+        void SetName(const std::string& name);
+
+        TagMask GetTags() const {
+            return m_tags;
+        }
+
+        void SetTags(TagMask tags);
+
+        void AddTags(TagMask tags) {
+            SetTags(m_tags | tags);
+        }
+
+        void RemoveTags(TagMask tags) {
+            SetTags(m_tags & ~tags);
+        }
+
+        // Carries every tag of `tags`
+        bool HasTags(TagMask tags) const {
+            return (m_tags & tags) == tags;
+        }
+
         // Components
-        void AddComponent(std::shared_ptr<Component> component) {
-            m_components.push_back(component);
+        // An entity holds at most one native component of each exact type: a second one is refused with
+        // a warning and false is returned, remove the first to replace it. Python components have no limit.
+        bool AddComponent(std::shared_ptr<Component> component) {
+            if (auto script = std::dynamic_pointer_cast<PythonComponentWrapper>(component)) {
+                script->SetOwner(this);
+                Registry::AddScript(m_id, script);
+                m_scripts.push_back(std::move(script));
+                return true;
+            }
+
+            // Owned only once accepted, the refused component may still belong to another entity
+            Component* added = component.get();
+            if (!Registry::AddComponent(m_id, std::move(component))) {
+                return false;
+            }
+            added->SetOwner(this);
+            return true;
         }
 
-        template<typename T>
-        T* GetComponent() const {
-            for (const auto& comp_ptr : m_components) {
-                if (T* specific_comp = dynamic_cast<T*>(comp_ptr.get())) {
-                    return specific_comp;
+        // Detaches the first component of the given type (or derived from it), native ones first,
+        // then calls its OnDestroy (the owner is still set). Returns it, or null when the entity has none.
+        std::shared_ptr<Component> RemoveComponent(ComponentTypeId type) {
+            if (!Registry::IsScriptType(type)) {
+                if (std::shared_ptr<Component> removed = Registry::RemoveComponent(m_id, type)) {
+                    removed->OnDestroy();
+                    return removed;
                 }
+            }
 
-                if (PythonComponentWrapper* wrapper = dynamic_cast<PythonComponentWrapper*>(comp_ptr.get())) {
-                    py::object py_obj = wrapper->PyComponent();
-                    if (py_obj && !py_obj.is_none()) {
-                        try {
-                            if (py::isinstance<T>(py_obj)) {
-                                return py_obj.cast<T*>();
-                            }
-                        } catch (const py::cast_error& e) {
-                            std::cerr << "Pybind11 cast error in Entity::GetComponent<T>: " << e.what() << std::endl;
-                        }
-                    }
+            for (auto it = m_scripts.begin(); it != m_scripts.end(); ++it) {
+                const auto& ids = (*it)->TypeIds();
+                if (std::find(ids.begin(), ids.end(), type) != ids.end()) {
+                    std::shared_ptr<PythonComponentWrapper> script = *it;
+                    Registry::RemoveScript(m_id, script.get());
+                    m_scripts.erase(it);
+                    script->OnDestroy();
+                    return script;
                 }
             }
 
             return nullptr;
         }
 
+        template<typename T>
+        std::shared_ptr<T> RemoveComponent() {
+            static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
+            std::shared_ptr<Component> removed = RemoveComponent(Registry::TypeId<T>());
+
+            // A Python component deriving from T: hand back its native part
+            if (auto script = std::dynamic_pointer_cast<PythonComponentWrapper>(removed)) {
+                removed = script->NativeComponent();
+            }
+            return std::static_pointer_cast<T>(removed);
+        }
+
+        // O(1): exact types and registered base types (e.g. RenderComponent) are both indexed by the registry
+        template<typename T>
+        T* GetComponent() const {
+            static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
+            return static_cast<T*>(Registry::GetComponent(m_id, Registry::TypeId<T>()));
+        }
+
     void Start() {
-        for (auto& component: m_components) {
+        for (auto& component : Components()) {
             try {
                 component->Start();
             }
@@ -93,37 +275,32 @@ class Entity {
             }
         }
 
+        for (auto& script : m_scripts) {
+            script->Start();
+        }
+
         for (auto& child : m_children) {
             child->Start();
         }
     }
 
-    // Update
-    void Update() {
-        // Update own components
+    // Recompute the model matrices of this subtree, parents before children.
+    // Every recomputed entity is appended to `changed`.
+    void UpdateTransforms(std::vector<Entity*>& changed) {
         if (m_parent) {
-            m_transform.ComputeModelMatrix(m_parent->GetTransform().GetModelMatrix());
+            m_transform->ComputeModelMatrix(m_parent->GetTransform().GetModelMatrix());
         }
         else {
-            m_transform.ComputeModelMatrix();
+            m_transform->ComputeModelMatrix();
         }
+        changed.push_back(this);
 
-        for (auto& component : m_components) {
-            for (auto& component: m_components) {
-                try {
-                    component->Update();
-                }
-                catch (const py::cast_error& e) {
-                    std::cerr << "Error while calling component Update" << std::endl;
-                }
-            }
-        }
-
-        // Update children
         for (auto& child: m_children) {
-            child->Update();
+            if (child->IsEnabled()) {
+                child->UpdateTransforms(changed);
+            }
         }
     }
 };
 
-#endif
\ No newline at end of file
+#endif
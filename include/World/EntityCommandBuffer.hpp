@@ -0,0 +1,92 @@
+#ifndef ENTITY_COMMAND_BUFFER_HPP
+#define ENTITY_COMMAND_BUFFER_HPP
+
+#include "World/EntityHandle.hpp"
+#include "World/ComponentStorage.hpp"
+#include "World/Registry.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+class Component; // Forward declaration
+class Entity; // Forward declaration
+class Scene; // Forward declaration
+
+// Records structural changes (entity creation / destruction, component add / remove) so they
+// are applied at a sync point instead of while the scene is being iterated.
+// Recording is safe from any thread, including JobSystem workers, Playback is main thread only.
+// Commands run in recording order; the ones targeting an entity destroyed in the meantime are dropped.
+class EntityCommandBuffer {
+    public:
+        // Placeholder for an entity created by this buffer, valid until the next Playback
+        struct PendingEntity {
+            std::uint32_t index = 0;
+        };
+
+        // New root entity of the scene the buffer is played back into
+        PendingEntity Create();
+        // New child entity
+        PendingEntity Create(EntityHandle parent);
+        PendingEntity Create(PendingEntity parent);
+
+        // Destroys the entity and its children
+        void Destroy(EntityHandle entity);
+
+        void AddComponent(EntityHandle entity, std::shared_ptr<Component> component);
+        void AddComponent(PendingEntity entity, std::shared_ptr<Component> component);
+
+        void RemoveComponent(EntityHandle entity, ComponentTypeId type);
+
+        template<typename T>
+        void RemoveComponent(EntityHandle entity) {
+            static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
+            RemoveComponent(entity, Registry::TypeId<T>());
+        }
+
+        // Applies and clears the recorded commands. Commands recorded meanwhile (e.g. from a
+        // Start called on an added component) are kept for the next playback.
+        void Playback(Scene& scene);
+
+        std::size_t Size() const;
+        bool Empty() const;
+
+    private:
+        enum class CommandType : std::uint8_t {
+            Create,
+            Destroy,
+            AddComponent,
+            RemoveComponent
+        };
+
+        // Either an existing entity or one created earlier in the same buffer
+        struct Target {
+            EntityHandle handle;
+            std::uint32_t pending = NO_PENDING;
+        };
+
+        struct Command {
+            CommandType type;
+            Target target;
+            std::shared_ptr<Component> component = nullptr;
+            ComponentTypeId componentType = 0;
+            bool hasParent = false;
+        };
+
+        static constexpr std::uint32_t NO_PENDING = 0xFFFFFFFFu;
+
+        void Record(Command command);
+        PendingEntity RecordCreate(Target parent, bool hasParent);
+
+        mutable std::mutex m_mutex;
+        std::vector<Command> m_commands;
+        std::uint32_t m_pendingCount = 0;
+
+        // Playback scratch, kept to avoid reallocating every frame
+        std::vector<Command> m_playing;
+        std::vector<EntityHandle> m_created;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef ENTITY_HANDLE_HPP
+#define ENTITY_HANDLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+// 64-bit weak reference to an entity: slot index in the registry plus the generation of
+// that slot. Destroying an entity bumps the generation, so handles to it stop resolving
+// even once the slot is reused.
+struct EntityHandle {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const EntityHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+template<>
+struct std::hash<EntityHandle> {
+    std::size_t operator()(const EntityHandle& handle) const {
+        return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(handle.generation) << 32) | handle.index);
+    }
+};
+
+#endif
@@ -44,6 +44,12 @@ class Mesh {
         Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
         void Draw(Shader& shader);
 
+        // Binds the textures to units 0.. and points the shader's samplers at them
+        void BindTextures(Shader& shader) const;
+
+        // Same textures, in the same order: binding either leaves the same state
+        bool SameTextures(const Mesh& other) const;
+
     private:
         // render data
         unsigned int m_VBO, m_EBO;
@@ -33,11 +33,33 @@ class Model : public RenderComponent {
         Model(std::string path_ = "");
         ~Model();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
+        void Enqueue(RenderQueue& queue, Shader& shader) override;
         std::string ShaderType();
 
+        // Union of the meshes' bounds once loaded, empty before
+        Aabb LocalBounds() const override {
+            return m_bounds;
+        }
+
+        // Triangles of the large meshes of the model. A model having some flags itself as an
+        // occluder once loaded (SetOccluder(false) afterwards opts out).
+        const std::vector<glm::vec3>& OccluderTriangles() const override {
+            return m_occluderTriangles;
+        }
+
     private:
+        // Meshes covering this fraction of the model's bounds area (and simple enough) are occluders
+        static constexpr float OCCLUDER_AREA_FRACTION = 0.25f;
+        static constexpr unsigned int MAX_OCCLUDER_TRIANGLES = 2048;
+
+        Aabb m_bounds;
+        std::vector<glm::vec3> m_occluderTriangles;
+
+        void PickOccluders(const aiScene* scene);
+
         // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
         void LoadModel();
 
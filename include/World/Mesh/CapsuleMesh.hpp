@@ -17,10 +17,43 @@ class CapsuleMesh : public RenderComponent {
         CapsuleMesh(float radius = 0.5f, float cylinderHeight = 1.0f, unsigned int sectorCount = 36, unsigned int hemisphereStacks = 18, unsigned int cylinderStacks = 10);
         ~CapsuleMesh();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) override;
+        void Enqueue(RenderQueue& queue, Shader& shader) override;
         std::string ShaderType() override;
 
+        // Along z: the cylinder is centered on the origin, a hemisphere caps each end
+        Aabb LocalBounds() const override {
+            const float halfLength = m_cylinderHeight / 2.0f + m_radius;
+            return Aabb(glm::vec3(-m_radius, -m_radius, -halfLength), glm::vec3(m_radius, m_radius, halfLength));
+        }
+
+        // The box inscribed in the cylinder
+        const std::vector<glm::vec3>& OccluderTriangles() const override {
+            return m_occluderTriangles;
+        }
+
+        float GetRadius() const {
+            return m_radius;
+        }
+
+        float GetCylinderHeight() const {
+            return m_cylinderHeight;
+        }
+
+        unsigned int GetSectorCount() const {
+            return m_sectorCount;
+        }
+
+        unsigned int GetHemisphereStacks() const {
+            return m_hemisphereStacks;
+        }
+
+        unsigned int GetCylinderStacks() const {
+            return m_cylinderStacks;
+        }
+
     private:
         void GenerateVertices();
         void SetupMesh();
@@ -31,10 +64,11 @@ class CapsuleMesh : public RenderComponent {
         unsigned int m_hemisphereStacks; // Stacks pour chaque demi-sphère
         unsigned int m_cylinderStacks; // Stacks pour la partie cylindrique
 
-        unsigned int m_VAO;
-        unsigned int m_VBO;
+        unsigned int m_VAO = 0;
+        unsigned int m_VBO = 0;
 
         std::vector<float> m_vertices;
+        std::vector<glm::vec3> m_occluderTriangles;
         static const float PI;
 };
 
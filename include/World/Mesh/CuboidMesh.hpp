@@ -17,10 +17,17 @@ class CuboidMesh : public RenderComponent {
         CuboidMesh();
         ~CuboidMesh();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+        void Enqueue(RenderQueue& queue, Shader& shader) override;
         std::string ShaderType() override;
 
+        const std::vector<glm::vec3>& OccluderTriangles() const override {
+            static const std::vector<glm::vec3> triangles = BoxTriangles(LocalBounds());
+            return triangles;
+        }
+
     private:
         void SetupMesh();
         unsigned int m_VAO = 0;
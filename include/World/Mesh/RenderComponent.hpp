@@ -2,31 +2,95 @@
 #define RENDER_COMPONENT_HPP
 
 #include "World/Component.hpp"
+#include "World/Bounds.hpp"
 #include "Graphics/Shader.hpp"
 #include "Graphics/Texture.hpp"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
+
+class RenderQueue; // Forward declaration
 
 class RenderComponent : public Component {
     public:
         virtual ~RenderComponent() = default;
 
         virtual void Start() override = 0;
+        // The Window sets view, projection and the TransformBuffer on the shader once per frame, the
+        // component only picks its matrix with the "instance" uniform (its entity id)
         virtual void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) = 0;
+
+        // Queues the draws of the mesh, sorted with the rest of the frame before they are issued.
+        // Unless overridden a single packet calls Render, breaking the state the queue tracks.
+        virtual void Enqueue(RenderQueue& queue, Shader& shader);
         
         void SetTexture(std::shared_ptr<Texture> texture) {
             m_texture = std::move(texture);
+            MarkChanged();
         }
 
         Texture GetTexture() {
             return *m_texture;
         }
 
+        const std::shared_ptr<Texture>& GetSharedTexture() const {
+            return m_texture;
+        }
+
         virtual std::string ShaderType() = 0;
 
+        // Extent of the mesh in model space, what the scene's BVH is fed with (through the model
+        // matrix). The unit cube the built-in meshes are modeled in unless overridden; empty
+        // while unknown, e.g. a Model not loaded yet.
+        virtual Aabb LocalBounds() const {
+            return Aabb(glm::vec3(-0.5f), glm::vec3(0.5f));
+        }
+
+        // Occluders are drawn into the CPU depth buffer the other meshes are tested against (see
+        // OcclusionCuller): large and simple meshes hiding many others, like walls and buildings
+        void SetOccluder(bool occluder) {
+            m_occluder = occluder;
+        }
+
+        bool IsOccluder() const {
+            return m_occluder;
+        }
+
+        // Triangles (three vertices each, in model space) drawn when the mesh is an occluder. They must
+        // stay inside the mesh, or what is behind it would be hidden wrongly. None unless overridden.
+        virtual const std::vector<glm::vec3>& OccluderTriangles() const {
+            static const std::vector<glm::vec3> none;
+            return none;
+        }
+
     protected:
         std::shared_ptr<Texture> m_texture;
+        bool m_occluder = false;
+
+        // Queues glDrawArrays of the first `count` vertices of the vertex array, with the texture on
+        // unit 0. Textures with an alpha channel go to the transparent pass.
+        void EnqueueArrays(RenderQueue& queue, Shader& shader, unsigned int vertexArray, GLsizei count);
+
+        static std::vector<glm::vec3> BoxTriangles(const Aabb& box) {
+            const glm::vec3 corners[8] = {
+                { box.min.x, box.min.y, box.min.z }, { box.max.x, box.min.y, box.min.z },
+                { box.min.x, box.max.y, box.min.z }, { box.max.x, box.max.y, box.min.z },
+                { box.min.x, box.min.y, box.max.z }, { box.max.x, box.min.y, box.max.z },
+                { box.min.x, box.max.y, box.max.z }, { box.max.x, box.max.y, box.max.z }
+            };
+            static const int faces[6][4] = {
+                { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 }
+            };
+
+            std::vector<glm::vec3> triangles;
+            for (const auto& face : faces) {
+                for (int index : { face[0], face[1], face[2], face[0], face[2], face[3] }) {
+                    triangles.push_back(corners[index]);
+                }
+            }
+            return triangles;
+        }
 };
 
 #endif
\ No newline at end of file
@@ -15,10 +15,30 @@ class SphereMesh : public RenderComponent {
         SphereMesh(unsigned int sectorCount = 36, unsigned int stackCount = 18);
         ~SphereMesh();
 
+        std::shared_ptr<Component> Clone() const override;
         void Start() override;
         void Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+        void Enqueue(RenderQueue& queue, Shader& shader) override;
         std::string ShaderType() override;
 
+        Aabb LocalBounds() const override {
+            return Aabb(glm::vec3(-1.0f), glm::vec3(1.0f));
+        }
+
+        // The cube inscribed in the sphere
+        const std::vector<glm::vec3>& OccluderTriangles() const override {
+            static const std::vector<glm::vec3> triangles = BoxTriangles(Aabb(glm::vec3(-0.577f), glm::vec3(0.577f)));
+            return triangles;
+        }
+
+        unsigned int GetSectorCount() const {
+            return m_sectorCount;
+        }
+
+        unsigned int GetStackCount() const {
+            return m_stackCount;
+        }
+
     private:
         void GenerateVertices();
         void SetupMesh();
@@ -0,0 +1,150 @@
+#ifndef POTENTIALLY_VISIBLE_SET_HPP
+#define POTENTIALLY_VISIBLE_SET_HPP
+
+#include "World/Bounds.hpp"
+#include "World/Registry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Entity; // Forward declaration
+class Scene; // Forward declaration
+
+// Precomputed visibility of the static meshes of a level (entities flagged static with a RenderComponent).
+// Baking splits the level's bounds into cells and finer voxels. Voxels entirely inside the occluder
+// triangles (RenderComponent::OccluderTriangles) of a static mesh are solid: the ones no triangle passes
+// through and that can't be reached from outside without crossing one. Cells then see each other when
+// one of a few rays between random open points of both gets through, and a mesh is visible from every
+// cell seeing a cell its box overlaps.
+// At runtime the cell of the camera gives a run-length compressed bitset of the meshes it may see,
+// decompressed once when the camera enters it; the others are left out before frustum culling.
+// Rays sample visibility, so gaps narrower than the spacing of the rays can be missed; walls thinner
+// than two voxels don't block anything. Static meshes are assumed to stay where they were baked.
+class PotentiallyVisibleSet {
+    public:
+        static constexpr std::uint32_t VERSION = 1;
+        static constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+
+        // Beyond this the cell to cell matrix stops fitting in memory: raise the cell size
+        static constexpr std::size_t MAX_CELLS = 32768;
+
+        struct Settings {
+            float cellSize = 4.0f;
+            // Voxels along each side of a cell
+            int voxelsPerCell = 8;
+            // Rays tried between two cells before they are found hidden from each other
+            int raysPerPair = 32;
+        };
+
+        struct Stats {
+            std::size_t cells = 0;
+            std::size_t openCells = 0; // not entirely solid
+            std::size_t objects = 0;
+            std::size_t solidVoxels = 0;
+            std::size_t bytes = 0; // compressed rows
+            double bakeSeconds = 0.0;
+        };
+
+        // Bakes the static meshes of the scene, spread over the JobSystem. The same scene always gives
+        // the same set, whatever the number of workers. Throws when the level needs more than MAX_CELLS.
+        void Bake(const Scene& scene, const Settings& settings);
+
+        // Binary file, meant to sit next to the level's scene file (see Scene::Save). Throw when the
+        // file can't be written, or is missing, of another version or truncated.
+        void Save(const std::string& path) const;
+        void Load(const std::string& path);
+
+        // Maps the baked meshes to the entities of the scene, found in the same order as Bake does.
+        // False, with the set left unused, when they don't match what was baked.
+        bool Attach(const Scene& scene);
+
+        // Same, looking only under these roots: a level loaded into a scene holding other static
+        // meshes (another level, say) still matches. The others are always visible then.
+        bool Attach(const std::vector<std::shared_ptr<Entity>>& roots);
+
+        bool IsAttached() const {
+            return m_attached;
+        }
+
+        // The entity is no longer one of the meshes, e.g. destroyed (its id may be reused)
+        void Forget(EntityId id);
+
+        // Cell containing the point, NONE outside the level or in a solid cell
+        std::uint32_t CellAt(const glm::vec3& position) const;
+
+        // Selects the meshes visible from the position. False when the set can't tell (not attached,
+        // outside the level): everything is visible then.
+        bool SetViewpoint(const glm::vec3& position);
+
+        // After a successful SetViewpoint: false for the baked meshes the viewpoint can't see.
+        // Entities that aren't part of the set are always visible.
+        bool IsVisible(EntityId id) const {
+            if (id >= m_objectOf.size() || m_objectOf[id] == NONE) {
+                return true;
+            }
+            const std::uint32_t object = m_objectOf[id];
+            return (m_row[object >> 3] >> (object & 7)) & 1;
+        }
+
+        // Entities of the meshes visible from the cell, empty when not attached
+        std::vector<Entity*> VisibleEntities(std::uint32_t cell) const;
+
+        const Aabb& GetBounds() const {
+            return m_bounds;
+        }
+
+        const Stats& GetStats() const {
+            return m_stats;
+        }
+
+    private:
+        static constexpr char MAGIC[8] = { 'N', 'O', 'R', 'A', 'P', 'V', 'S', '\0' };
+
+        struct Header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t objectCount;
+            std::uint32_t cellCount;
+            std::uint32_t dimensions[3];
+            float origin[3];
+            float cellSize;
+            std::uint64_t objectHash;
+            std::uint64_t offsetsOffset;
+            std::uint64_t dataOffset;
+            std::uint64_t fileSize;
+        };
+
+        // The meshes, in the order they are numbered
+        static std::vector<Entity*> CollectObjects(const std::vector<std::shared_ptr<Entity>>& roots);
+        static std::uint64_t HashObjects(const std::vector<Entity*>& objects);
+
+        // Zero bytes come as a 0 followed by how many of them (up to 255), the others as they are
+        static void Compress(const std::vector<unsigned char>& row, std::vector<unsigned char>& out);
+        void Decompress(std::uint32_t offset, std::vector<unsigned char>& row) const;
+
+        glm::vec3 m_origin = glm::vec3(0.0f);
+        float m_cellSize = 1.0f;
+        glm::ivec3 m_dimensions = glm::ivec3(0);
+        Aabb m_bounds;
+        std::uint32_t m_objectCount = 0;
+        std::uint64_t m_objectHash = 0;
+
+        // Offset of each cell's row in m_rows, NONE for the solid cells
+        std::vector<std::uint32_t> m_offsets;
+        std::vector<unsigned char> m_rows;
+
+        // Runtime: object index by entity id, and the decompressed row of the current cell
+        bool m_attached = false;
+        std::vector<std::uint32_t> m_objectOf;
+        std::vector<Entity*> m_entities; // by object index
+        std::uint32_t m_cell = NONE;
+        std::vector<unsigned char> m_row;
+
+        Stats m_stats;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef PREFAB_HPP
+#define PREFAB_HPP
+
+#include "World/ComponentStorage.hpp"
+#include "World/SceneIndex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Component; // Forward declaration
+class Entity; // Forward declaration
+
+// Template of an entity subtree: local transforms, flags, names, tags and a copy of every component, captured
+// once and stamped out any number of times (see Scene::Instantiate). Components are copied with
+// Component::Clone, both when capturing (so later edits of the source don't leak into the prefab)
+// and for every instance; the ones that can't be cloned are left out.
+class Prefab {
+    public:
+        // Captures `root` and its children as they are now
+        explicit Prefab(const Entity& root);
+
+        // Entities per instance
+        std::size_t Size() const {
+            return m_nodes.size();
+        }
+
+        // Builds one unattached copy of the subtree. The root keeps the captured transform.
+        std::shared_ptr<Entity> Build() const;
+
+        // Native component types of one instance with their count, for preallocation
+        const std::vector<std::pair<ComponentTypeId, std::size_t>>& ComponentCounts() const {
+            return m_componentCounts;
+        }
+
+    private:
+        static constexpr std::uint32_t NO_PARENT = 0xFFFFFFFFu;
+
+        struct Node {
+            std::uint32_t parent = NO_PARENT;
+
+            glm::vec3 position;
+            glm::vec3 rotation;
+            glm::vec3 scale;
+
+            bool enabled = true;
+            bool isStatic = false;
+
+            std::string name;
+            TagMask tags = 0;
+
+            std::vector<std::shared_ptr<Component>> components;
+        };
+
+        void Capture(const Entity& entity, std::uint32_t parent);
+
+        // Parents before their children
+        std::vector<Node> m_nodes;
+        std::vector<std::pair<ComponentTypeId, std::size_t>> m_componentCounts;
+};
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include "World/ComponentStorage.hpp"
+#include "World/UpdatePhase.hpp"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+class Entity; // Forward declaration
+class Scene; // Forward declaration
+class Component; // Forward declaration
+class PythonComponentWrapper; // Forward declaration
+
+// Counts frames for change tracking, 0 means never
+using ChangeTick = std::uint32_t;
+
+// How far a consumer has read the change log: the tick, and the entries of it already seen
+struct ChangeCursor {
+    ChangeTick tick = 0;
+    std::uint32_t position = 0;
+};
+
+// Engine-wide component store.
+// Native components are kept in one sparse set per concrete type, Python components
+// (PythonComponentWrapper) in a flat list, and entities are plain ids into it.
+//
+// Type ids below MAX_COMPONENT_TYPES are native C++ types. Registering a native type
+// together with its bases (e.g. CuboidMesh -> RenderComponent) makes every component
+// reachable in O(1) through each of them. Python classes get ids above that range the
+// first time one of their instances is attached.
+//
+// Update dispatch goes through flat per-phase lists: the native types overriding that phase
+// (in type id order) and the Python components implementing it (in attachment order).
+class Registry {
+    public:
+        template<typename T>
+        static ComponentTypeId TypeId() {
+            static const ComponentTypeId id = TypeIdOf(typeid(T), PhasesOf<T>());
+            return id;
+        }
+
+        template<typename T, typename... Bases>
+        static ComponentTypeId RegisterType() {
+            const ComponentTypeId id = TypeId<T>();
+            (AddBaseType(id, TypeId<Bases>()), ...);
+            return id;
+        }
+
+        // Types first seen without their phases (e.g. through typeid only) run in every phase
+        // until TypeId<T>() gives the exact ones
+        static ComponentTypeId TypeIdOf(const std::type_info& type);
+        static ComponentTypeId TypeIdOf(const std::type_info& type, PhaseMask phases);
+        static ComponentTypeId TypeCount();
+        static const std::vector<ComponentTypeId>& BaseTypes(ComponentTypeId type);
+
+        static bool IsScriptType(ComponentTypeId type) {
+            return type >= MAX_COMPONENT_TYPES;
+        }
+
+        // Python type objects (PyTypeObject*) -> type id
+        static void BindPythonType(const void* pyType, ComponentTypeId type);
+        static bool FindPythonType(const void* pyType, ComponentTypeId& type);
+        static ComponentTypeId RegisterScriptType(const void* pyType);
+
+        // Entities
+        static EntityId CreateEntity(Entity* entity);
+        static void DestroyEntity(EntityId entity);
+
+        static Entity* GetEntity(EntityId entity);
+
+        // Upper bound of the entity ids in use
+        static std::size_t EntitySlots() {
+            return s_entities.size();
+        }
+
+        // Preallocation before creating many entities / components at once (see Scene::Instantiate)
+        static void ReserveEntities(std::size_t count);
+        // `count` components of `type` going onto some of `entityCount` entities about to be created
+        static void ReserveComponents(ComponentTypeId type, std::size_t count, std::size_t entityCount);
+
+        static EntityHandle GetHandle(EntityId entity) {
+            return { entity, s_entities[entity].generation };
+        }
+
+        // Null once the entity behind the handle has been destroyed
+        static Entity* Resolve(EntityHandle handle) {
+            return handle.index < s_entities.size() && s_entities[handle.index].generation == handle.generation
+                ? s_entities[handle.index].entity
+                : nullptr;
+        }
+
+        static Scene* GetScene(EntityId entity);
+        static void SetScene(EntityId entity, Scene* scene);
+
+        // Entity flags. Both are inherited by the children: an entity is active when it and all its
+        // ancestors are enabled, static when it or an ancestor is. Setting a flag pushes the inherited
+        // values down the entity's subtree, as far as they change (main thread).
+        static void SetEnabled(EntityId entity, bool enabled);
+        static void SetStatic(EntityId entity, bool isStatic);
+
+        static bool IsEnabled(EntityId entity) {
+            return s_entities[entity].enabled;
+        }
+
+        static bool IsStatic(EntityId entity) {
+            return s_entities[entity].isStatic;
+        }
+
+        static bool IsActiveInHierarchy(EntityId entity) {
+            return s_entities[entity].activeInHierarchy;
+        }
+
+        static bool IsStaticInHierarchy(EntityId entity) {
+            return s_entities[entity].staticInHierarchy;
+        }
+
+        // Active, dynamic entities are the only ones updated every frame
+        static bool IsUpdated(EntityId entity) {
+            return s_entities[entity].activeInHierarchy && !s_entities[entity].staticInHierarchy;
+        }
+
+        // Inherits the flags of the entity's new parent, then updates its subtree as far as they change
+        static void InheritFlags(EntityId entity);
+        static const ComponentSignature& Signature(EntityId entity);
+
+        // Entities whose transform changed since the last propagation pass (may hold stale or duplicate ids).
+        // Safe to call from JobSystem workers.
+        static void MarkTransformDirty(EntityId entity);
+
+        static std::vector<EntityId>& DirtyTransforms() {
+            return s_dirtyTransforms;
+        }
+
+        // Change tracking: an entity is logged (once per tick) when one of its components or its render
+        // matrix changes, so consumers like the renderer only look at what moved.
+        static ChangeTick CurrentTick() {
+            return s_changeTick;
+        }
+
+        // Starts a new tick, once per frame at its sync point (the Window's "commands" node). The oldest
+        // tick is dropped once CHANGE_HISTORY are kept.
+        static void NextTick();
+
+        // Safe to call from JobSystem workers
+        static void MarkChanged(EntityId entity);
+        static void MarkChanged(const std::vector<Entity*>& entities, std::size_t first = 0);
+
+        // Tick of the entity's last change
+        static ChangeTick ChangedAt(EntityId entity) {
+            return s_entities[entity].changeTick;
+        }
+
+        // Appends the live entities changed since the cursor, each once, then moves the cursor past them:
+        // what changes from now on, even during the current tick, is seen next time. Only the cursor is
+        // moved, so any number of consumers read the same history. False (nothing appended) for a new
+        // cursor or one older than the CHANGE_HISTORY kept ticks: everything has to be treated as changed.
+        static bool ConsumeChanges(ChangeCursor& cursor, std::vector<EntityId>& out);
+
+        // About a second of frames
+        static constexpr ChangeTick CHANGE_HISTORY = 64;
+
+        // Native components
+        // False, with a warning, when the entity already has a component of that exact type
+        static bool AddComponent(EntityId entity, std::shared_ptr<Component> component);
+
+        // Detaches the native component of type `type` (or derived from it), null if there is none
+        static std::shared_ptr<Component> RemoveComponent(EntityId entity, ComponentTypeId type);
+
+        // Component of the given type (or derived from it) attached to the entity
+        static Component* GetComponent(EntityId entity, ComponentTypeId type);
+        static std::shared_ptr<Component> GetSharedComponent(EntityId entity, ComponentTypeId type);
+
+        // Storage of the components whose concrete type is exactly `type`
+        static ComponentStorage& Storage(ComponentTypeId type);
+
+        static PhaseMask Phases(ComponentTypeId type) {
+            return s_phases[type];
+        }
+
+        // Native types with a non-empty implementation of the phase
+        static const std::vector<ComponentTypeId>& PhaseTypes(UpdatePhase phase) {
+            return s_phaseTypes[static_cast<std::size_t>(phase)];
+        }
+
+        // Python components
+        static void AddScript(EntityId entity, const std::shared_ptr<PythonComponentWrapper>& script);
+        static void RemoveScript(EntityId entity, const PythonComponentWrapper* script);
+        // Python components implementing the phase. Removed ones leave a null slot until CompactScripts.
+        static const std::vector<PythonComponentWrapper*>& Scripts(UpdatePhase phase) {
+            return s_phaseScripts[static_cast<std::size_t>(phase)];
+        }
+
+        // Closes the holes left by removed scripts, keeping the attachment order. Called once per
+        // frame at the sync point, never while the lists are being walked.
+        static void CompactScripts();
+
+    private:
+        struct EntityRecord {
+            Entity* entity = nullptr;
+            Scene* scene = nullptr;
+            std::uint32_t generation = 0;
+            ComponentSignature signature;
+
+            bool enabled = true;
+            bool isStatic = false;
+
+            // Inherited flags, kept up to date by InheritFlags
+            bool activeInHierarchy = true;
+            bool staticInHierarchy = false;
+
+            ChangeTick changeTick = 0;
+            std::uint32_t changePosition = 0; // in the log of changeTick
+        };
+
+        static void AddBaseType(ComponentTypeId type, ComponentTypeId base);
+        static void SetPhases(ComponentTypeId type, PhaseMask phases);
+        // With s_changeMutex held
+        static void LogChange(EntityId entity);
+        static ComponentStorage* Lookup(ComponentTypeId type, EntityId entity);
+        static void RemovePhaseScripts(const PythonComponentWrapper* script);
+
+        // Points the `base` view of the entity at its next component of that base, if any
+        static void RefillView(EntityId entity, ComponentTypeId base, const PythonComponentWrapper* removed = nullptr);
+
+        inline static std::vector<EntityRecord> s_entities;
+        inline static std::vector<EntityId> s_freeIds;
+        inline static std::vector<EntityId> s_dirtyTransforms;
+        inline static std::mutex s_dirtyMutex;
+
+        // Entities changed during each of the last ticks, the front one being s_changeLogBegin
+        inline static std::deque<std::vector<EntityId>> s_changeLog = std::deque<std::vector<EntityId>>(1);
+        inline static ChangeTick s_changeTick = 1;
+        inline static ChangeTick s_changeLogBegin = 1;
+        // Entries of the current tick some consumer has read: an entity logged before changing again is
+        // logged anew, or that consumer would miss the change
+        inline static std::uint32_t s_changeRead = 0;
+        inline static std::mutex s_changeMutex;
+
+        // Concrete storages own the components, views index them again under each base type
+        inline static std::array<ComponentStorage, MAX_COMPONENT_TYPES> s_storages;
+        inline static std::array<ComponentStorage, MAX_COMPONENT_TYPES> s_views;
+        inline static std::array<std::vector<ComponentTypeId>, MAX_COMPONENT_TYPES> s_baseTypes;
+        inline static std::unordered_map<std::type_index, ComponentTypeId> s_typeIds;
+
+        inline static std::deque<ComponentStorage> s_scriptStorages;
+        inline static std::unordered_map<const void*, ComponentTypeId> s_pythonTypeIds;
+
+        inline static std::array<PhaseMask, MAX_COMPONENT_TYPES> s_phases;
+        inline static std::array<std::vector<ComponentTypeId>, UPDATE_PHASE_COUNT> s_phaseTypes;
+        inline static std::array<std::vector<PythonComponentWrapper*>, UPDATE_PHASE_COUNT> s_phaseScripts;
+        inline static bool s_scriptHoles = false;
+};
+
+#endif
@@ -2,46 +2,190 @@
 #define SCENE_HPP
 
 #include "World/Entity.hpp"
+#include "World/BoundingVolumeHierarchy.hpp"
+#include "World/PotentiallyVisibleSet.hpp"
+#include "World/SceneQuery.hpp"
+#include "World/SceneSnapshot.hpp"
+#include "World/UpdateScheduler.hpp"
+#include "World/Prefab.hpp"
 #include <vector>
 #include <memory>
-#include <functional>
+#include <algorithm>
+
+class Camera; // Forward declaration
 
 class Scene {
     private:
+        // Native components updated per job
+        static constexpr std::size_t UPDATE_GRAIN = 256;
+
         std::vector<std::shared_ptr<Entity>> m_rootEntities;
 
+        // Entity id -> index in m_rootEntities, so removing a root doesn't search the list
+        std::vector<std::uint32_t> m_rootSlots;
+        std::vector<std::unique_ptr<SceneQuery>> m_queries;
+        std::vector<Entity*> m_changedEntities;
+        SceneIndex m_index;
+
+        // Bounds of the entities with a RenderComponent, synced from the change log by GetBvh
+        BoundingVolumeHierarchy m_bvh;
+        ChangeCursor m_bvhChangesRead;
+        std::vector<EntityId> m_bvhChanges; // scratch
+
+        // Baked visibility of the static meshes, shared by the copies of the scene
+        std::shared_ptr<PotentiallyVisibleSet> m_pvs;
+        UpdateScheduler m_scheduler;
+
+        // Entities moved by the last fixed step, rendered between their previous and current matrix
+        std::vector<EntityHandle> m_interpolated;
+        std::vector<Entity*> m_interpolatedEntities; // scratch, logged as changed in one go
+
+        bool m_isStarted = false;
+
+        void IndexRoots();
+        void CollectMatches(SceneQuery& query, Entity* entity) const;
+        void UpdateTransforms();
+        void DispatchNative(UpdatePhase phase, void (Component::*method)());
+        void DispatchScripts(UpdatePhase phase, void (PythonComponentWrapper::*method)());
+
     public:
         Scene() = default;
-        ~Scene() = default;
+        ~Scene();
+
+        // Copying a scene hands its entities over to the copy (see Window::SetScene)
+        Scene(const Scene& other);
+        Scene& operator=(const Scene& other);
 
         void AddEntity(std::shared_ptr<Entity> entity);
+
+        // Takes a root entity out of the scene in O(1), destroying it unless it is referenced elsewhere.
+        // The last root takes its place in GetRootEntities().
+        void RemoveEntity(const Entity* entity);
+
         const std::vector<std::shared_ptr<Entity>>& GetRootEntities() const;
 
+        // Adds `count` copies of the prefab as root entities, with the storages they need allocated
+        // up front. Each instance takes its root transform from a row of `stride` floats: position,
+        // then optionally euler rotation (stride >= 6) and scale (stride >= 9); missing parts keep
+        // the prefab's. Instances added to a started scene are started.
+        std::vector<EntityHandle> Instantiate(const Prefab& prefab, const float* transforms, std::size_t count, std::size_t stride);
+
+        std::vector<EntityHandle> Instantiate(const Prefab& prefab, const std::vector<glm::vec3>& positions) {
+            return Instantiate(prefab, positions.empty() ? nullptr : &positions[0].x, positions.size(), 3);
+        }
+
+        // Copies the state of every entity of the scene (see SceneSnapshot). Passing the previous
+        // snapshot shares its unchanged chunks instead of copying them again.
+        SceneSnapshot Snapshot(const SceneSnapshot* previous = nullptr) const;
+
+        // Puts the scene back in the captured state. Structural (roots come and go): not while the
+        // scene is being updated.
+        void Restore(const SceneSnapshot& snapshot);
+
+        // Writes the scene to a binary scene file (see SceneFile), and the attached PVS next to it
+        // (path + ".pvs"). Throws when it can't.
+        void Save(const std::string& path) const;
+
+        // Adds the root entities of a scene file, built in bulk from the mapped file. Entities added
+        // to a started scene are started. A PVS found next to the file replaces the scene's when it
+        // matches the static meshes of the file (others already in the scene stay always visible);
+        // an unreadable or stale one is left out with a warning. Nothing in the file gets executed:
+        // Python components only come back when their class was already imported (see SceneFile).
+        // Returns the handles of the new roots; throws when the file can't be read.
+        std::vector<EntityHandle> Load(const std::string& path);
+
+        // Bakes the visibility of the static meshes (see PotentiallyVisibleSet) and attaches it
+        PotentiallyVisibleSet& BakePvs(const PotentiallyVisibleSet::Settings& settings = PotentiallyVisibleSet::Settings());
+
+        // Attaches a baked set, dropped (with false returned) when it doesn't match the scene: every
+        // static mesh of the scene is compared, so a set baked for one level of a scene holding several
+        // doesn't match (Load attaches against the file's own roots). Null detaches the current one.
+        bool SetPvs(std::shared_ptr<PotentiallyVisibleSet> pvs);
+
+        // Null when none is attached
+        PotentiallyVisibleSet* GetPvs() const {
+            return m_pvs.get();
+        }
+
         void Start();
+
+        bool IsStarted() const {
+            return m_isStarted;
+        }
+
+        // Frame: BeginFrame, any number of FixedUpdate steps, then Update and LateUpdate.
+        // Each component runs once per phase it implements.
+        void BeginFrame();
+        void FixedUpdate();
         void Update();
+        void LateUpdate();
 
-        template<typename T> 
-        std::vector<Entity*> GetEntitiesWithComponent() const {
-            static_assert(std::is_base_of<Component, T>::value, "T must be a Component");
+        // Rates and budget of the Python Update calls
+        UpdateScheduler& GetScheduler() {
+            return m_scheduler;
+        }
+
+        // First camera of an active entity, null when there is none
+        Camera* GetActiveCamera();
+
+        // Blends the transforms moved by the last fixed step, alpha being Time::InterpolationAlpha()
+        void InterpolateTransforms(float alpha);
+
+        // Spatial index of the world bounds of the entities with a RenderComponent (active or not),
+        // first built on use then brought up to date with what changed since the last call: moves
+        // within the leaves' margin cost nothing, bigger ones a refit of their ancestors. Calls further
+        // apart than Registry::CHANGE_HISTORY frames build it again.
+        BoundingVolumeHierarchy& GetBvh();
+
+        // Entities whose model matrix was recomputed since BeginFrame (once per pass that moved them)
+        const std::vector<Entity*>& GetChangedEntities() const;
 
-            std::vector<Entity*> result;
+        // Persistent query over the entities owning all of Ts. Created (with a single walk of the
+        // hierarchy) on first use, then maintained incrementally.
+        template<typename... Ts>
+        SceneQuery& Query() {
+            static_assert((std::is_base_of<Component, Ts>::value && ...), "Ts must be Components");
+            return Query(std::vector<ComponentTypeId>{ Registry::TypeId<Ts>()... });
+        }
+
+        SceneQuery& Query(std::vector<ComponentTypeId> types);
 
-            std::function<void(Entity*)> search = [&](Entity* entity) {
-                if (entity->GetComponent<T>() != nullptr) {
-                    result.push_back(entity);
-                }
+        // O(1) lookup by name: the first entity of the scene carrying it, null when there is none
+        Entity* FindEntity(const std::string& name) const {
+            return m_index.Find(name);
+        }
+
+        const std::vector<Entity*>& FindEntities(const std::string& name) const {
+            return m_index.FindAll(name);
+        }
 
-                for (const auto& child : entity->GetChildren()) {
-                    search(child.get());
-                }
-            };
+        // Entities carrying every tag of `tags`, in time proportional to the smallest tag bucket
+        std::vector<Entity*> FindTagged(TagMask tags) const {
+            std::vector<Entity*> entities;
+            m_index.FindTagged(tags, entities);
+            return entities;
+        }
 
-            for (const auto& root : m_rootEntities) {
-                search(root.get());
-            }
+        // Entities carrying a single tag, no copy
+        const std::vector<Entity*>& Tagged(TagMask tag) const {
+            return m_index.Tagged(tag);
+        }
 
-            return result;
+        template<typename T> 
+        std::vector<Entity*> GetEntitiesWithComponent() {
+            const SceneQuery& query = Query<T>();
+            return std::vector<Entity*>(query.begin(), query.end());
         }
+
+        // Called by the Registry whenever the structure of the scene changes
+        void OnEntityAdded(Entity* entity);
+        void OnEntityRemoved(Entity* entity);
+        void OnComponentAdded(Entity* entity);
+        void OnComponentRemoved(Entity* entity);
+
+        // Called by the Entity
+        void OnEntityRenamed(Entity* entity, const std::string& previous);
+        void OnEntityRetagged(Entity* entity, TagMask previous);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,135 @@
+#ifndef SCENE_FILE_HPP
+#define SCENE_FILE_HPP
+
+#include "World/Component.hpp"
+#include "World/ComponentPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+class Entity; // Forward declaration
+class Scene; // Forward declaration
+
+// Binary scene file, see Scene::Save and Scene::Load.
+// Layout (little endian, every section 8-byte aligned):
+//   Header | EntityRecord[entityCount] | component records | string table
+// Entities are stored parents first with the index of their parent, so loading is a single pass.
+// Each component record is a fixed header (entity, type name, asset path, texture) followed by the
+// bytes its codec wrote. Names, type names and asset paths live once in the string table; tags are
+// stored by name and get this process's bits at load.
+// Native components need a codec (the engine ones are built in, see RegisterComponent), Python
+// components are stored as their module and class name with their state, and are rebuilt by
+// calling the class then restoring that state. Loading runs no code chosen by the file: the class
+// must be a Component subclass of a module already imported, and the state is plain data (None,
+// bool, int, float, str, bytes, list, tuple, dict), anything else left out at save with a warning.
+class SceneFile {
+    public:
+        static constexpr std::uint32_t VERSION = 2;
+
+        struct Codec {
+            // Path of the asset the component references, empty for none
+            std::function<std::string(const Component&)> asset;
+            std::function<void(const Component&, std::vector<unsigned char>&)> save;
+            std::function<std::shared_ptr<Component>(const std::string& asset, const unsigned char* data, std::size_t size)> load;
+        };
+
+        // Makes components of `type` savable under `name`, which is what the file refers to them by
+        static void RegisterComponent(const std::string& name, const std::type_info& type, Codec codec);
+
+        // Default constructible components whose state is Component::SaveState / LoadState
+        template<typename T>
+        static void RegisterComponent(const std::string& name) {
+            RegisterComponent(name, typeid(T), StateCodec<T>());
+        }
+
+        // Throws when the file can't be written. Components without a codec are left out with a warning.
+        static void Write(const Scene& scene, const std::string& path);
+
+        // Builds the root entities of the file, unattached. Throws when the file is missing, of
+        // another version or truncated.
+        static std::vector<std::shared_ptr<Entity>> Read(const std::string& path);
+
+    private:
+        static constexpr char MAGIC[8] = { 'N', 'O', 'R', 'A', 'S', 'C', 'N', '\0' };
+        static constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+        static constexpr std::size_t MAX_FILE_TAGS = 64;
+
+        static constexpr std::uint32_t FLAG_ENABLED = 1;
+        static constexpr std::uint32_t FLAG_STATIC = 2;
+
+        static constexpr std::uint32_t COMPONENT_PYTHON = 1;
+        static constexpr std::uint32_t COMPONENT_TEXTURE_ALPHA = 2;
+        static constexpr std::uint32_t COMPONENT_OCCLUDER = 4;
+
+        struct Header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t entityCount;
+            std::uint32_t rootCount;
+            std::uint32_t componentCount;
+            std::uint32_t stringCount;
+            std::uint64_t entitiesOffset;
+            std::uint64_t componentsOffset;
+            std::uint64_t stringsOffset;
+            std::uint64_t fileSize;
+            // String index of the name of each tag bit, NONE for the unused and unnamed ones
+            std::uint32_t tags[MAX_FILE_TAGS];
+        };
+
+        struct EntityRecord {
+            std::uint32_t parent;
+            std::uint32_t name;
+            std::uint32_t flags;
+            float position[3];
+            float rotation[3];
+            float scale[3];
+            // x, y, z, w: saves the trigonometry of converting the euler angles again
+            float quaternion[4];
+            std::uint64_t tags;
+        };
+
+        // Followed by `size` bytes, padded to 8
+        struct ComponentRecord {
+            std::uint32_t entity;
+            std::uint32_t type;
+            std::uint32_t asset;
+            std::uint32_t texture;
+            std::uint32_t flags;
+            std::uint32_t size;
+        };
+
+        struct Entry {
+            std::string name;
+            const std::type_info* type;
+            Codec codec;
+        };
+
+        template<typename T>
+        static Codec StateCodec() {
+            Codec codec;
+            codec.save = [](const Component& component, std::vector<unsigned char>& out) {
+                out.resize(component.StateSize());
+                component.SaveState(out.data());
+            };
+            codec.load = [](const std::string&, const unsigned char* data, std::size_t size) -> std::shared_ptr<Component> {
+                std::shared_ptr<T> component = ComponentPool<T>::Create();
+                if (size != 0 && size == component->StateSize()) {
+                    component->LoadState(data);
+                }
+                return component;
+            };
+            return codec;
+        }
+
+        // Registered types, the engine ones first
+        static std::vector<Entry>& Entries();
+        static const Entry* FindEntry(const std::string& name);
+        static const Entry* FindEntry(const std::type_info& type);
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SCENE_INDEX_HPP
+#define SCENE_INDEX_HPP
+
+#include "World/ComponentStorage.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Entity; // Forward declaration
+
+// One bit per tag, an entity can carry any of them
+using TagMask = std::uint64_t;
+constexpr std::size_t MAX_TAGS = 64;
+
+// Name and tag lookup of a scene, kept up to date by the Scene as entities come and go or get renamed.
+// Names hash to the entities carrying them (duplicates are allowed), each tag bit has a bucket
+// (a sparse set like SceneQuery) of the entities carrying it. Entities without name or tags cost nothing.
+class SceneIndex {
+    public:
+        // Bit of a named tag, given on first use. Throws past MAX_TAGS names.
+        static TagMask Tag(const std::string& name);
+
+        // Name of a single-bit tag, empty when unnamed
+        static const std::string& TagName(TagMask tag);
+
+        void Add(Entity* entity);
+        void Remove(Entity* entity);
+
+        // The entity's name or tags were `previous`, it already carries the new ones
+        void Rename(Entity* entity, const std::string& previous);
+        void Retag(Entity* entity, TagMask previous);
+
+        // Some entity with that name (the first one named so), null when there is none
+        Entity* Find(const std::string& name) const;
+        const std::vector<Entity*>& FindAll(const std::string& name) const;
+
+        // Entities carrying every tag of `mask`: walks the smallest of their buckets
+        void FindTagged(TagMask mask, std::vector<Entity*>& out) const;
+
+        // Entities carrying the tag, `tag` being a single bit
+        const std::vector<Entity*>& Tagged(TagMask tag) const;
+
+        void Clear();
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        struct Bucket {
+            std::vector<Entity*> entities;
+            std::vector<std::uint32_t> sparse;
+
+            void Insert(Entity* entity, EntityId id);
+            void Erase(EntityId id);
+        };
+
+        void AddName(Entity* entity, const std::string& name);
+        void RemoveName(Entity* entity, const std::string& name);
+        void AddTags(Entity* entity, TagMask tags);
+        void RemoveTags(Entity* entity, TagMask tags);
+
+        std::unordered_map<std::string, std::vector<Entity*>> m_names;
+        std::array<Bucket, MAX_TAGS> m_tags;
+
+        inline static std::unordered_map<std::string, TagMask> s_tagBits;
+        inline static std::array<std::string, MAX_TAGS> s_tagNames;
+};
+
+#endif
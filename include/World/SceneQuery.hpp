@@ -0,0 +1,59 @@
+#ifndef SCENE_QUERY_HPP
+#define SCENE_QUERY_HPP
+
+#include "World/ComponentStorage.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Entity; // Forward declaration
+
+// Cached list of the entities of a scene owning every component type in Types().
+// Kept up to date by the Scene as entities and components come and go, so iterating
+// it only touches the matching entities.
+class SceneQuery {
+    public:
+        explicit SceneQuery(std::vector<ComponentTypeId> types);
+
+        bool Matches(const Entity& entity) const;
+
+        bool Contains(EntityId entity) const {
+            return entity < m_sparse.size() && m_sparse[entity] != INVALID_INDEX;
+        }
+
+        void Add(Entity* entity);
+        void Remove(Entity* entity);
+
+        const std::vector<ComponentTypeId>& Types() const {
+            return m_types;
+        }
+
+        const std::vector<Entity*>& Entities() const {
+            return m_entities;
+        }
+
+        std::size_t Size() const {
+            return m_entities.size();
+        }
+
+        bool Empty() const {
+            return m_entities.empty();
+        }
+
+        std::vector<Entity*>::const_iterator begin() const {
+            return m_entities.begin();
+        }
+
+        std::vector<Entity*>::const_iterator end() const {
+            return m_entities.end();
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        std::vector<ComponentTypeId> m_types;
+        std::vector<Entity*> m_entities;
+        std::vector<std::uint32_t> m_sparse;
+};
+
+#endif
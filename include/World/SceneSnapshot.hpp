@@ -0,0 +1,95 @@
+#ifndef SCENE_SNAPSHOT_HPP
+#define SCENE_SNAPSHOT_HPP
+
+#include "World/ComponentStorage.hpp"
+#include "World/EntityHandle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class Entity; // Forward declaration
+class PythonComponentWrapper; // Forward declaration
+class Scene; // Forward declaration
+
+// State of a scene at one point, see Scene::Snapshot and Scene::Restore.
+// Transforms, flags and native component state (Component::SaveState) are copied into flat chunks of
+// CHUNK_SIZE entities. Given the previous snapshot, chunks whose bytes did not change are shared with
+// it instead of copied, so keeping a snapshot per frame costs about what moved.
+// The root entities are held, so roots destroyed since can be put back; children destroyed since
+// stay destroyed. Python components keep a copy of their attributes (shallow unless the class
+// defines __getstate__ / __setstate__).
+class SceneSnapshot {
+    public:
+        static constexpr std::size_t CHUNK_SIZE = 256;
+
+        std::size_t EntityCount() const {
+            return m_entityCount;
+        }
+
+        std::size_t ChunkCount() const {
+            return m_chunks.size();
+        }
+
+        // Chunks reused from the previous snapshot
+        std::size_t SharedChunks() const {
+            return m_sharedChunks;
+        }
+
+        // Bytes of the chunks copied by this snapshot
+        std::size_t OwnBytes() const {
+            return m_ownBytes;
+        }
+
+    private:
+        friend class Scene;
+
+        // 128 bytes, no padding, so chunks compare with memcmp
+        struct EntityState {
+            EntityHandle handle;
+            glm::vec3 position;
+            glm::vec3 rotation;
+            glm::vec3 scale;
+            glm::quat quaternion;
+            glm::mat4 modelMatrix;
+            std::uint32_t flags;
+        };
+
+        struct Chunk {
+            std::vector<EntityState> entities;
+
+            // Per entity with state: [entity index in the chunk, type id, size] then the bytes
+            std::vector<unsigned char> components;
+
+            bool operator==(const Chunk& other) const;
+            std::size_t Bytes() const;
+        };
+
+        struct ScriptState {
+            std::weak_ptr<PythonComponentWrapper> script;
+            // A py::object, opaque so Python's hidden types stay out of this header
+            std::shared_ptr<const void> state;
+        };
+
+        static constexpr std::uint32_t FLAG_ENABLED = 1;
+        static constexpr std::uint32_t FLAG_STATIC = 2;
+
+        void Capture(const Scene& scene, const SceneSnapshot* previous);
+        void Apply(Scene& scene) const;
+
+        static void CaptureEntity(Entity& entity, const std::vector<ComponentTypeId>& stateful, Chunk& chunk);
+        static void Flatten(Entity* entity, std::vector<Entity*>& out);
+
+        std::vector<std::shared_ptr<const Chunk>> m_chunks;
+        std::vector<std::shared_ptr<Entity>> m_roots;
+        std::vector<ScriptState> m_scripts;
+
+        std::size_t m_entityCount = 0;
+        std::size_t m_sharedChunks = 0;
+        std::size_t m_ownBytes = 0;
+};
+
+#endif
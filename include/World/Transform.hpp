@@ -1,59 +1,191 @@
 #ifndef TRANSFORM_HPP
 #define TRANSFORM_HPP
 
+#include "World/Registry.hpp"
+
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 class Transform {
+
     protected:
         // Local space information
         glm::vec3 m_pos = { 0.0f, 0.0f, 0.0f };
         glm::vec3 m_eulerRot = { 0.0f, 0.0f, 0.0f };
         glm::vec3 m_scale = { 1.0f, 1.0f, 1.0f };
 
+        // Rotation derived from the Euler angles, and the TRS matrix built from it
+        glm::quat m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::mat4 m_localMatrix = glm::mat4(1.0f);
+
         // Global space information concatenate in matrix
         glm::mat4 m_modelMatrix = glm::mat4(1.0f);
 
-        // Dirty flag
+        // Model matrix before its last recomputation, and the one the renderer draws with
+        // (equal to m_modelMatrix unless interpolating between two fixed steps)
+        glm::mat4 m_previousModelMatrix = glm::mat4(1.0f);
+        glm::mat4 m_renderMatrix = glm::mat4(1.0f);
+
+        // Dirty flags: m_isDirty for the model matrix, m_isLocalDirty for the cached local matrix
         bool m_isDirty = true;
+        bool m_isLocalDirty = true;
 
-        glm::mat4 GetLocalModelMatrix() {
-            const glm::mat4 transformX = glm::rotate(glm::mat4(1.0f), glm::radians(m_eulerRot.x), glm::vec3(1.0f, 0.0f, 0.0f));
-            const glm::mat4 transformY = glm::rotate(glm::mat4(1.0f), glm::radians(m_eulerRot.y), glm::vec3(0.0f, 1.0f, 0.0f));
-            const glm::mat4 transformZ = glm::rotate(glm::mat4(1.0f), glm::radians(m_eulerRot.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        // Owning entity, queued in the registry when the transform becomes dirty
+        EntityId m_entity = INVALID_ENTITY;
 
-            // Y * X * Z
-            const glm::mat4 rotationMatrix = transformY * transformX * transformZ;
+        // Tick of the last change of the render matrix (the Scene logs the entity in the Registry)
+        ChangeTick m_changeTick = 0;
 
-            // translation * rotation * scale (also know as TRS matrix)
-            return glm::translate(glm::mat4(1.0f), m_pos) * rotationMatrix * glm::scale(glm::mat4(1.0f), m_scale);
+        const glm::mat4& GetLocalModelMatrix() {
+            if (m_isLocalDirty) {
+                // translation * rotation * scale (also know as TRS matrix)
+                const glm::mat3 rotation = glm::mat3_cast(m_rotation);
+                m_localMatrix = glm::mat4(
+                    glm::vec4(rotation[0] * m_scale.x, 0.0f),
+                    glm::vec4(rotation[1] * m_scale.y, 0.0f),
+                    glm::vec4(rotation[2] * m_scale.z, 0.0f),
+                    glm::vec4(m_pos, 1.0f)
+                );
+                m_isLocalDirty = false;
+            }
+            return m_localMatrix;
+        }
+
+        // Same rotation order as before the quaternion cache: Y * X * Z
+        static glm::quat EulerToQuat(const glm::vec3& eulerDegrees) {
+            return glm::angleAxis(glm::radians(eulerDegrees.y), glm::vec3(0.0f, 1.0f, 0.0f))
+                * glm::angleAxis(glm::radians(eulerDegrees.x), glm::vec3(1.0f, 0.0f, 0.0f))
+                * glm::angleAxis(glm::radians(eulerDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
         }
 
     public:
+        void SetEntity(EntityId entity) {
+            m_entity = entity;
+            if (m_isDirty && m_entity != INVALID_ENTITY) {
+                Registry::MarkTransformDirty(m_entity);
+            }
+        }
+
+        // Queue the transform once per change, the scene recomputes it (and its subtree) on the next update
+        void MarkDirty() {
+            if (m_isDirty) {
+                return;
+            }
+
+            m_isDirty = true;
+            if (m_entity != INVALID_ENTITY) {
+                Registry::MarkTransformDirty(m_entity);
+            }
+        }
+
         void ComputeModelMatrix() {
-            m_modelMatrix = GetLocalModelMatrix();
-            m_isDirty = false;
+            SetModelMatrix(GetLocalModelMatrix());
         }
 
         void ComputeModelMatrix(const glm::mat4& parentGlobalModelMatrix) {
-            m_modelMatrix = parentGlobalModelMatrix * GetLocalModelMatrix();
+            SetModelMatrix(parentGlobalModelMatrix * GetLocalModelMatrix());
+        }
+
+        void SetModelMatrix(const glm::mat4& modelMatrix) {
+            m_previousModelMatrix = m_modelMatrix;
+            m_modelMatrix = modelMatrix;
+            m_renderMatrix = modelMatrix;
             m_isDirty = false;
+            m_changeTick = Registry::CurrentTick();
+        }
+
+        // Render matrix between the previous and the current model matrix: translation and
+        // scale are blended linearly, rotation is slerped
+        void Interpolate(float alpha) {
+            m_changeTick = Registry::CurrentTick();
+
+            const glm::vec3 previousScale = {
+                glm::length(glm::vec3(m_previousModelMatrix[0])),
+                glm::length(glm::vec3(m_previousModelMatrix[1])),
+                glm::length(glm::vec3(m_previousModelMatrix[2]))
+            };
+            const glm::vec3 currentScale = GetGlobalScale();
+
+            // Degenerate scale: no rotation to extract, blend the matrices directly
+            if (glm::min(glm::min(previousScale.x, previousScale.y), previousScale.z) < 1e-6f ||
+                glm::min(glm::min(currentScale.x, currentScale.y), currentScale.z) < 1e-6f) {
+                m_renderMatrix = m_previousModelMatrix + (m_modelMatrix - m_previousModelMatrix) * alpha;
+                return;
+            }
+
+            const glm::quat previousRotation = glm::quat_cast(glm::mat3(
+                glm::vec3(m_previousModelMatrix[0]) / previousScale.x,
+                glm::vec3(m_previousModelMatrix[1]) / previousScale.y,
+                glm::vec3(m_previousModelMatrix[2]) / previousScale.z
+            ));
+            const glm::quat currentRotation = glm::quat_cast(glm::mat3(
+                glm::vec3(m_modelMatrix[0]) / currentScale.x,
+                glm::vec3(m_modelMatrix[1]) / currentScale.y,
+                glm::vec3(m_modelMatrix[2]) / currentScale.z
+            ));
+
+            const glm::mat3 rotation = glm::mat3_cast(glm::slerp(previousRotation, currentRotation, alpha));
+            const glm::vec3 scale = glm::mix(previousScale, currentScale, alpha);
+            m_renderMatrix = glm::mat4(
+                glm::vec4(rotation[0] * scale.x, 0.0f),
+                glm::vec4(rotation[1] * scale.y, 0.0f),
+                glm::vec4(rotation[2] * scale.z, 0.0f),
+                glm::vec4(glm::mix(glm::vec3(m_previousModelMatrix[3]), glm::vec3(m_modelMatrix[3]), alpha), 1.0f)
+            );
+        }
+
+        // Puts back local data and world matrix captured earlier (see SceneSnapshot), nothing is recomputed
+        void RestoreState(const glm::vec3& position, const glm::vec3& rotation, const glm::quat& quaternion,
+                          const glm::vec3& scale, const glm::mat4& modelMatrix) {
+            m_pos = position;
+            m_eulerRot = rotation;
+            m_rotation = quaternion;
+            m_scale = scale;
+            m_isLocalDirty = true;
+
+            m_modelMatrix = modelMatrix;
+            m_previousModelMatrix = modelMatrix;
+            m_renderMatrix = modelMatrix;
+            m_isDirty = false;
+            m_changeTick = Registry::CurrentTick();
+        }
+
+        // Stop interpolating: render (and treat as previous) the current model matrix
+        void ResetInterpolation() {
+            m_previousModelMatrix = m_modelMatrix;
+            m_renderMatrix = m_modelMatrix;
+            m_changeTick = Registry::CurrentTick();
         }
 
         void SetLocalPosition(const glm::vec3& newPosition) {
             m_pos = newPosition;
-            m_isDirty = true;
+            m_isLocalDirty = true;
+            MarkDirty();
         }
 
         void SetLocalRotation(const glm::vec3& newRotation) {
             m_eulerRot = newRotation;
-            m_isDirty = true;
+            m_rotation = EulerToQuat(newRotation);
+            m_isLocalDirty = true;
+            MarkDirty();
         }
 
         void SetLocalScale(const glm::vec3& newScale) {
             m_scale = newScale;
-            m_isDirty = true;
+            m_isLocalDirty = true;
+            MarkDirty();
+        }
+
+        // Whole local transform at once, the quaternion being the one of `rotation` (see SceneFile)
+        void SetLocal(const glm::vec3& position, const glm::vec3& rotation, const glm::quat& quaternion, const glm::vec3& scale) {
+            m_pos = position;
+            m_eulerRot = rotation;
+            m_rotation = quaternion;
+            m_scale = scale;
+            m_isLocalDirty = true;
+            MarkDirty();
         }
 
         const glm::vec3 GetGlobalPosition() const {
@@ -72,10 +204,18 @@ class Transform {
             return m_scale;
         }
 
+        const glm::quat& GetLocalRotationQuat() const {
+            return m_rotation;
+        }
+
         const glm::mat4& GetModelMatrix() const {
             return m_modelMatrix;
         }
 
+        const glm::mat4& GetRenderMatrix() const {
+            return m_renderMatrix;
+        }
+
         glm::vec3 GetRight() const {
             return m_modelMatrix[0];
         }
@@ -99,6 +239,10 @@ class Transform {
         bool IsDirty() const {
             return m_isDirty;
         }
+
+        ChangeTick GetChangeTick() const {
+            return m_changeTick;
+        }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef UPDATE_PHASE_HPP
+#define UPDATE_PHASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+class Component; // Forward declaration
+
+// Per-frame update phases, run in this order: any number of fixed steps, then Update, then LateUpdate
+enum class UpdatePhase : std::uint8_t {
+    FixedUpdate,
+    Update,
+    LateUpdate
+};
+
+constexpr std::size_t UPDATE_PHASE_COUNT = 3;
+
+// One bit per UpdatePhase
+using PhaseMask = std::uint8_t;
+
+constexpr PhaseMask ALL_PHASES = (1u << UPDATE_PHASE_COUNT) - 1;
+
+constexpr PhaseMask PhaseBit(UpdatePhase phase) {
+    return static_cast<PhaseMask>(1u << static_cast<std::uint8_t>(phase));
+}
+
+// Phases T overrides, found at compile time: &T::Update only has type void (Component::*)()
+// when neither T nor any base between it and Component overrides Update
+template<typename T>
+constexpr PhaseMask PhasesOf() {
+    using Base = void (Component::*)();
+    PhaseMask mask = 0;
+    if (!std::is_same<decltype(&T::FixedUpdate), Base>::value) {
+        mask |= PhaseBit(UpdatePhase::FixedUpdate);
+    }
+    if (!std::is_same<decltype(&T::Update), Base>::value) {
+        mask |= PhaseBit(UpdatePhase::Update);
+    }
+    if (!std::is_same<decltype(&T::LateUpdate), Base>::value) {
+        mask |= PhaseBit(UpdatePhase::LateUpdate);
+    }
+    return mask;
+}
+
+#endif
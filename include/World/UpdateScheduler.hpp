@@ -0,0 +1,83 @@
+#ifndef UPDATE_SCHEDULER_HPP
+#define UPDATE_SCHEDULER_HPP
+
+#include "World/ComponentStorage.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class PythonComponentWrapper; // Forward declaration
+class Scene; // Forward declaration
+
+// How often a scripted component wants its Update, before the distance to the camera is applied
+enum class UpdatePriority : std::uint8_t {
+    Critical, // every frame, never cut by the budget
+    High,
+    Normal,
+    Low
+};
+
+constexpr std::size_t UPDATE_PRIORITY_COUNT = 4;
+
+// Bookkeeping of one scripted component, kept by its PythonComponentWrapper
+struct ScheduleState {
+    // Frame time elapsed since its last Update
+    float pendingDelta = 0.0f;
+
+    // Was due but cut by the budget: runs first chance it gets
+    bool overdue = false;
+};
+
+// Spreads the Update of Python components over frames. Each one runs every 1 to MAX_INTERVAL frames
+// depending on its priority and on how far its entity is from the camera (near / mid / far), the
+// frames it skips being added to the delta time of its next Update. With a budget, the non critical
+// updates left once it is spent wait for the next frame, which starts with them.
+// FixedUpdate and LateUpdate are not scheduled: they keep running once per step / frame.
+class UpdateScheduler {
+    public:
+        static constexpr std::uint32_t MAX_INTERVAL = 8;
+
+        // Milliseconds of Python Update per frame, 0 for no limit
+        void SetBudget(float milliseconds);
+        float Budget() const;
+
+        // Entities closer than `nearDistance` are near, farther than `farDistance` far
+        void SetDistances(float nearDistance, float farDistance);
+        float NearDistance() const;
+        float FarDistance() const;
+
+        // Frames between two updates for a priority and a distance band (0 near, 1 mid, 2 far)
+        static std::uint32_t Interval(UpdatePriority priority, std::size_t band);
+
+        // Calls Update on the scripts of `scene` that are due this frame. Without a viewer every
+        // entity counts as near.
+        void Run(const std::vector<PythonComponentWrapper*>& scripts, const Scene* scene, const glm::vec3* viewer, float deltaTime);
+
+        // Counters of the last Run
+        std::size_t Updated() const {
+            return m_updated;
+        }
+
+        std::size_t Deferred() const {
+            return m_deferred;
+        }
+
+    private:
+        std::size_t Band(EntityId entity, const glm::vec3& viewer) const;
+
+        float m_budget = 0.0f;
+        float m_nearDistance = 30.0f;
+        float m_farDistance = 100.0f;
+
+        std::uint64_t m_frame = 0;
+
+        // Where the previous frame ran out of budget
+        std::size_t m_cursor = 0;
+
+        std::size_t m_updated = 0;
+        std::size_t m_deferred = 0;
+};
+
+#endif
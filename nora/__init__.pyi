@@ -1,5 +1,5 @@
 from enum import Enum
-from typing import TypeVar, List, Tuple
+from typing import TypeVar, List, Tuple, Iterator, Callable, Type, Sequence, Any
 from abc import ABC
 
 
@@ -39,6 +39,7 @@ class Mat4:
 
     def __repr__(self) -> str: ...
     def __getitem__(self, index: int) -> List[float]: ... # Assuming row access
+    def __mul__(self, other: Mat4) -> Mat4: ...
 
 
 class Transform:
@@ -60,6 +61,9 @@ class Transform:
     model_matrix: Mat4
     """The combined model matrix representing the entity's transformation (read-only)."""
 
+    render_matrix: Mat4
+    """The model matrix interpolated between the last two fixed updates, as drawn (read-only)."""
+
     right: Vec3
     """The right vector of the entity in world space (read-only)."""
 
@@ -98,7 +102,195 @@ class Time:
     The number of frames per second calculated over the last second.
     Useful for performance monitoring and profiling.
     """
-    
+
+    fixed_delta_time: float
+    """
+    The time (in seconds) between two fixed updates, 1/60 by default.
+    `fixed_update` runs at this rate whatever the frame rate.
+    """
+
+    max_fixed_steps: int
+    """
+    The maximum number of fixed updates run in a single frame.
+    Time beyond that is dropped so a slow frame can't snowball.
+    """
+
+    interpolation_alpha: float
+    """
+    How far (between 0 and 1) the current frame is between the last fixed update and the next one.
+    """
+
+
+class JobSystem:
+    """
+    Counters of the engine's worker threads, which run the native component updates.
+    Python components always run on the main thread.
+    """
+
+    worker_count: int
+    """
+    The number of worker threads (the main thread not included).
+    """
+
+    steal_rate: float
+    """
+    The fraction of jobs that were stolen from another thread's queue.
+    """
+
+    idle_time: float
+    """
+    The time (in seconds) the workers spent waiting for work, summed over all of them.
+    """
+
+    @staticmethod
+    def reset_stats() -> None:
+        """
+        Resets the steal and idle counters.
+        """
+
+
+class WindowResizeEvent:
+    width: int
+    height: int
+
+
+class FrameRateEvent:
+    """
+    Published once a second, when `Time.fps` is refreshed.
+    """
+    fps: float
+
+
+class KeyEvent:
+    key: Key
+    pressed: bool
+    repeat: bool
+
+
+class MouseButtonEvent:
+    button: MouseCode
+    pressed: bool
+
+
+class EntitySpawnedEvent:
+    """
+    An entity joined the scene (created, attached as a child or moved in by a scene change).
+    """
+    entity: EntityHandle
+
+
+class CollisionEvent:
+    """
+    For collision systems to publish, the engine emits none yet.
+    """
+    first: EntityHandle
+    second: EntityHandle
+
+    def __init__(self, first: EntityHandle, second: EntityHandle) -> None: ...
+
+
+E = TypeVar("E")
+
+
+class EventBus:
+    """
+    Typed engine events, delivered once per frame (before the updates) in one batch per type.
+    Event types nobody subscribed to are not recorded.
+    """
+
+    @staticmethod
+    def subscribe(event_type: Type[E], callback: Callable[[List[E]], None]) -> int:
+        """
+        Calls `callback` with the list of events of that type published since the last frame.
+
+        :return: An id to pass to `unsubscribe`
+        """
+
+    @staticmethod
+    def unsubscribe(subscription: int) -> None: ...
+
+    @staticmethod
+    def publish(event: object) -> None:
+        """
+        Queues an event for the next dispatch.
+        """
+
+
+class FrameGraph:
+    """
+    The work of one frame as nodes that declare the resources they read and write. A node runs
+    after the earlier nodes that write what it reads or writes, and after the earlier readers of
+    what it writes. Independent engine nodes run on worker threads.
+
+    The default nodes, in order: "time", "input", "commands", "events", "update", "render",
+    "end_frame", "present", "poll". Resources used: "time", "input", "window", "scene", "events", "gpu".
+    """
+
+    nodes: list[str]
+
+    critical_path: list[str]
+    """
+    The chain of dependent nodes that took the longest last frame.
+    """
+
+    critical_path_time: float
+    """
+    Milliseconds of the critical path last frame.
+    """
+
+    frame_time: float
+    """
+    Milliseconds the whole graph took last frame.
+    """
+
+    def add_node(self, name: str, callback: Callable[[], None], reads: list[str] = ..., writes: list[str] = ...) -> None:
+        """
+        Appends a node run on the main thread every frame.
+        """
+
+    def node_time(self, name: str) -> float:
+        """
+        Milliseconds the node took last frame.
+        """
+
+
+class CullStats:
+    """
+    Frustum culling counts of a frame: active meshes tested, drawn and left out.
+    """
+    tested: int
+    visible: int
+    culled: int
+    hidden: int
+    """
+    Static meshes left out by the scene's PVS before testing.
+    """
+
+
+class OcclusionStats:
+    """
+    Software occlusion culling counts of a frame: occluders and triangles drawn into the CPU depth
+    buffer, meshes tested against it and found hidden.
+    """
+    occluders: int
+    triangles: int
+    tested: int
+    occluded: int
+
+
+class RenderStats:
+    """
+    Draw counts of a frame. Draws are sorted by shader, texture and vertex array first, a bind
+    is skipped when the previous draw left the same one bound.
+    """
+    draws: int
+    program_binds: int
+    texture_binds: int
+    vertex_array_binds: int
+    program_binds_skipped: int
+    texture_binds_skipped: int
+    vertex_array_binds_skipped: int
+
 
 class Window:
     """
@@ -108,6 +300,32 @@ class Window:
     background_color: Color
     scene: Scene
 
+    commands: CommandBuffer
+    """
+    Records entity and component creation / removal, applied at the start of the next frame.
+    Use it instead of changing the scene directly from inside `update()`.
+    """
+
+    frame_graph: FrameGraph
+    """
+    The nodes run each frame, with their timings.
+    """
+
+    cull_stats: CullStats
+    """
+    Meshes outside the camera's view are not drawn, these are last frame's counts.
+    """
+
+    occlusion_stats: OcclusionStats
+    """
+    Meshes hidden behind occluders are not drawn either, these are last frame's counts.
+    """
+
+    render_stats: RenderStats
+    """
+    Draws of the meshes left, and the state changes their order saved last frame.
+    """
+
     @staticmethod
     def set_title(title: str) -> None:
         """
@@ -261,15 +479,73 @@ class Input:
     def is_mouse_button_just_released(mouse_code: MouseCode) -> bool: ...
 
 
+class UpdatePriority(Enum):
+    Critical = 0
+    High = 1
+    Normal = 2
+    Low = 3
+
+
+class UpdateScheduler:
+    """
+    Spreads the `update` of Python components over frames, from their priority and their distance
+    to the active camera. Skipped frames are added to the component's `delta_time`.
+    """
+
+    budget: float
+    """
+    Milliseconds of Python `update` per frame, 0 for no limit. Critical components always run.
+    """
+
+    near_distance: float
+    far_distance: float
+
+    updated: int
+    """
+    The number of Python updates run last frame.
+    """
+
+    deferred: int
+    """
+    The number of Python updates pushed to a later frame last frame.
+    """
+
+
 class Component:
     """
     Base class for all components.
+
+    Override `fixed_update`, `update` and / or `late_update`: each frame runs the fixed steps, then
+    every `update`, then every `late_update`, and a component is only called for the ones it overrides.
+    """
+    owner: Entity | None
+    """
+    The entity this component is attached to, None once that entity has been destroyed.
+    """
+
+    owner_handle: EntityHandle
+
+    update_priority: UpdatePriority
+    """
+    How often `update` runs. Below Critical, far away components are updated less often (see UpdateScheduler).
+    """
+
+    delta_time: float
+    """
+    The time (in seconds) covered by the current `update`: `Time.delta_time`, or more when frames were skipped.
     """
-    owner: 'Entity'
 
     def __init__(self) -> None: ...
     def start(self) -> None: ...
     def update(self) -> None: ...
+    def fixed_update(self) -> None: ...
+    def late_update(self) -> None: ...
+
+    def on_destroy(self) -> None:
+        """
+        Called when the component is removed or its entity destroyed, `owner` still set.
+        """
+
     def set_owner(self, entity: Entity) -> None: ...
 
 
@@ -286,6 +562,27 @@ class Camera(Component):
     def __init__(self) -> None: ...
 
 
+class EntityHandle:
+    """
+    Weak reference to an entity (slot index + generation).
+    Stays safe to keep around after the entity is destroyed: it simply stops resolving.
+    """
+    index: int
+    generation: int
+
+    valid: bool
+    """
+    True while the entity behind the handle is alive.
+    """
+
+    def __init__(self) -> None: ...
+
+    def get(self) -> Entity | None:
+        """
+        Returns the entity, or None if it has been destroyed.
+        """
+
+
 class Entity:
     """
     Represents an entity in the game world.
@@ -293,6 +590,51 @@ class Entity:
     """
     transform: Transform
 
+    handle: EntityHandle
+    """
+    Generational handle to this entity.
+    """
+
+    enabled: bool
+    """
+    Disabled entities and their children are neither updated, moved nor rendered.
+    """
+
+    active: bool
+    """
+    True when the entity and all its ancestors are enabled (read-only).
+    """
+
+    static: bool
+    """
+    Static entities and their children are never updated, their world matrix is computed once
+    and only again when they are explicitly moved.
+    """
+
+    name: str
+    """
+    Optional name, found in O(1) with `Scene.find`.
+    """
+
+    tags: int
+    """
+    Bit mask of the entity's tags. Can be set from a tag name or a list of names.
+    """
+
+    @staticmethod
+    def tag(name: str) -> int:
+        """
+        Bit of a named tag, given on first use (64 at most).
+        """
+
+    def add_tag(self, tags: str | int | Sequence[str | int]) -> None: ...
+    def remove_tag(self, tags: str | int | Sequence[str | int]) -> None: ...
+
+    def has_tag(self, tags: str | int | Sequence[str | int]) -> bool:
+        """
+        True when the entity carries every one of the tags.
+        """
+
     def add_component(self, component: Component) -> None:
         """
         Adds a component to this entity.
@@ -300,6 +642,18 @@ class Entity:
         :param component: The component to add.
         """
 
+    def destroy(self) -> None:
+        """
+        Destroys this entity and its children at the start of the next frame.
+        Their components get `on_destroy` and their storage is reused by later entities.
+        """
+
+    def remove_component(self, type: type) -> None:
+        """
+        Removes the first component of the given type (or derived from it) at the start of the next frame,
+        after calling its `on_destroy`.
+        """
+
     def get_component(self, type: type[_T]) -> _T | None:
         """
         Gets a component of the specified type attached to this entity.
@@ -309,12 +663,244 @@ class Entity:
         """
     
 
+class PendingEntity:
+    """
+    Entity created by a CommandBuffer, only usable by later commands of that buffer within the same frame.
+    """
+    index: int
+
+
+class CommandBuffer:
+    """
+    Deferred structural changes, played back in recording order.
+    Commands targeting an entity destroyed in the meantime are ignored.
+    """
+    def create(self, parent: Entity | EntityHandle | PendingEntity | None = None) -> PendingEntity:
+        """
+        Creates an entity, a root of the window's scene or a child of `parent`.
+        """
+
+    def destroy(self, entity: Entity | EntityHandle) -> None:
+        """
+        Destroys the entity and its children.
+        """
+
+    def add_component(self, entity: Entity | EntityHandle | PendingEntity, component: Component) -> None: ...
+
+    def remove_component(self, entity: Entity | EntityHandle, type: type) -> None:
+        """
+        Removes the first component of the given type (or derived from it).
+        """
+
+    def __len__(self) -> int: ...
+
+
+class Query:
+    """
+    Persistent list of the entities of a scene owning every requested component type.
+    Kept up to date by the engine, iterating it only visits the matching entities.
+    """
+    def __len__(self) -> int: ...
+    def __getitem__(self, index: int) -> Entity: ...
+    def __iter__(self) -> Iterator[Entity]: ...
+
+
+class Prefab:
+    """
+    Copy of an entity, its children and their components, to be instantiated many times.
+    Later changes to the source entity don't affect the prefab.
+    Python components are copied by creating a new instance and copying the attributes (shallow copy).
+    """
+
+    def __init__(self, root: Entity) -> None: ...
+    def __len__(self) -> int: ...
+
+
+class Snapshot:
+    """
+    State of a scene at one point, from Scene.snapshot: transforms, enabled/static flags, native
+    component state and a copy of the Python components' attributes (shallow unless the class
+    defines __getstate__ / __setstate__). Entities are stored in chunks; given the previous snapshot,
+    unchanged chunks are shared with it, so a snapshot per frame costs about what moved.
+    """
+    entity_count: int
+    chunk_count: int
+    shared_chunks: int
+    own_bytes: int
+
+
+class Bvh:
+    """
+    Bounding volume hierarchy over the world bounds of the scene's entities with a RenderComponent
+    (from Scene.bvh). Queries cost about log(N) plus the number of results. Entities are returned
+    whether active or not.
+    """
+    def __len__(self) -> int: ...
+
+    def query_box(self, min: Vec3, max: Vec3) -> List[Entity]:
+        """
+        The entities whose bounds overlap the box.
+        """
+
+    def query_sphere(self, center: Vec3, radius: float) -> List[Entity]:
+        """
+        The entities whose bounds overlap the sphere.
+        """
+
+    def query_frustum(self, view_projection: Mat4) -> List[Entity]:
+        """
+        The entities whose bounds are (at least partly) inside the view volume of projection * view.
+        """
+
+    def nearest(self, point: Vec3, k: int = 1, max_distance: float = ...) -> List[Entity]:
+        """
+        Up to k entities closest to the point (distance to their bounds), closest first.
+        """
+
+    def bounds(self, entity: Entity) -> Tuple[Vec3, Vec3]:
+        """
+        Min and max corners of the entity's world bounds as the tree knows them.
+        """
+
+    def rebuild(self) -> None:
+        """
+        Rebuilds the tree from scratch. Not needed in general: it happens when moves have degraded it.
+        """
+
+    depth: int
+    cost: float
+
+
+class Pvs:
+    """
+    Potentially visible set of a level (from Scene.bake_pvs, or loaded with the scene): for each cell
+    of the level, the static meshes that may be seen from it. Window uses it to leave out the static
+    meshes hidden from the camera's cell before frustum culling.
+    """
+    def cell_at(self, position: Vec3) -> int | None:
+        """
+        Cell containing the point, None outside the level or in a solid cell.
+        """
+
+    def visible(self, position: Vec3) -> List[Entity]:
+        """
+        The static meshes that may be seen from the point, empty outside the level.
+        """
+
+    def save(self, path: str) -> None:
+        """
+        Writes the set to a binary file. Scene.save already writes it next to the scene file.
+        """
+
+    bounds: Tuple[Vec3, Vec3]
+    cell_count: int
+    open_cells: int
+    object_count: int
+    size: int
+    """
+    Bytes of the compressed rows.
+    """
+    bake_seconds: float
+
+
 class Scene:
+    scheduler: UpdateScheduler
+    bvh: Bvh
+    """
+    Spatial index of the scene, brought up to date with what changed since it was last accessed.
+    """
+    pvs: Pvs | None
+    """
+    The baked visibility of the static meshes, None when there is none.
+    """
+
     def __init__(self): ...
 
     def add_entity(entity: Entity) -> None: ...
     def get_root_entities() -> List[Entity]: ...
 
+    def find(self, name: str) -> Entity | None:
+        """
+        An entity of the scene with that name, in O(1). None when there is none.
+        """
+
+    def find_all(self, name: str) -> List[Entity]:
+        """
+        Every entity of the scene with that name.
+        """
+
+    def find_tagged(self, tags: str | int | Sequence[str | int]) -> List[Entity]:
+        """
+        The entities carrying every one of the tags, without walking the hierarchy.
+        """
+
+    def snapshot(self, previous: Snapshot | None = None) -> Snapshot:
+        """
+        Captures the scene. Pass the previous snapshot to share the chunks that did not change with it.
+        """
+
+    def restore(self, snapshot: Snapshot) -> None:
+        """
+        Puts the scene back as it was: root entities added since are removed, the ones removed since
+        come back, transforms and component state are restored. Children destroyed since stay destroyed.
+        Not from an update: call it from an event callback or a frame graph node.
+        """
+
+    def save(self, path: str) -> None:
+        """
+        Writes the scene to a versioned binary file: hierarchy, transforms, names, tags, native
+        components with the paths of their assets, and Python components (class and state).
+        Native components without a codec are left out with a warning. The state of a Python
+        component (its __dict__, or what __getstate__ returns) is saved as plain data: None, bool,
+        int, float, str, bytes, list, tuple and dict of those. A component whose state holds anything
+        else is saved without its state, with a warning. The PVS, when the scene has
+        one, is written next to it (path + ".pvs").
+        """
+
+    def load(self, path: str) -> List[EntityHandle]:
+        """
+        Adds the entities of a file written by save(). The file is memory-mapped and the entities
+        built in bulk; Python components are created by calling their class, then get their saved
+        state back. Loading never imports a module or runs code named by the file: the class must be
+        a Component subclass from a module the game already imported, or the component is left
+        out with a warning.
+
+        A PVS saved next to the file (path + ".pvs") is attached too, unless it can't be read or was
+        baked for other static meshes than the file's (a warning is logged then, and the scene is
+        loaded without it).
+
+        :return: The handles of the new root entities.
+        :raises RuntimeError: The file is missing, of another version or truncated.
+        """
+
+    def bake_pvs(self, cell_size: float = 4.0, voxels_per_cell: int = 8, rays_per_pair: int = 32) -> Pvs:
+        """
+        Precomputes which static meshes (entities flagged static with a RenderComponent) can be seen
+        from each cell of the level, on every worker thread. Their occluder triangles are voxelized:
+        walls block the view when they are at least two voxels (cell_size / voxels_per_cell) thick.
+        Cells see each other when one of rays_per_pair random rays between them gets through.
+        The result only depends on the scene. save() then writes it next to the scene file.
+
+        :raises RuntimeError: The level needs more than 32768 cells.
+        """
+
+    def instantiate(self, prefab: Prefab, transforms: Sequence[Vec3] | Sequence[Transform] | Any) -> List[EntityHandle]:
+        """
+        Adds one copy of the prefab per transform, in a single call. Storage for all of them is allocated up front.
+
+        :param transforms: The root transform of each copy: a list of Vec3 (positions), a list of Transform
+                           (position, rotation and scale), or a numpy array of shape (N, 3), (N, 6) or (N, 9)
+                           holding positions, then euler rotations, then scales.
+        :return: The handles of the new root entities.
+        """
+
+    def query(self, *types: type) -> Query:
+        """
+        Returns the cached query matching entities that own a component of each of the given types.
+
+        :param types: Component classes, native (e.g. Camera) or Python ones.
+        """
+
 
 class Texture:
     def __init__(self, path: str, flip_vertically: bool = False): ...
@@ -326,6 +912,11 @@ class Font:
 
 class RenderComponent(ABC, Component):
     texture: Texture
+    occluder: bool
+    """
+    Drawn into the CPU depth buffer other meshes are tested against: set it on large meshes hiding
+    many others (walls, buildings). Models with large meshes set it themselves once loaded.
+    """
 
 
 class CuboidMesh(RenderComponent):
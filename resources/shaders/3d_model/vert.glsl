@@ -6,11 +6,20 @@ layout (location = 2) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
-uniform mat4 model;
+// Render matrices of every entity, 4 texels each (see TransformBuffer)
+uniform samplerBuffer models;
+uniform int instance;
+
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
+    mat4 model = mat4(
+        texelFetch(models, instance * 4),
+        texelFetch(models, instance * 4 + 1),
+        texelFetch(models, instance * 4 + 2),
+        texelFetch(models, instance * 4 + 3)
+    );
     TexCoords = aTexCoords;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -5,11 +5,20 @@ layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
-uniform mat4 model;
+// Render matrices of every entity, 4 texels each (see TransformBuffer)
+uniform samplerBuffer models;
+uniform int instance;
+
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
+	mat4 model = mat4(
+		texelFetch(models, instance * 4),
+		texelFetch(models, instance * 4 + 1),
+		texelFetch(models, instance * 4 + 2),
+		texelFetch(models, instance * 4 + 3)
+	);
 	gl_Position = projection * view * model * vec4(aPos, 1.0f);
 	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
 }
@@ -1,7 +1,87 @@
 #include "Api/PythonComponentWrapper.hpp"
+#include "World/Registry.hpp"
 #include <iostream>
+#include <unordered_map>
 
-PythonComponentWrapper::PythonComponentWrapper(py::object py_component) : py_component_(py_component) {}
+PythonComponentWrapper::PythonComponentWrapper(py::object py_component) : py_component_(py_component) {
+    type_ids_ = &ResolveTypeIds(py::type::handle_of(py_component_));
+
+    if (py::isinstance<Component>(py_component_)) {
+        native_component_ = py_component_.cast<std::shared_ptr<Component>>();
+
+        // Plain Python components only derive from the empty nora.Component
+        if (typeid(*native_component_) != typeid(Component)) {
+            native_phases_ = Registry::Phases(Registry::TypeIdOf(typeid(*native_component_)));
+        }
+    }
+
+    python_phases_ = ResolvePythonPhases(py::type::handle_of(py_component_));
+}
+
+// A phase is implemented in Python when the class overrides the method inherited from nora.Component
+PhaseMask PythonComponentWrapper::ResolvePythonPhases(const py::handle& type) {
+    static std::unordered_map<const void*, PhaseMask> cache;
+
+    auto it = cache.find(type.ptr());
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    static const std::pair<UpdatePhase, const char*> methods[] = {
+        { UpdatePhase::FixedUpdate, "fixed_update" },
+        { UpdatePhase::Update, "update" },
+        { UpdatePhase::LateUpdate, "late_update" }
+    };
+
+    const py::handle component_type = py::type::of<Component>();
+    PhaseMask phases = 0;
+    for (const auto& [phase, name] : methods) {
+        const py::object method = py::getattr(type, name, py::none());
+        if (!method.is_none() && !method.is(component_type.attr(name))) {
+            phases |= PhaseBit(phase);
+        }
+    }
+
+    return cache.emplace(type.ptr(), phases).first->second;
+}
+
+// Walks the class MRO once per Python class. Native bound types (and their registered bases)
+// end the walk, every Python class above them gets its own script type id.
+const std::vector<ComponentTypeId>& PythonComponentWrapper::ResolveTypeIds(const py::handle& type) {
+    static std::unordered_map<const void*, std::vector<ComponentTypeId>> cache;
+
+    auto it = cache.find(type.ptr());
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    std::vector<ComponentTypeId> ids;
+    const py::handle component_type = py::type::of<Component>();
+    const py::handle object_type = reinterpret_cast<PyObject*>(&PyBaseObject_Type);
+
+    for (const py::handle base : type.attr("__mro__")) {
+        if (base.is(component_type) || base.is(object_type)) {
+            break;
+        }
+
+        ComponentTypeId id;
+        if (Registry::FindPythonType(base.ptr(), id)) {
+            ids.push_back(id);
+            if (!Registry::IsScriptType(id)) {
+                const auto& bases = Registry::BaseTypes(id);
+                ids.insert(ids.end(), bases.begin(), bases.end());
+                break;
+            }
+            continue;
+        }
+
+        // Keep the class object alive for as long as its id is in use
+        base.inc_ref();
+        ids.push_back(Registry::RegisterScriptType(base.ptr()));
+    }
+
+    return cache.emplace(type.ptr(), std::move(ids)).first->second;
+}
 
 void PythonComponentWrapper::Start() {
     try {
@@ -16,17 +96,119 @@ void PythonComponentWrapper::Start() {
 }
 
 void PythonComponentWrapper::Update() {
+    Dispatch(UpdatePhase::Update, "update");
+}
+
+void PythonComponentWrapper::FixedUpdate() {
+    Dispatch(UpdatePhase::FixedUpdate, "fixed_update");
+}
+
+void PythonComponentWrapper::LateUpdate() {
+    Dispatch(UpdatePhase::LateUpdate, "late_update");
+}
+
+void PythonComponentWrapper::OnDestroy() {
+    // Entities still alive at exit are destroyed after the interpreter
+    if (Py_IsInitialized()) {
+        try {
+            if (py::hasattr(py_component_, "on_destroy")) {
+                py_component_.attr("on_destroy")();
+            }
+        }
+        catch (const py::error_already_set& e) {
+            std::cerr << "Python exception in PythonComponentWrapper::OnDestroy: " << e.what() << std::endl;
+        }
+    }
+
+    // Then the native component it derives from releases what it holds
+    if (native_component_) {
+        native_component_->OnDestroy();
+    }
+}
+
+void PythonComponentWrapper::Dispatch(UpdatePhase phase, const char* name) {
+    if (!(python_phases_ & PhaseBit(phase))) {
+        // Inherited from a native component: skip the round trip through Python
+        if (native_component_ && (native_phases_ & PhaseBit(phase))) {
+            switch (phase) {
+                case UpdatePhase::FixedUpdate: native_component_->FixedUpdate(); break;
+                case UpdatePhase::Update: native_component_->Update(); break;
+                case UpdatePhase::LateUpdate: native_component_->LateUpdate(); break;
+            }
+        }
+        return;
+    }
+
     try {
-        if (py::hasattr(py_component_, "update")) {
-            py::function start_func = py_component_.attr("update");
-            start_func();
+        py_component_.attr(name)();
+    }
+    catch (const py::error_already_set& e) {
+        std::cerr << "Python exception in PythonComponentWrapper::" << name << ": " << e.what() << std::endl;
+    }
+}
+
+std::shared_ptr<Component> PythonComponentWrapper::Clone() const {
+    py::object copy = py::type::handle_of(py_component_)();
+    if (py::hasattr(py_component_, "__dict__")) {
+        copy.attr("__dict__").attr("update")(py_component_.attr("__dict__"));
+    }
+
+    auto clone = std::make_shared<PythonComponentWrapper>(copy);
+    if (native_component_ && clone->native_component_) {
+        clone->native_component_->SetUpdatePriority(native_component_->GetUpdatePriority());
+    }
+    return clone;
+}
+
+py::object PythonComponentWrapper::GetPythonState() const {
+    if (py::hasattr(py_component_, "__setstate__")) {
+        return py_component_.attr("__getstate__")();
+    }
+    if (py::hasattr(py_component_, "__dict__")) {
+        // py::dict would share the dict itself, cleared again on restore
+        return py_component_.attr("__dict__").attr("copy")();
+    }
+    return py::none();
+}
+
+void PythonComponentWrapper::SetPythonState(const py::object& state) {
+    try {
+        if (py::hasattr(py_component_, "__setstate__")) {
+            py_component_.attr("__setstate__")(state);
+        }
+        else if (!state.is_none()) {
+            py::object attributes = py_component_.attr("__dict__");
+            attributes.attr("clear")();
+            attributes.attr("update")(state);
         }
     }
     catch (const py::error_already_set& e) {
-        std::cerr << "Python exception in PythonComponentWrapper::Update: " << e.what() << std::endl;
+        std::cerr << "Python error while restoring a component: " << e.what() << std::endl;
     }
 }
 
+PhaseMask PythonComponentWrapper::Phases() const {
+    return python_phases_ | native_phases_;
+}
+
 py::object PythonComponentWrapper::PyComponent() const {
     return py_component_;
 }
+
+const std::vector<ComponentTypeId>& PythonComponentWrapper::TypeIds() const {
+    return *type_ids_;
+}
+
+const std::shared_ptr<Component>& PythonComponentWrapper::NativeComponent() const {
+    return native_component_;
+}
+
+UpdatePriority PythonComponentWrapper::GetUpdatePriority() const {
+    return native_component_ ? native_component_->GetUpdatePriority() : UpdatePriority::Normal;
+}
+
+void PythonComponentWrapper::SetDeltaTime(float deltaTime) {
+    if (native_component_) {
+        native_component_->SetDeltaTime(deltaTime);
+    }
+}
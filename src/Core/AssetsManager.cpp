@@ -1,6 +1,7 @@
 #include "Core/AssetsManager.hpp"
 
 std::map<std::string, std::unique_ptr<Shader>> AssetsManager::m_shaders = {};
+std::map<std::string, std::shared_ptr<Texture>> AssetsManager::m_textures = {};
 
 void AssetsManager::AddShader(std::string name, std::unique_ptr<Shader> shader) {
     m_shaders.insert({name, std::move(shader)});
@@ -12,4 +13,12 @@ Shader* AssetsManager::GetShader(const std::string& name) {
         return it->second.get();
     }
     return nullptr;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<Texture> AssetsManager::LoadTexture(const std::string& path, bool hasAlpha) {
+    std::shared_ptr<Texture>& texture = m_textures[path];
+    if (!texture) {
+        texture = std::make_shared<Texture>(path, hasAlpha);
+    }
+    return texture;
+}
@@ -0,0 +1,820 @@
+#include "Core/Benchmark.hpp"
+#include "Core/JobSystem.hpp"
+#include "World/Entity.hpp"
+#include "World/Scene.hpp"
+#include "World/SceneFile.hpp"
+#include "World/Mesh/CuboidMesh.hpp"
+#include "Graphics/FrustumCuller.hpp"
+#include "Graphics/OcclusionCuller.hpp"
+#include "Graphics/RenderQueue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // A few roots with four children per node, roughly the shape of a level hierarchy
+    std::vector<std::shared_ptr<Entity>> BuildForest(std::size_t entityCount, std::vector<Entity*>& all) {
+        std::vector<std::shared_ptr<Entity>> roots;
+        for (std::size_t i = 0; i < entityCount; ++i) {
+            if (i < 64) {
+                roots.push_back(Entity::Create());
+                all.push_back(roots.back().get());
+            }
+            else {
+                auto child = std::make_unique<Entity>();
+                all.push_back(child.get());
+                all[i / 4]->AddChild(std::move(child));
+            }
+
+            all.back()->GetTransform().SetLocalPosition({ 1.0f, 0.5f, 0.25f });
+        }
+        return roots;
+    }
+
+    void MoveAll(const std::vector<Entity*>& all, float angle) {
+        for (Entity* entity : all) {
+            entity->GetTransform().SetLocalRotation({ angle, angle * 0.5f, 0.0f });
+        }
+        Registry::DirtyTransforms().clear();
+    }
+
+    // The Euler-angle TRS the engine used before quaternions were cached, kept as the baseline
+    void LegacyUpdate(const Entity& entity, const glm::mat4& parent, std::vector<glm::mat4>& out) {
+        const Transform& transform = entity.GetTransform();
+        const glm::vec3& euler = transform.GetLocalRotation();
+        const glm::mat4 transformX = glm::rotate(glm::mat4(1.0f), glm::radians(euler.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        const glm::mat4 transformY = glm::rotate(glm::mat4(1.0f), glm::radians(euler.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 transformZ = glm::rotate(glm::mat4(1.0f), glm::radians(euler.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        const glm::mat4 local = glm::translate(glm::mat4(1.0f), transform.GetLocalPosition())
+            * transformY * transformX * transformZ * glm::scale(glm::mat4(1.0f), transform.GetLocalScale());
+
+        out.push_back(parent * local);
+        const glm::mat4 world = out.back();
+        for (const auto& child : entity.GetChildren()) {
+            LegacyUpdate(*child, world, out);
+        }
+    }
+
+    struct Projectile : Component {
+        glm::vec3 velocity { 1.0f, 0.0f, 0.0f };
+
+        std::size_t StateSize() const override {
+            return sizeof(velocity);
+        }
+
+        void SaveState(void* out) const override {
+            std::memcpy(out, &velocity, sizeof(velocity));
+        }
+
+        void LoadState(const void* in) override {
+            std::memcpy(&velocity, in, sizeof(velocity));
+        }
+    };
+
+    std::shared_ptr<Entity> SpawnProjectile(Scene& scene) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<Projectile>::Create());
+        scene.AddEntity(entity);
+        return entity;
+    }
+
+    double MatricesPerSecond(std::size_t matrices, Clock::duration elapsed) {
+        return matrices / std::chrono::duration<double>(elapsed).count();
+    }
+}
+
+int Benchmark::RunAll() {
+    JobSystem::Initialize();
+    std::cout << "[Jobs] " << JobSystem::WorkerCount() << " workers" << std::endl;
+
+    for (std::size_t count : { 1000, 10000, 100000 }) {
+        TransformPropagation(count);
+    }
+
+    for (std::size_t count : { 10000, 100000 }) {
+        SpawnDestroy(count);
+    }
+
+    for (float percent : { 1.0f, 10.0f, 100.0f }) {
+        ChangeTracking(100000, percent);
+    }
+
+    SnapshotRestore(10000);
+    SceneFileLoad(100000);
+
+    for (std::size_t count : { 10000, 100000, 1000000 }) {
+        BvhQueries(count);
+    }
+
+    for (int frames : { 1, 30 }) {
+        BvhSync(100000, frames);
+    }
+
+    FrustumCulling(100000);
+    OcclusionCulling(100000);
+    PvsCulling(4, 100);
+    RenderQueueSort(100000);
+
+    const JobSystem::Stats stats = JobSystem::GetStats();
+    std::cout << "[Jobs] " << stats.jobs << " jobs, steal rate " << stats.StealRate() * 100.0 << "%, "
+        << "worker idle " << stats.idleSeconds << " s" << std::endl;
+
+    JobSystem::Shutdown();
+    return 0;
+}
+
+void Benchmark::TransformPropagation(std::size_t entityCount) {
+    std::vector<Entity*> all;
+    std::vector<std::shared_ptr<Entity>> roots = BuildForest(entityCount, all);
+    std::vector<Entity*> changed;
+    changed.reserve(entityCount);
+
+    const int iterations = static_cast<int>(std::max<std::size_t>(4, 2000000 / entityCount));
+
+    std::vector<glm::mat4> legacyMatrices;
+    legacyMatrices.reserve(entityCount);
+
+    Clock::duration legacy = Clock::duration::zero();
+    for (int i = 0; i < iterations; ++i) {
+        MoveAll(all, static_cast<float>(i));
+        legacyMatrices.clear();
+
+        const auto start = Clock::now();
+        for (const auto& root : roots) {
+            LegacyUpdate(*root, glm::mat4(1.0f), legacyMatrices);
+        }
+        legacy += Clock::now() - start;
+    }
+
+    Clock::duration recursive = Clock::duration::zero();
+    for (int i = 0; i < iterations; ++i) {
+        MoveAll(all, static_cast<float>(i));
+        changed.clear();
+
+        const auto start = Clock::now();
+        for (const auto& root : roots) {
+            root->UpdateTransforms(changed);
+        }
+        recursive += Clock::now() - start;
+    }
+
+    const std::size_t matrices = entityCount * iterations;
+    const double legacyRate = MatricesPerSecond(matrices, legacy);
+    const double recursiveRate = MatricesPerSecond(matrices, recursive);
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[Transforms] " << entityCount << " entities: "
+        << "euler " << legacyRate / 1e6 << " M/s, "
+        << "ComputeModelMatrix " << recursiveRate / 1e6 << " M/s "
+        << "(x" << recursiveRate / legacyRate << " vs euler)" << std::endl;
+}
+
+void Benchmark::SpawnDestroy(std::size_t liveCount) {
+    Scene scene;
+    scene.Query<Projectile>();
+
+    // Oldest first, like projectiles running out of lifetime
+    std::deque<EntityHandle> alive;
+    for (std::size_t i = 0; i < liveCount; ++i) {
+        alive.push_back(SpawnProjectile(scene)->GetHandle());
+    }
+
+    // Every entity takes a Transform slot, freed with it
+    const std::size_t capacity = ComponentPool<Transform>::Capacity();
+
+    const std::size_t batch = std::max<std::size_t>(1, liveCount / 10);
+    const int iterations = 50;
+
+    const auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (std::size_t j = 0; j < batch; ++j) {
+            if (Entity* entity = Registry::Resolve(alive.front())) {
+                entity->Destroy();
+            }
+            alive.pop_front();
+            alive.push_back(SpawnProjectile(scene)->GetHandle());
+        }
+        Registry::DirtyTransforms().clear();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const bool grew = ComponentPool<Transform>::Capacity() != capacity;
+    std::cout << std::fixed << std::setprecision(2)
+        << "[Spawn/Destroy] " << liveCount << " live: "
+        << batch * iterations / seconds / 1e6 << " M destroy+spawn/s, query " << scene.Query<Projectile>().Size()
+        << ", pools " << (grew ? "grew" : "reused") << std::endl;
+}
+
+void Benchmark::ChangeTracking(std::size_t entityCount, float movingPercent) {
+    Scene scene;
+    std::vector<Entity*> all;
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        all.push_back(entity.get());
+        scene.AddEntity(std::move(entity));
+    }
+    scene.Update();
+
+    const std::size_t moving = std::max<std::size_t>(1, static_cast<std::size_t>(entityCount * movingPercent / 100.0f));
+    const std::size_t step = std::max<std::size_t>(1, entityCount / moving);
+    const int iterations = 20;
+
+    std::vector<glm::mat4> matrices(Registry::EntitySlots());
+    std::vector<EntityId> changed;
+    ChangeCursor cursor;
+    Registry::ConsumeChanges(cursor, changed);
+
+    Clock::duration tracked = Clock::duration::zero();
+    Clock::duration full = Clock::duration::zero();
+    std::size_t changedCount = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        for (std::size_t j = 0; j < entityCount; j += step) {
+            all[j]->GetTransform().SetLocalPosition({ static_cast<float>(i), 0.0f, 0.0f });
+        }
+        Registry::NextTick();
+        scene.BeginFrame();
+        scene.Update();
+
+        auto start = Clock::now();
+        changed.clear();
+        Registry::ConsumeChanges(cursor, changed);
+        for (EntityId id : changed) {
+            matrices[id] = Registry::GetEntity(id)->GetTransform().GetRenderMatrix();
+        }
+        tracked += Clock::now() - start;
+        changedCount += changed.size();
+
+        start = Clock::now();
+        for (Entity* entity : all) {
+            matrices[entity->GetId()] = entity->GetTransform().GetRenderMatrix();
+        }
+        full += Clock::now() - start;
+    }
+
+    const auto milliseconds = [iterations](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    };
+
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Changes] " << entityCount << " entities, " << std::setprecision(0) << movingPercent << "% moving: " << std::setprecision(3)
+        << changedCount / iterations << " changed per frame, extraction " << milliseconds(tracked) << " ms "
+        << "vs " << milliseconds(full) << " ms copying all" << std::endl;
+}
+
+void Benchmark::SnapshotRestore(std::size_t entityCount) {
+    Scene scene;
+    std::vector<Entity*> all;
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = SpawnProjectile(scene);
+        entity->GetTransform().SetLocalPosition({ static_cast<float>(i), 0.0f, 0.0f });
+        all.push_back(entity.get());
+    }
+    scene.Update();
+
+    const int iterations = 50;
+    const auto milliseconds = [iterations](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+    };
+
+    Clock::duration full = Clock::duration::zero();
+    std::vector<SceneSnapshot> snapshots;
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        snapshots.push_back(scene.Snapshot());
+        full += Clock::now() - start;
+    }
+    snapshots.resize(1);
+
+    // One entity in a hundred moves between two snapshots, spawned together like a squad
+    const std::size_t moving = std::max<std::size_t>(1, entityCount / 100);
+    Clock::duration delta = Clock::duration::zero();
+    for (int i = 0; i < iterations; ++i) {
+        const std::size_t first = (static_cast<std::size_t>(i) * moving) % (entityCount - moving + 1);
+        for (std::size_t j = first; j < first + moving; ++j) {
+            all[j]->GetTransform().SetLocalPosition({ 0.0f, static_cast<float>(i), 0.0f });
+        }
+        scene.Update();
+
+        const auto start = Clock::now();
+        snapshots.push_back(scene.Snapshot(&snapshots.back()));
+        delta += Clock::now() - start;
+    }
+
+    Clock::duration restore = Clock::duration::zero();
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        scene.Restore(snapshots[i % 2 == 0 ? snapshots.size() - 1 : 0]);
+        restore += Clock::now() - start;
+    }
+
+    const bool restored = all[1]->GetTransform().GetLocalPosition().x == 1.0f;
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Snapshot] " << entityCount << " entities: full " << milliseconds(full) << " ms ("
+        << snapshots[0].OwnBytes() / 1024 << " KB), delta " << milliseconds(delta) << " ms ("
+        << snapshots.back().OwnBytes() / 1024 << " KB, " << snapshots.back().SharedChunks() << "/" << snapshots.back().ChunkCount()
+        << " chunks shared), restore " << milliseconds(restore) << " ms" << (restored ? "" : " MISMATCH") << std::endl;
+}
+
+void Benchmark::SceneFileLoad(std::size_t entityCount) {
+    SceneFile::RegisterComponent<Projectile>("Projectile");
+    const std::string path = (std::filesystem::temp_directory_path() / "nora_benchmark.nscene").string();
+    const auto milliseconds = [](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    };
+
+    // Built one entity at a time, the way a Python initialize() does it (minus the interpreter)
+    Clock::duration build;
+    {
+        const auto start = Clock::now();
+        Scene scene;
+        std::vector<Entity*> all;
+        std::vector<std::shared_ptr<Entity>> roots = BuildForest(entityCount, all);
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            all[i]->AddComponent(ComponentPool<Projectile>::Create());
+            if (i % 16 == 0) {
+                all[i]->SetName("node " + std::to_string(i));
+            }
+        }
+        for (const auto& root : roots) {
+            scene.AddEntity(root);
+        }
+        build = Clock::now() - start;
+
+        scene.Save(path);
+    }
+
+    const std::uintmax_t bytes = std::filesystem::file_size(path);
+
+    // Reading the (cached) file is the floor of any loader
+    auto start = Clock::now();
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> data(bytes);
+        in.read(data.data(), static_cast<std::streamsize>(bytes));
+    }
+    const Clock::duration read = Clock::now() - start;
+
+    Scene scene;
+    start = Clock::now();
+    scene.Load(path);
+    const Clock::duration load = Clock::now() - start;
+
+    const std::size_t loaded = scene.Query<Projectile>().Size();
+    std::filesystem::remove(path);
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[SceneFile] " << loaded << " entities, " << bytes / (1024.0 * 1024.0) << " MB: load " << milliseconds(load)
+        << " ms (file read " << milliseconds(read) << " ms), built one by one " << milliseconds(build) << " ms" << std::endl;
+}
+
+void Benchmark::BvhQueries(std::size_t entityCount) {
+    Registry::RegisterType<CuboidMesh, RenderComponent>();
+
+    // Unit cubes at a constant density (one per 64 cubic units): a query finds about as many at any scale
+    const float side = std::cbrt(entityCount * 64.0f);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, side);
+
+    Scene scene;
+    std::vector<Entity*> all;
+    all.reserve(entityCount);
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<CuboidMesh>::Create());
+        entity->GetTransform().SetLocalPosition({ coordinate(random), coordinate(random), coordinate(random) });
+        all.push_back(entity.get());
+        scene.AddEntity(std::move(entity));
+    }
+    scene.Update();
+
+    auto start = Clock::now();
+    BoundingVolumeHierarchy& bvh = scene.GetBvh();
+    const Clock::duration build = Clock::now() - start;
+
+    // The scan gets the boxes for free, it only pays for visiting them
+    std::vector<Aabb> bounds;
+    bounds.reserve(entityCount);
+    for (Entity* entity : all) {
+        bounds.push_back(bvh.GetBounds(entity->GetId()));
+    }
+
+    const int queries = 1000;
+    std::vector<Aabb> boxes;
+    for (int i = 0; i < queries; ++i) {
+        const glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+        boxes.emplace_back(center - glm::vec3(4.0f), center + glm::vec3(4.0f));
+    }
+
+    std::vector<Entity*> found;
+    std::size_t treeResults = 0;
+    start = Clock::now();
+    for (const Aabb& box : boxes) {
+        found.clear();
+        bvh.Query(box, found);
+        treeResults += found.size();
+    }
+    const Clock::duration tree = Clock::now() - start;
+
+    // Fewer queries: each one walks every entity
+    const int scans = std::clamp(static_cast<int>(10000000 / entityCount), 1, queries);
+    std::size_t scanResults = 0;
+    start = Clock::now();
+    for (int i = 0; i < scans; ++i) {
+        found.clear();
+        for (std::size_t j = 0; j < entityCount; ++j) {
+            if (boxes[i].Intersects(bounds[j])) {
+                found.push_back(all[j]);
+            }
+        }
+        scanResults += found.size();
+    }
+    const Clock::duration scan = Clock::now() - start;
+
+    start = Clock::now();
+    for (const Aabb& box : boxes) {
+        found.clear();
+        bvh.Nearest(box.Center(), 8, found);
+    }
+    const Clock::duration nearest = Clock::now() - start;
+
+    // 1% of the entities wander off by a few units: their leaves grow and the ancestors are refitted
+    const int frames = 10;
+    std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+    Clock::duration sync = Clock::duration::zero();
+    for (int i = 0; i < frames; ++i) {
+        for (std::size_t j = i; j < entityCount; j += 100) {
+            Transform& transform = all[j]->GetTransform();
+            transform.SetLocalPosition(transform.GetLocalPosition() + glm::vec3(offset(random), offset(random), offset(random)));
+        }
+        Registry::NextTick();
+        scene.BeginFrame();
+        scene.Update();
+
+        start = Clock::now();
+        scene.GetBvh();
+        sync += Clock::now() - start;
+    }
+
+    const auto microseconds = [](Clock::duration elapsed, int count) {
+        return std::chrono::duration<double, std::micro>(elapsed).count() / count;
+    };
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[BVH] " << entityCount << " entities: build " << microseconds(build, 1000) << " ms, depth " << bvh.Depth()
+        << ", box query " << microseconds(tree, queries) << " us (" << treeResults / queries << " found) vs scan "
+        << microseconds(scan, scans) << " us (" << scanResults / scans << " found), 8-nearest "
+        << microseconds(nearest, queries) << " us, 1% moved: sync " << microseconds(sync, frames * 1000) << " ms, cost "
+        << bvh.Cost() << std::endl;
+}
+
+void Benchmark::BvhSync(std::size_t entityCount, int framesBetween) {
+    Registry::RegisterType<CuboidMesh, RenderComponent>();
+
+    const float side = std::cbrt(entityCount * 64.0f);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(0.0f, side);
+
+    Scene scene;
+    std::vector<Entity*> all;
+    all.reserve(entityCount);
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<CuboidMesh>::Create());
+        entity->GetTransform().SetLocalPosition({ coordinate(random), coordinate(random), coordinate(random) });
+        all.push_back(entity.get());
+        scene.AddEntity(std::move(entity));
+    }
+    scene.Update();
+
+    auto start = Clock::now();
+    const BoundingVolumeHierarchy& bvh = scene.GetBvh();
+    const Clock::duration build = Clock::now() - start;
+    const BoundingVolumeHierarchy::Stats before = bvh.GetStats();
+
+    // A different 1% wanders off by a few units each frame, as the Window's frames would tick
+    const int syncs = 10;
+    std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+    Clock::duration sync = Clock::duration::zero();
+    std::size_t frame = 0;
+    for (int i = 0; i < syncs; ++i) {
+        for (int f = 0; f < framesBetween; ++f, ++frame) {
+            Registry::NextTick();
+            for (std::size_t j = frame % 100; j < entityCount; j += 100) {
+                Transform& transform = all[j]->GetTransform();
+                transform.SetLocalPosition(transform.GetLocalPosition() + glm::vec3(offset(random), offset(random), offset(random)));
+            }
+            scene.BeginFrame();
+            scene.Update();
+        }
+
+        start = Clock::now();
+        scene.GetBvh();
+        sync += Clock::now() - start;
+    }
+
+    const BoundingVolumeHierarchy::Stats& stats = bvh.GetStats();
+    std::cout << std::fixed << std::setprecision(3)
+        << "[BVH sync] " << entityCount << " entities, queried every " << framesBetween << " frames: sync "
+        << std::chrono::duration<double, std::milli>(sync).count() / syncs << " ms vs build "
+        << std::chrono::duration<double, std::milli>(build).count() << " ms; " << stats.refits - before.refits
+        << " refits, " << stats.builds - before.builds << " builds in " << syncs << " syncs" << std::endl;
+}
+
+void Benchmark::FrustumCulling(std::size_t entityCount) {
+    Registry::RegisterType<CuboidMesh, RenderComponent>();
+
+    // Cubes all around a camera in the middle of the scene, looking down +z
+    const float side = 200.0f;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-side / 2.0f, side / 2.0f);
+
+    Scene scene;
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<CuboidMesh>::Create());
+        entity->GetTransform().SetLocalPosition({ coordinate(random), coordinate(random), coordinate(random) });
+        scene.AddEntity(std::move(entity));
+    }
+    scene.Update();
+
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum(projection * view);
+    const SceneQuery& meshes = scene.Query<RenderComponent>();
+
+    FrustumCuller culler;
+    std::vector<Entity*> visible;
+    culler.Cull(meshes, frustum, visible);
+
+    const int frames = 50;
+    auto start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        visible.clear();
+        culler.Cull(meshes, frustum, visible);
+    }
+    const Clock::duration batched = Clock::now() - start;
+
+    std::size_t naiveVisible = 0;
+    start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        naiveVisible = 0;
+        for (Entity* entity : meshes) {
+            const Aabb box = entity->GetComponent<RenderComponent>()->LocalBounds().Transformed(entity->GetTransform().GetRenderMatrix());
+            naiveVisible += frustum.Intersects(box);
+        }
+    }
+    const Clock::duration naive = Clock::now() - start;
+
+    const auto milliseconds = [frames](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count() / frames;
+    };
+
+    const FrustumCuller::Stats& stats = culler.GetStats();
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Culling] " << stats.tested << " tested, " << stats.visible << " visible, " << stats.culled << " culled: "
+        << milliseconds(batched) << " ms vs " << milliseconds(naive) << " ms per-entity boxes ("
+        << naiveVisible << " visible)" << std::endl;
+}
+
+void Benchmark::OcclusionCulling(std::size_t entityCount) {
+    Registry::RegisterType<CuboidMesh, RenderComponent>();
+
+    // The camera looks down a street (+z): two rows of building fronts on its sides and one across,
+    // with small cubes everywhere up to the far plane
+    Scene scene;
+    auto addWall = [&scene](const glm::vec3& position, const glm::vec3& scale) {
+        std::shared_ptr<Entity> wall = Entity::Create();
+        std::shared_ptr<CuboidMesh> mesh = ComponentPool<CuboidMesh>::Create();
+        mesh->SetOccluder(true);
+        wall->AddComponent(mesh);
+        wall->GetTransform().SetLocalPosition(position);
+        wall->GetTransform().SetLocalScale(scale);
+        scene.AddEntity(std::move(wall));
+    };
+    for (int i = 0; i < 8; ++i) {
+        addWall({ -6.0f, 5.0f, 10.0f + i * 12.0f }, { 1.0f, 20.0f, 10.0f });
+        addWall({ 6.0f, 5.0f, 10.0f + i * 12.0f }, { 1.0f, 20.0f, 10.0f });
+    }
+    addWall({ 0.0f, 5.0f, 60.0f }, { 14.0f, 20.0f, 1.0f });
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> across(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> height(0.0f, 10.0f);
+    std::uniform_real_distribution<float> depth(2.0f, 100.0f);
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<CuboidMesh>::Create());
+        entity->GetTransform().SetLocalPosition({ across(random), height(random), depth(random) });
+        scene.AddEntity(std::move(entity));
+    }
+    scene.Update();
+
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.7f, 0.0f), glm::vec3(0.0f, 1.7f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 viewProjection = projection * view;
+    const SceneQuery& meshes = scene.Query<RenderComponent>();
+
+    FrustumCuller frustumCuller;
+    OcclusionCuller occlusionCuller;
+    std::vector<Entity*> inFrustum;
+    std::vector<Entity*> visible;
+    frustumCuller.Cull(meshes, Frustum(viewProjection), inFrustum);
+
+    const int frames = 50;
+    auto start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        visible = inFrustum;
+        occlusionCuller.Cull(viewProjection, visible);
+    }
+    const Clock::duration occlusion = Clock::now() - start;
+
+    const auto milliseconds = [frames](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count() / frames;
+    };
+
+    const OcclusionCuller::Stats& stats = occlusionCuller.GetStats();
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Occlusion] " << inFrustum.size() << " in the frustum, " << stats.occluders << " occluders ("
+        << stats.triangles << " triangles): " << stats.occluded << " of " << stats.tested << " hidden, "
+        << visible.size() << " left to draw, " << milliseconds(occlusion) << " ms" << std::endl;
+}
+
+void Benchmark::PvsCulling(int roomsPerSide, std::size_t propsPerRoom) {
+    Registry::RegisterType<CuboidMesh, RenderComponent>();
+
+    // Rooms of 8 x 4 x 8 under one floor and ceiling, with 1 thick walls. The first row and column
+    // of rooms have doors between them, the others are closed.
+    constexpr float ROOM = 8.0f;
+    const float side = roomsPerSide * ROOM;
+    Scene scene;
+    auto addStatic = [&scene](const glm::vec3& position, const glm::vec3& scale) {
+        std::shared_ptr<Entity> entity = Entity::Create();
+        entity->AddComponent(ComponentPool<CuboidMesh>::Create());
+        entity->GetTransform().SetLocalPosition(position);
+        entity->GetTransform().SetLocalScale(scale);
+        entity->SetStatic(true);
+        scene.AddEntity(std::move(entity));
+    };
+    addStatic({ side * 0.5f, -0.5f, side * 0.5f }, { side + 1.0f, 1.0f, side + 1.0f });
+    addStatic({ side * 0.5f, 4.5f, side * 0.5f }, { side + 1.0f, 1.0f, side + 1.0f });
+    for (int line = 0; line <= roomsPerSide; ++line) {
+        for (int room = 0; room < roomsPerSide; ++room) {
+            const float low = room * ROOM;
+            const float high = low + ROOM;
+            if (line > 0 && line < roomsPerSide && room == 0) {
+                addStatic({ line * ROOM, 2.0f, low + 1.5f }, { 1.0f, 4.0f, 3.0f });
+                addStatic({ line * ROOM, 2.0f, high - 1.5f }, { 1.0f, 4.0f, 3.0f });
+                addStatic({ low + 1.5f, 2.0f, line * ROOM }, { 3.0f, 4.0f, 1.0f });
+                addStatic({ high - 1.5f, 2.0f, line * ROOM }, { 3.0f, 4.0f, 1.0f });
+            } else {
+                addStatic({ line * ROOM, 2.0f, (low + high) * 0.5f }, { 1.0f, 4.0f, ROOM });
+                addStatic({ (low + high) * 0.5f, 2.0f, line * ROOM }, { ROOM, 4.0f, 1.0f });
+            }
+        }
+    }
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> inside(1.0f, ROOM - 1.0f);
+    std::uniform_real_distribution<float> height(0.5f, 3.5f);
+    for (int x = 0; x < roomsPerSide; ++x) {
+        for (int z = 0; z < roomsPerSide; ++z) {
+            for (std::size_t i = 0; i < propsPerRoom; ++i) {
+                addStatic({ x * ROOM + inside(random), height(random), z * ROOM + inside(random) }, glm::vec3(0.3f));
+            }
+        }
+    }
+    scene.Update();
+
+    PotentiallyVisibleSet::Settings settings;
+    settings.cellSize = 2.0f;
+    settings.voxelsPerCell = 4;
+    const PotentiallyVisibleSet& pvs = scene.BakePvs(settings);
+    const PotentiallyVisibleSet::Stats& baked = pvs.GetStats();
+
+    // Standing in the corner room, looking across the level
+    const glm::vec3 eye(2.0f, 1.7f, 2.0f);
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum(projection * view);
+    const SceneQuery& meshes = scene.Query<RenderComponent>();
+
+    FrustumCuller culler;
+    std::vector<Entity*> visible;
+    const int frames = 200;
+    auto start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        visible.clear();
+        culler.Cull(meshes, frustum, visible);
+    }
+    const Clock::duration frustumOnly = Clock::now() - start;
+    const std::size_t frustumVisible = visible.size();
+
+    PotentiallyVisibleSet& lookup = *scene.GetPvs();
+    start = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        visible.clear();
+        lookup.SetViewpoint(eye);
+        culler.Cull(meshes, frustum, visible, &lookup);
+    }
+    const Clock::duration withPvs = Clock::now() - start;
+
+    const auto microseconds = [frames](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::micro>(elapsed).count() / frames;
+    };
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[PVS] " << meshes.Size() << " static meshes, " << baked.cells << " cells: bake " << baked.bakeSeconds << " s, "
+        << baked.bytes << " bytes; culling " << microseconds(frustumOnly) << " us (" << frustumVisible << " drawn) -> "
+        << microseconds(withPvs) << " us (" << visible.size() << " drawn, " << culler.GetStats().hidden << " hidden by the PVS)"
+        << std::endl;
+}
+
+void Benchmark::RenderQueueSort(std::size_t packetCount) {
+    // Scene order: 32 textures over 8 vertex arrays, spread at random like the meshes of a level.
+    // A single (null) shader, as the built-in meshes share one; nothing is submitted.
+    std::mt19937 random(11);
+    std::uniform_int_distribution<unsigned int> texture(1, 32), vertexArray(1, 8);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+
+    std::vector<RenderQueue::Packet> packets(packetCount);
+    std::vector<glm::vec3> positions(packetCount);
+    for (std::size_t i = 0; i < packetCount; ++i) {
+        packets[i].texture = texture(random);
+        packets[i].vertexArray = vertexArray(random);
+        packets[i].count = 36;
+        packets[i].instance = static_cast<int>(i);
+        positions[i] = { coordinate(random), coordinate(random), coordinate(random) };
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    RenderQueue queue;
+    const int frames = 20;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        queue.Begin(view, projection, 100.0f);
+        for (std::size_t i = 0; i < packetCount; ++i) {
+            queue.Push(RenderQueue::Pass::Opaque, packets[i], positions[i]);
+        }
+        queue.Sort();
+    }
+    const Clock::duration radix = Clock::now() - start;
+
+    // The same order through a comparison sort of the packets themselves
+    struct Draw {
+        unsigned int texture;
+        unsigned int vertexArray;
+        float depth;
+    };
+    std::vector<Draw> draws(packetCount);
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (std::size_t i = 0; i < packetCount; ++i) {
+            draws[i] = { packets[i].texture, packets[i].vertexArray, -(view * glm::vec4(positions[i], 1.0f)).z };
+        }
+        std::sort(draws.begin(), draws.end(), [](const Draw& a, const Draw& b) {
+            if (a.texture != b.texture) {
+                return a.texture < b.texture;
+            }
+            if (a.vertexArray != b.vertexArray) {
+                return a.vertexArray < b.vertexArray;
+            }
+            return a.depth < b.depth;
+        });
+    }
+    const Clock::duration comparison = Clock::now() - start;
+
+    // Binds Submit would make, each draw against the previous one
+    const auto changes = [packetCount](auto&& packet) {
+        std::size_t textures = 0;
+        std::size_t vertexArrays = 0;
+        for (std::size_t i = 0; i < packetCount; ++i) {
+            textures += i == 0 || packet(i).texture != packet(i - 1).texture;
+            vertexArrays += i == 0 || packet(i).vertexArray != packet(i - 1).vertexArray;
+        }
+        return std::make_pair(textures, vertexArrays);
+    };
+    const auto unsorted = changes([&packets](std::size_t i) -> const RenderQueue::Packet& { return packets[i]; });
+    const auto sorted = changes([&queue](std::size_t i) -> const RenderQueue::Packet& { return queue.Sorted(i); });
+
+    const auto milliseconds = [frames](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::milli>(elapsed).count() / frames;
+    };
+
+    std::cout << std::fixed << std::setprecision(3)
+        << "[RenderQueue] " << packetCount << " packets: push + radix sort " << milliseconds(radix) << " ms vs std::sort "
+        << milliseconds(comparison) << " ms; texture / vertex array binds " << unsorted.first << " / " << unsorted.second
+        << " in scene order -> " << sorted.first << " / " << sorted.second << " sorted" << std::endl;
+}
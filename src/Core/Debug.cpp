@@ -4,12 +4,16 @@
 #include <iomanip>
 #include <ctime>
 #include <sstream>
+#include <mutex>
 
 const char* Debug::COLOR_RESET = "\033[0m";
 const char* Debug::COLOR_INFO = "\033[36m"; // Cyan
 const char* Debug::COLOR_WARNING = "\033[33m"; // Yellow
 const char* Debug::COLOR_ERROR = "\033[31m"; // Red
 
+// Native updates run on the JobSystem workers and may report concurrently
+static std::mutex s_outputMutex;
+
 std::string Debug::GetTimestamp() {
     auto now = std::chrono::system_clock::now();
     std::time_t now_c = std::chrono::system_clock::to_time_t(now);
@@ -21,6 +25,7 @@ std::string Debug::GetTimestamp() {
 }
 
 void Debug::Info(const std::string& message) {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
     std::cout 
         << COLOR_INFO
         << "[" << GetTimestamp() << "] [INFO] " << message 
@@ -28,6 +33,7 @@ void Debug::Info(const std::string& message) {
 }
 
 void Debug::Warning(const std::string& message) {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
     std::cout 
         << COLOR_WARNING
         << "[" << GetTimestamp() << "] [WARNING] " << message 
@@ -35,6 +41,7 @@ void Debug::Warning(const std::string& message) {
 }
 
 void Debug::Error(const std::string& message) {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
     std::cerr 
         << COLOR_ERROR
         << "[" << GetTimestamp() << "] [ERROR] " << message 
@@ -0,0 +1,28 @@
+#include "Core/EventBus.hpp"
+
+void EventBus::Register(EventChannelBase& channel) {
+    if (std::find(s_channels.begin(), s_channels.end(), &channel) == s_channels.end()) {
+        s_channels.push_back(&channel);
+    }
+}
+
+void EventBus::Unsubscribe(SubscriptionId id) {
+    for (EventChannelBase* channel : s_channels) {
+        if (channel->Unsubscribe(id)) {
+            return;
+        }
+    }
+}
+
+void EventBus::Dispatch() {
+    // By index: a subscriber may subscribe to a new type while being called
+    for (std::size_t i = 0; i < s_channels.size(); ++i) {
+        s_channels[i]->Flush();
+    }
+}
+
+void EventBus::Clear() {
+    for (EventChannelBase* channel : s_channels) {
+        channel->Clear();
+    }
+}
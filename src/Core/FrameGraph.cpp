@@ -0,0 +1,236 @@
+#include "Core/FrameGraph.hpp"
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    float Milliseconds(Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration<float, std::milli>(end - begin).count();
+    }
+
+    void AddUnique(std::vector<FrameNodeId>& ids, FrameNodeId id) {
+        if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids.push_back(id);
+        }
+    }
+}
+
+FrameNodeId FrameGraph::AddNode(const std::string& name, std::function<void()> function,
+                                const std::vector<std::string>& reads, const std::vector<std::string>& writes,
+                                FrameAffinity affinity) {
+    if (Find(name) != INVALID_NODE) {
+        throw std::runtime_error("Frame graph node '" + name + "' already exists");
+    }
+
+    Node node;
+    node.name = name;
+    node.function = std::move(function);
+    node.affinity = affinity;
+    for (const std::string& resource : reads) {
+        node.reads.push_back(Resource(resource));
+    }
+    for (const std::string& resource : writes) {
+        node.writes.push_back(Resource(resource));
+    }
+
+    m_nodes.push_back(std::move(node));
+    m_dirty = true;
+    return static_cast<FrameNodeId>(m_nodes.size() - 1);
+}
+
+FrameNodeId FrameGraph::Find(const std::string& name) const {
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].name == name) {
+            return static_cast<FrameNodeId>(i);
+        }
+    }
+    return INVALID_NODE;
+}
+
+void FrameGraph::AddDependency(FrameNodeId node, FrameNodeId dependency) {
+    if (node >= m_nodes.size() || dependency >= m_nodes.size() || node == dependency) {
+        return;
+    }
+
+    // Only backward edges, so the graph stays acyclic
+    if (dependency > node) {
+        throw std::runtime_error("Frame graph node '" + m_nodes[node].name + "' can't wait for the later node '" + m_nodes[dependency].name + "'");
+    }
+
+    AddUnique(m_nodes[node].explicitDependencies, dependency);
+    m_dirty = true;
+}
+
+void FrameGraph::Clear() {
+    m_nodes.clear();
+    m_resources.clear();
+    m_workerLevels.clear();
+    m_mainLevels.clear();
+    m_criticalPath.clear();
+    m_frameTime = 0.0f;
+    m_criticalPathTime = 0.0f;
+    m_dirty = true;
+}
+
+const std::string& FrameGraph::Name(FrameNodeId node) const {
+    return m_nodes.at(node).name;
+}
+
+const std::vector<FrameNodeId>& FrameGraph::Dependencies(FrameNodeId node) {
+    if (m_dirty) {
+        Build();
+    }
+    return m_nodes.at(node).dependencies;
+}
+
+float FrameGraph::NodeTime(FrameNodeId node) const {
+    return m_nodes.at(node).time;
+}
+
+std::uint32_t FrameGraph::Resource(const std::string& name) {
+    auto it = m_resources.find(name);
+    if (it != m_resources.end()) {
+        return it->second;
+    }
+
+    const std::uint32_t id = static_cast<std::uint32_t>(m_resources.size());
+    m_resources.emplace(name, id);
+    return id;
+}
+
+void FrameGraph::Build() {
+    const std::size_t resourceCount = m_resources.size();
+    std::vector<FrameNodeId> lastWriter(resourceCount, INVALID_NODE);
+    std::vector<std::vector<FrameNodeId>> readers(resourceCount);
+
+    m_workerLevels.clear();
+    m_mainLevels.clear();
+
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        Node& node = m_nodes[i];
+        const FrameNodeId id = static_cast<FrameNodeId>(i);
+        node.dependencies = node.explicitDependencies;
+
+        // Read after write
+        for (std::uint32_t resource : node.reads) {
+            if (lastWriter[resource] != INVALID_NODE) {
+                AddUnique(node.dependencies, lastWriter[resource]);
+            }
+        }
+
+        // Write after write and write after read
+        for (std::uint32_t resource : node.writes) {
+            if (lastWriter[resource] != INVALID_NODE) {
+                AddUnique(node.dependencies, lastWriter[resource]);
+            }
+            for (FrameNodeId reader : readers[resource]) {
+                if (reader != id) {
+                    AddUnique(node.dependencies, reader);
+                }
+            }
+        }
+
+        for (std::uint32_t resource : node.reads) {
+            readers[resource].push_back(id);
+        }
+        for (std::uint32_t resource : node.writes) {
+            lastWriter[resource] = id;
+            readers[resource].clear();
+        }
+
+        // Dependencies are earlier nodes, their level is known
+        node.level = 0;
+        for (FrameNodeId dependency : node.dependencies) {
+            node.level = std::max(node.level, m_nodes[dependency].level + 1);
+        }
+
+        if (node.level >= m_mainLevels.size()) {
+            m_mainLevels.resize(node.level + 1);
+            m_workerLevels.resize(node.level + 1);
+        }
+        (node.affinity == FrameAffinity::Worker ? m_workerLevels : m_mainLevels)[node.level].push_back(id);
+    }
+
+    m_dirty = false;
+}
+
+void FrameGraph::Run() {
+    if (m_dirty) {
+        Build();
+    }
+
+    const Clock::time_point frameBegin = Clock::now();
+
+    for (std::size_t level = 0; level < m_mainLevels.size(); ++level) {
+        const std::vector<FrameNodeId>& workers = m_workerLevels[level];
+        const std::function<void(std::size_t, std::size_t)> runWorkers = [this, &workers](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                Node& node = m_nodes[workers[i]];
+                const Clock::time_point start = Clock::now();
+                node.function();
+                node.time = Milliseconds(start, Clock::now());
+            }
+        };
+
+        // The worker nodes are queued first so they overlap the main thread ones
+        JobSystem::Group group;
+        JobSystem::Start(group, workers.size(), 1, runWorkers);
+
+        try {
+            for (FrameNodeId id : m_mainLevels[level]) {
+                Node& node = m_nodes[id];
+                const Clock::time_point start = Clock::now();
+                node.function();
+                node.time = Milliseconds(start, Clock::now());
+            }
+        }
+        catch (...) {
+            // The queued jobs still point at `runWorkers`
+            JobSystem::Wait(group);
+            throw;
+        }
+
+        JobSystem::Wait(group);
+    }
+
+    m_frameTime = Milliseconds(frameBegin, Clock::now());
+    ComputeCriticalPath();
+}
+
+void FrameGraph::ComputeCriticalPath() {
+    m_criticalPath.clear();
+    m_criticalPathTime = 0.0f;
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // Nodes come after their dependencies, one pass in declaration order is enough
+    std::vector<float> finish(m_nodes.size(), 0.0f);
+    std::vector<FrameNodeId> previous(m_nodes.size(), INVALID_NODE);
+    FrameNodeId last = 0;
+
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        float start = 0.0f;
+        for (FrameNodeId dependency : m_nodes[i].dependencies) {
+            if (previous[i] == INVALID_NODE || finish[dependency] > start) {
+                start = finish[dependency];
+                previous[i] = dependency;
+            }
+        }
+        finish[i] = start + m_nodes[i].time;
+
+        if (finish[i] > finish[last]) {
+            last = static_cast<FrameNodeId>(i);
+        }
+    }
+
+    m_criticalPathTime = finish[last];
+    for (FrameNodeId id = last; id != INVALID_NODE; id = previous[id]) {
+        m_criticalPath.push_back(id);
+    }
+    std::reverse(m_criticalPath.begin(), m_criticalPath.end());
+}
@@ -1,4 +1,6 @@
 #include "Core/Input.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/Events.hpp"
 #include <GLFW/glfw3.h>
 
 void Input::Init() {
@@ -22,6 +24,8 @@ void Input::KeyCallback(GLFWwindow* window, int key, int scancode, int action, i
         s_justReleased[key] = true;
     }
     s_keys[key] = action != GLFW_RELEASE;
+
+    EventBus::Publish(KeyEvent{ static_cast<Key>(key), action != GLFW_RELEASE, action == GLFW_REPEAT });
 }
 
 void Input::MouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
@@ -32,6 +36,8 @@ void Input::MouseButtonCallback(GLFWwindow* window, int button, int action, int
         s_mouseJustReleased[button] = true;
     }
     s_mouseButtons[button] = action != GLFW_RELEASE;
+
+    EventBus::Publish(MouseButtonEvent{ static_cast<MouseCode>(button), action != GLFW_RELEASE });
 }
 
 void Input::CursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
@@ -0,0 +1,194 @@
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+void JobSystem::Initialize(unsigned workerCount) {
+    if (s_running) {
+        return;
+    }
+
+    if (workerCount == 0) {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    t_queueIndex = static_cast<int>(workerCount);
+
+    s_queues.clear();
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        s_queues.push_back(std::make_unique<Queue>());
+    }
+
+    s_running = true;
+    for (unsigned i = 0; i < workerCount; ++i) {
+        s_workers.emplace_back(&JobSystem::WorkerLoop, i);
+    }
+}
+
+void JobSystem::Shutdown() {
+    if (!s_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_running = false;
+    }
+    s_wake.notify_all();
+
+    for (auto& worker : s_workers) {
+        worker.join();
+    }
+    s_workers.clear();
+    s_queues.clear();
+    t_queueIndex = -1;
+}
+
+unsigned JobSystem::WorkerCount() {
+    return static_cast<unsigned>(s_workers.size());
+}
+
+void JobSystem::ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function) {
+    Group group;
+    Start(group, count, grain, function);
+    Wait(group);
+}
+
+void JobSystem::Start(Group& group, std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function) {
+    if (count == 0) {
+        return;
+    }
+
+    grain = std::max<std::size_t>(1, grain);
+    if (s_workers.empty() || count <= grain || t_queueIndex < 0) {
+        function(0, count);
+        return;
+    }
+
+    Task& task = group.task;
+    task.function = &function;
+    task.remaining = (count + grain - 1) / grain;
+
+    // Queue everything on our own deque, idle workers steal from the front.
+    // The pending count is raised first so it never drops below the number of queued jobs.
+    {
+        std::lock_guard<std::mutex> lock(s_wakeMutex);
+        s_pending += task.remaining;
+    }
+
+    Queue& own = *s_queues[t_queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            own.jobs.push_back({ &task, begin, std::min(begin + grain, count) });
+        }
+    }
+    s_wake.notify_all();
+}
+
+void JobSystem::Wait(Group& group) {
+    Task& task = group.task;
+
+    // Help until every chunk is done, this also runs jobs of nested ParallelFor calls
+    Job job;
+    while (task.remaining.load(std::memory_order_acquire) > 0) {
+        if (PopOrSteal(static_cast<unsigned>(t_queueIndex), job)) {
+            Execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    if (task.error) {
+        std::rethrow_exception(task.error);
+    }
+}
+
+bool JobSystem::PopOrSteal(unsigned index, Job& job) {
+    {
+        Queue& own = *s_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            s_pending--;
+            return true;
+        }
+    }
+
+    const unsigned queueCount = static_cast<unsigned>(s_queues.size());
+    for (unsigned offset = 1; offset < queueCount; ++offset) {
+        Queue& victim = *s_queues[(index + offset) % queueCount];
+        s_stealAttempts.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            s_pending--;
+            s_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(const Job& job) {
+    try {
+        (*job.task->function)(job.begin, job.end);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(job.task->errorMutex);
+        if (!job.task->error) {
+            job.task->error = std::current_exception();
+        }
+    }
+
+    s_jobs.fetch_add(1, std::memory_order_relaxed);
+    job.task->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::WorkerLoop(unsigned index) {
+    t_queueIndex = static_cast<int>(index);
+
+    Job job;
+    while (true) {
+        if (PopOrSteal(index, job)) {
+            Execute(job);
+            continue;
+        }
+
+        const auto idleStart = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(s_wakeMutex);
+            s_wake.wait(lock, [] { return !s_running || s_pending > 0; });
+        }
+        s_idleNanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idleStart).count(),
+            std::memory_order_relaxed
+        );
+
+        if (!s_running) {
+            return;
+        }
+    }
+}
+
+JobSystem::Stats JobSystem::GetStats() {
+    Stats stats;
+    stats.jobs = s_jobs.load();
+    stats.steals = s_steals.load();
+    stats.stealAttempts = s_stealAttempts.load();
+    stats.idleSeconds = static_cast<double>(s_idleNanoseconds.load()) * 1e-9;
+    return stats;
+}
+
+void JobSystem::ResetStats() {
+    s_jobs = 0;
+    s_steals = 0;
+    s_stealAttempts = 0;
+    s_idleNanoseconds = 0;
+}
@@ -1,4 +1,8 @@
 #include "Core/Time.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/Events.hpp"
+
+#include <algorithm>
 
 double Time::lastTime = 0.0;
 double Time::fpsLastTime = 0.0;
@@ -6,6 +10,10 @@ float Time::fps = 0.0f;
 float Time::deltaTime = 1.0f / 60.0f;
 int Time::frameCount = 0;
 
+float Time::fixedDeltaTime = 1.0f / 60.0f;
+int Time::maxFixedSteps = 5;
+float Time::accumulator = 0.0f;
+
 void Time::UpdateDeltaTime(double currentTime) {
     deltaTime = static_cast<float>(currentTime - lastTime);
     lastTime = currentTime;
@@ -17,6 +25,7 @@ void Time::CalculateFPS(double currentTime) {
         fps = static_cast<float>(frameCount);
         frameCount = 0;
         fpsLastTime += 1.0;
+        EventBus::Publish(FrameRateEvent{ fps });
     }
 }
 
@@ -27,3 +36,33 @@ float Time::DeltaTime() {
 float Time::FPS() {
     return fps;
 }
+
+void Time::SetFixedDeltaTime(float newFixedDeltaTime) {
+    if (newFixedDeltaTime > 0.0f) {
+        fixedDeltaTime = newFixedDeltaTime;
+    }
+}
+
+float Time::FixedDeltaTime() {
+    return fixedDeltaTime;
+}
+
+void Time::SetMaxFixedSteps(int newMaxFixedSteps) {
+    maxFixedSteps = newMaxFixedSteps > 1 ? newMaxFixedSteps : 1;
+}
+
+int Time::MaxFixedSteps() {
+    return maxFixedSteps;
+}
+
+int Time::ConsumeFixedSteps() {
+    accumulator = std::min(accumulator + deltaTime, fixedDeltaTime * maxFixedSteps);
+
+    const int steps = static_cast<int>(accumulator / fixedDeltaTime);
+    accumulator -= steps * fixedDeltaTime;
+    return steps;
+}
+
+float Time::InterpolationAlpha() {
+    return std::clamp(accumulator / fixedDeltaTime, 0.0f, 1.0f);
+}
@@ -1,6 +1,9 @@
 #include "Core/Window.hpp"
 #include "Core/Time.hpp"
 #include "Core/AssetsManager.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/Events.hpp"
 #include "World/Camera.hpp"
 #include "World/Entity.hpp"
 #include "World/Mesh/RenderComponent.hpp"
@@ -16,6 +19,8 @@ Window& Window::GetInstance() {
 }
 
 Window::Window() {
+    BuildFrameGraph();
+
     try {
         py::module_ sys = py::module_::import("sys");
         sys.attr("path").cast<py::list>().insert(0, py::str("../"));
@@ -86,16 +91,26 @@ void Window::ProcessInput() {
 }
 
 void Window::Update() {
+    m_scene.BeginFrame();
+
+    const int steps = Time::ConsumeFixedSteps();
+    for (int i = 0; i < steps; ++i) {
+        m_scene.FixedUpdate();
+    }
+
     m_scene.Update();
+    m_scene.LateUpdate();
 }
 
 void Window::Render() {
     glClearColor(BackgroundColor.r, BackgroundColor.g, BackgroundColor.b, BackgroundColor.alpha);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    std::vector<Entity*> cameraEntities = m_scene.GetEntitiesWithComponent<Camera>();
-    if (!cameraEntities.empty()) {
-        Camera* camera = cameraEntities[0]->GetComponent<Camera>();
+    m_scene.InterpolateTransforms(Time::InterpolationAlpha());
+
+    Camera* camera = m_scene.GetActiveCamera();
+
+    if (camera) {
         
         // pass projection matrix to shader (note that in this case it could change every frame)
         glm::mat4 projection = glm::perspective(glm::radians(camera->GetZoom()), (float)m_width / (float)m_height, 0.1f, 100.0f);
@@ -103,13 +118,37 @@ void Window::Render() {
         // camera/view transformation
         glm::mat4 view = camera->GetViewMatrix();
 
-        // render meshes
-        std::vector<Entity*> meshedEntities = m_scene.GetEntitiesWithComponent<RenderComponent>();
-        for (auto entity : meshedEntities) {
+        // Per frame state of the mesh shaders, the components only set their instance
+        m_transforms.Update();
+        m_transforms.Bind();
+        for (const char* name : { "mesh", "3d_model" }) {
+            Shader* shader = AssetsManager::GetShader(name);
+            shader->Use();
+            shader->SetMat4("projection", projection);
+            shader->SetMat4("view", view);
+            shader->SetInt("models", TransformBuffer::TEXTURE_UNIT);
+        }
+
+        // render meshes, the ones outside the view left out before any draw: first the static ones
+        // the PVS says can't be seen from the camera's cell, when the level has one
+        PotentiallyVisibleSet* pvs = m_scene.GetPvs();
+        if (pvs && !pvs->SetViewpoint(camera->GetOwner()->GetTransform().GetRenderMatrix()[3])) {
+            pvs = nullptr;
+        }
+        m_visible.clear();
+        m_culler.Cull(m_scene.Query<RenderComponent>(), Frustum(projection * view), m_visible, pvs);
+        m_occlusion.Cull(projection * view, m_visible);
+
+        // then the draws of what is left, ordered so the ones sharing a program, texture and vertex
+        // array follow each other
+        m_queue.Begin(view, projection, 100.0f);
+        for (Entity* entity : m_visible) {
             RenderComponent* mesh = entity->GetComponent<RenderComponent>();
             Shader* shader = AssetsManager::GetShader(mesh->ShaderType());
-            mesh->Render(*shader, view, projection);
+            mesh->Enqueue(m_queue, *shader);
         }
+        m_queue.Sort();
+        m_queue.Submit();
 
         // render gui
         glm::mat4 ortho_projection = glm::ortho(0.0f, static_cast<float>(m_width), 0.0f, static_cast<float>(m_height));
@@ -117,8 +156,11 @@ void Window::Render() {
         guiShader->Use();
         guiShader->SetMat4("projection", ortho_projection);
 
-        std::vector<Entity*> guiEntities = m_scene.GetEntitiesWithComponent<GuiComponent>();
-        for (auto entity : guiEntities) {
+        for (Entity* entity : m_scene.Query<GuiComponent>()) {
+            if (!entity->IsActive()) {
+                continue;
+            }
+
             GuiComponent* gui = entity->GetComponent<GuiComponent>();
             Shader* shader = AssetsManager::GetShader(gui->ShaderType());
             gui->Render(*shader);
@@ -126,7 +168,43 @@ void Window::Render() {
     }
 }
 
+void Window::BuildFrameGraph() {
+    // The frame as it always ran, main thread nodes keep this order. Input::EndFrame is the only
+    // one free to run on a worker, next to Render.
+    m_frameGraph.AddNode("time", [] {
+        float currentTime = glfwGetTime();
+        Time::UpdateDeltaTime(currentTime);
+        Time::CalculateFPS(currentTime);
+    }, {}, { "time", "events" });
+
+    m_frameGraph.AddNode("input", [this] { ProcessInput(); }, { "input" }, { "window" });
+
+    // Sync point: nothing iterates the scene here, so the entities and components created or
+    // removed (from any thread) during the previous frame are applied in one go, in the frame's
+    // change tracking tick
+    m_frameGraph.AddNode("commands", [this] {
+        Registry::NextTick();
+        m_commands.Playback(m_scene);
+        Registry::CompactScripts();
+    }, {}, { "scene", "events" });
+
+    // Events of the previous frame (input, resize, spawned entities...) delivered in batches
+    m_frameGraph.AddNode("events", [] { EventBus::Dispatch(); }, {}, { "events", "scene" });
+
+    m_frameGraph.AddNode("update", [this] { Update(); }, { "time", "input" }, { "scene", "events" });
+    m_frameGraph.AddNode("render", [this] { Render(); }, { "time", "window" }, { "scene", "gpu" });
+    m_frameGraph.AddNode("end_frame", [] { Input::EndFrame(); }, {}, { "input" }, FrameAffinity::Worker);
+    m_frameGraph.AddNode("present", [this] { glfwSwapBuffers(m_window); }, {}, { "gpu", "window" });
+
+    // Callbacks write the input, resize the window and publish events
+    m_frameGraph.AddNode("poll", [] { glfwPollEvents(); }, {}, { "input", "window", "gpu", "events" });
+}
+
 void Window::Shutdown() {
+    JobSystem::Shutdown();
+    m_transforms.Release();
+    m_scene = Scene(); // Destroys the entities while Python can still run their on_destroy
+    EventBus::Clear(); // Python subscribers must go before the interpreter
     m_game = std::make_unique<py::object>(); // Reset to null object
 }
 
@@ -138,6 +216,7 @@ void Window::Run() {
     glfwSwapInterval(0);
     glEnable(GL_DEPTH_TEST);
     Setup();
+    JobSystem::Initialize();
 
     try {
         py::object initialize = m_game->attr("initialize")();
@@ -149,17 +228,7 @@ void Window::Run() {
     m_scene.Start();
     
     while (!glfwWindowShouldClose(m_window)) {
-        float currentTime = glfwGetTime();
-        Time::UpdateDeltaTime(currentTime);
-        Time::CalculateFPS(currentTime);
-
-        ProcessInput();
-        Update();
-        Render();
-
-        Input::EndFrame();
-        glfwSwapBuffers(m_window);
-        glfwPollEvents();
+        m_frameGraph.Run();
     }
 
     Shutdown();
@@ -176,6 +245,8 @@ void Window::OnResize(int width, int height) {
     glViewport(0, 0, width, height);
     m_width = width;
     m_height = height;
+
+    EventBus::Publish(WindowResizeEvent{ width, height });
 }
 
 void Window::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -221,6 +292,22 @@ void Window::SetSize(int width, int height) {
     }
 }
 
+FrameGraph& Window::GetFrameGraph() {
+    return m_frameGraph;
+}
+
+const FrustumCuller::Stats& Window::GetCullStats() const {
+    return m_culler.GetStats();
+}
+
+const OcclusionCuller::Stats& Window::GetOcclusionStats() const {
+    return m_occlusion.GetStats();
+}
+
+const RenderQueue::Stats& Window::GetRenderStats() const {
+    return m_queue.GetStats();
+}
+
 Scene& Window::GetScene() {
     return m_scene;
 }
@@ -229,6 +316,10 @@ void Window::SetScene(const Scene& scene) {
     m_scene = scene;
 }
 
+EntityCommandBuffer& Window::GetCommands() {
+    return m_commands;
+}
+
 FT_Library Window::FT() {
     return m_ft;
 }
@@ -0,0 +1,183 @@
+#include "Graphics/FrustumCuller.hpp"
+#include "Core/Simd.hpp"
+#include "World/Entity.hpp"
+#include "World/SceneQuery.hpp"
+#include "World/PotentiallyVisibleSet.hpp"
+#include "World/Mesh/RenderComponent.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void FrustumCuller::Cull(const SceneQuery& candidates, const Frustum& frustum, std::vector<Entity*>& visible,
+    const PotentiallyVisibleSet* pvs) {
+    UpdateBounds(candidates);
+    m_stats.hidden = 0;
+
+    m_entities.clear();
+    for (std::vector<float>* column : { &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ, &m_radius }) {
+        column->clear();
+    }
+
+    for (Entity* entity : candidates) {
+        if (!entity->IsActive()) {
+            continue;
+        }
+        if (pvs && !pvs->IsVisible(entity->GetId())) {
+            ++m_stats.hidden;
+            continue;
+        }
+
+        const WorldBounds& bounds = m_bounds[entity->GetId()];
+        m_entities.push_back(entity);
+        m_centerX.push_back(bounds.center.x);
+        m_centerY.push_back(bounds.center.y);
+        m_centerZ.push_back(bounds.center.z);
+        m_extentX.push_back(bounds.extents.x);
+        m_extentY.push_back(bounds.extents.y);
+        m_extentZ.push_back(bounds.extents.z);
+        m_radius.push_back(bounds.radius);
+    }
+
+    // Whole batches only, the padding lanes are never reported
+    const std::size_t padded = (m_entities.size() + 3) & ~std::size_t(3);
+    for (std::vector<float>* column : { &m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ, &m_radius }) {
+        column->resize(padded, 0.0f);
+    }
+
+    const std::size_t before = visible.size();
+    Test(frustum, visible);
+
+    m_stats.tested = m_entities.size();
+    m_stats.visible = visible.size() - before;
+    m_stats.culled = m_stats.tested - m_stats.visible;
+}
+
+void FrustumCuller::UpdateBounds(const SceneQuery& candidates) {
+    if (Registry::EntitySlots() > m_bounds.size()) {
+        m_bounds.resize(Registry::EntitySlots());
+    }
+
+    // First frame or history lost: every candidate
+    m_changed.clear();
+    if (!Registry::ConsumeChanges(m_changes, m_changed)) {
+        for (Entity* entity : candidates) {
+            ComputeBounds(*entity);
+        }
+        return;
+    }
+
+    for (EntityId id : m_changed) {
+        Entity* entity = Registry::GetEntity(id);
+        if (entity->GetComponent<RenderComponent>()) {
+            ComputeBounds(*entity);
+        }
+    }
+}
+
+void FrustumCuller::ComputeBounds(const Entity& entity) {
+    const RenderComponent* mesh = entity.GetComponent<RenderComponent>();
+    const Aabb box = mesh->LocalBounds().Transformed(entity.GetTransform().GetRenderMatrix());
+    WorldBounds& bounds = m_bounds[entity.GetId()];
+
+    // Unknown extent (e.g. a Model not loaded yet): never culled
+    if (box.IsEmpty()) {
+        bounds.center = glm::vec3(0.0f);
+        bounds.extents = glm::vec3(std::numeric_limits<float>::max());
+        bounds.radius = std::numeric_limits<float>::max();
+        return;
+    }
+
+    bounds.center = box.Center();
+    bounds.extents = box.Extents();
+    bounds.radius = glm::length(bounds.extents);
+}
+
+void FrustumCuller::Test(const Frustum& frustum, std::vector<Entity*>& visible) {
+    const std::size_t count = m_entities.size();
+
+#if NORA_SIMD_SSE
+    __m128 normalX[6], normalY[6], normalZ[6], offset[6];
+    __m128 absX[6], absY[6], absZ[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        normalX[p] = _mm_set1_ps(plane.x);
+        normalY[p] = _mm_set1_ps(plane.y);
+        normalZ[p] = _mm_set1_ps(plane.z);
+        offset[p] = _mm_set1_ps(plane.w);
+        absX[p] = _mm_set1_ps(std::abs(plane.x));
+        absY[p] = _mm_set1_ps(std::abs(plane.y));
+        absZ[p] = _mm_set1_ps(std::abs(plane.z));
+    }
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 allSet = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+    for (std::size_t i = 0; i < count; i += 4) {
+        const __m128 centerX = _mm_loadu_ps(&m_centerX[i]);
+        const __m128 centerY = _mm_loadu_ps(&m_centerY[i]);
+        const __m128 centerZ = _mm_loadu_ps(&m_centerZ[i]);
+        const __m128 radius = _mm_loadu_ps(&m_radius[i]);
+        const __m128 negativeRadius = _mm_xor_ps(radius, signBit);
+
+        // Spheres: outside one plane, or inside all of them
+        __m128 distances[6];
+        __m128 outside = _mm_setzero_ps();
+        __m128 inside = allSet;
+        for (int p = 0; p < 6; ++p) {
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerX, normalX[p]), _mm_mul_ps(centerY, normalY[p])),
+                _mm_add_ps(_mm_mul_ps(centerZ, normalZ[p]), offset[p]));
+            distances[p] = distance;
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, radius));
+        }
+
+        int culled = _mm_movemask_ps(outside);
+        const int undecided = ~(culled | _mm_movemask_ps(inside)) & 0xF;
+
+        // Boxes of the spheres straddling a plane, tighter than the sphere on the diagonal
+        if (undecided) {
+            const __m128 extentX = _mm_loadu_ps(&m_extentX[i]);
+            const __m128 extentY = _mm_loadu_ps(&m_extentY[i]);
+            const __m128 extentZ = _mm_loadu_ps(&m_extentZ[i]);
+
+            __m128 boxOutside = _mm_setzero_ps();
+            for (int p = 0; p < 6; ++p) {
+                const __m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extentX, absX[p]), _mm_mul_ps(extentY, absY[p])),
+                    _mm_mul_ps(extentZ, absZ[p]));
+                boxOutside = _mm_or_ps(boxOutside, _mm_cmplt_ps(distances[p], _mm_xor_ps(boxRadius, signBit)));
+            }
+            culled |= _mm_movemask_ps(boxOutside) & undecided;
+        }
+
+        const std::size_t lanes = std::min<std::size_t>(4, count - i);
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            if (!(culled & (1 << lane))) {
+                visible.push_back(m_entities[i + lane]);
+            }
+        }
+    }
+#else
+    for (std::size_t i = 0; i < count; ++i) {
+        const glm::vec3 center(m_centerX[i], m_centerY[i], m_centerZ[i]);
+        const glm::vec3 extents(m_extentX[i], m_extentY[i], m_extentZ[i]);
+
+        bool culled = false;
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+            culled = culled || distance < -m_radius[i];
+            inside = inside && distance >= m_radius[i];
+        }
+        if (!culled && !inside) {
+            for (const glm::vec4& plane : frustum.planes) {
+                const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+                culled = culled || distance < -glm::dot(glm::abs(glm::vec3(plane)), extents);
+            }
+        }
+
+        if (!culled) {
+            visible.push_back(m_entities[i]);
+        }
+    }
+#endif
+}
@@ -0,0 +1,259 @@
+#include "Graphics/OcclusionCuller.hpp"
+#include "Core/Simd.hpp"
+#include "World/Entity.hpp"
+#include "World/Mesh/RenderComponent.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+    // Behind the camera or in front of the near plane: perspective division would be meaningless
+    bool BeforeNearPlane(const glm::vec4& clip) {
+        return clip.w <= 0.0f || clip.z < -clip.w;
+    }
+
+    // Pixel coordinates and depth in [0, 1]
+    glm::vec3 ToScreen(const glm::vec4& clip) {
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        return glm::vec3(
+            (ndc.x * 0.5f + 0.5f) * OcclusionCuller::WIDTH,
+            (ndc.y * 0.5f + 0.5f) * OcclusionCuller::HEIGHT,
+            ndc.z * 0.5f + 0.5f);
+    }
+
+    // a * x + b * y + c, positive on the left of the edge from p to q
+    struct Edge {
+        float a, b, c;
+
+        Edge(const glm::vec3& p, const glm::vec3& q) : a(p.y - q.y), b(q.x - p.x), c(-(a * p.x + b * p.y)) {}
+    };
+}
+
+void OcclusionCuller::Begin(const glm::mat4& viewProjection) {
+    m_viewProjection = viewProjection;
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+}
+
+std::size_t OcclusionCuller::RenderTriangles(const std::vector<glm::vec3>& triangles, const glm::mat4& model) {
+    const glm::mat4 transform = m_viewProjection * model;
+    std::size_t drawn = 0;
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        const glm::vec4 a = transform * glm::vec4(triangles[i], 1.0f);
+        const glm::vec4 b = transform * glm::vec4(triangles[i + 1], 1.0f);
+        const glm::vec4 c = transform * glm::vec4(triangles[i + 2], 1.0f);
+
+        // Not clipped: leaving the triangle out only hides less
+        if (BeforeNearPlane(a) || BeforeNearPlane(b) || BeforeNearPlane(c)) {
+            continue;
+        }
+        RasterizeTriangle(a, b, c);
+        ++drawn;
+    }
+    return drawn;
+}
+
+void OcclusionCuller::RasterizeTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    glm::vec3 p0 = ToScreen(a);
+    glm::vec3 p1 = ToScreen(b);
+    glm::vec3 p2 = ToScreen(c);
+
+    // Both sides are drawn: counter-clockwise from here
+    float area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+    if (!(std::abs(area) > 0.0f)) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(p1, p2);
+        area = -area;
+    }
+
+    int minX = std::max(0, static_cast<int>(std::floor(std::min({ p0.x, p1.x, p2.x }))));
+    const int maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(std::max({ p0.x, p1.x, p2.x }))));
+    const int minY = std::max(0, static_cast<int>(std::floor(std::min({ p0.y, p1.y, p2.y }))));
+    const int maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(std::max({ p0.y, p1.y, p2.y }))));
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+    minX &= ~3;
+
+    // Weights of p0, p1 and p2, and the depth plane they interpolate (z / w is linear on screen)
+    const Edge e0(p1, p2);
+    const Edge e1(p2, p0);
+    const Edge e2(p0, p1);
+    const float dz1 = (p1.z - p0.z) / area;
+    const float dz2 = (p2.z - p0.z) / area;
+    const float za = e1.a * dz1 + e2.a * dz2;
+    const float zb = e1.b * dz1 + e2.b * dz2;
+    const float zc = p0.z + e1.c * dz1 + e2.c * dz2;
+
+#if NORA_SIMD_SSE
+    const __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 a0 = _mm_set1_ps(e0.a), a1 = _mm_set1_ps(e1.a), a2 = _mm_set1_ps(e2.a), az = _mm_set1_ps(za);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (int y = minY; y <= maxY; ++y) {
+        const float centerY = y + 0.5f;
+        const __m128 r0 = _mm_set1_ps(e0.b * centerY + e0.c);
+        const __m128 r1 = _mm_set1_ps(e1.b * centerY + e1.c);
+        const __m128 r2 = _mm_set1_ps(e2.b * centerY + e2.c);
+        const __m128 rz = _mm_set1_ps(zb * centerY + zc);
+        float* row = &m_depth[static_cast<std::size_t>(y) * WIDTH];
+
+        for (int x = minX; x <= maxX; x += 4) {
+            const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes);
+            const __m128 w0 = _mm_add_ps(_mm_mul_ps(a0, centerX), r0);
+            const __m128 w1 = _mm_add_ps(_mm_mul_ps(a1, centerX), r1);
+            const __m128 w2 = _mm_add_ps(_mm_mul_ps(a2, centerX), r2);
+            const __m128 inside = _mm_cmpge_ps(_mm_min_ps(w0, _mm_min_ps(w1, w2)), zero);
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            const __m128 depth = _mm_add_ps(_mm_mul_ps(az, centerX), rz);
+            const __m128 previous = _mm_loadu_ps(row + x);
+            const __m128 nearest = _mm_min_ps(previous, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; ++y) {
+        const float centerY = y + 0.5f;
+        float* row = &m_depth[static_cast<std::size_t>(y) * WIDTH];
+        for (int x = minX; x <= maxX; ++x) {
+            const float centerX = x + 0.5f;
+            const float w0 = e0.a * centerX + e0.b * centerY + e0.c;
+            const float w1 = e1.a * centerX + e1.b * centerY + e1.c;
+            const float w2 = e2.a * centerX + e2.b * centerY + e2.c;
+            if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f) {
+                row[x] = std::min(row[x], za * centerX + zb * centerY + zc);
+            }
+        }
+    }
+#endif
+}
+
+bool OcclusionCuller::Project(const Aabb& box, int& minX, int& minY, int& maxX, int& maxY, float& depth) const {
+    // Corners from the projected center and half axes: additions instead of 8 matrix products
+    const glm::vec3 extents = box.Extents();
+    const glm::vec4 center = m_viewProjection * glm::vec4(box.Center(), 1.0f);
+    const glm::vec4 axisX = m_viewProjection[0] * extents.x;
+    const glm::vec4 axisY = m_viewProjection[1] * extents.y;
+    const glm::vec4 axisZ = m_viewProjection[2] * extents.z;
+
+    glm::vec3 low(std::numeric_limits<float>::max());
+    glm::vec3 high(-std::numeric_limits<float>::max());
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec4 clip = center
+            + (corner & 1 ? axisX : -axisX)
+            + (corner & 2 ? axisY : -axisY)
+            + (corner & 4 ? axisZ : -axisZ);
+        if (BeforeNearPlane(clip)) {
+            return false;
+        }
+        const glm::vec3 screen = ToScreen(clip);
+        low = glm::min(low, screen);
+        high = glm::max(high, screen);
+    }
+
+    minX = std::max(0, static_cast<int>(std::floor(low.x)));
+    minY = std::max(0, static_cast<int>(std::floor(low.y)));
+    maxX = std::min(WIDTH - 1, static_cast<int>(std::floor(high.x)));
+    maxY = std::min(HEIGHT - 1, static_cast<int>(std::floor(high.y)));
+    depth = low.z;
+    return true;
+}
+
+bool OcclusionCuller::IsVisible(const Aabb& box) const {
+    int minX, minY, maxX, maxY;
+    float depth;
+    if (box.IsEmpty() || !Project(box, minX, minY, maxX, maxY, depth) || minX > maxX || minY > maxY) {
+        return true;
+    }
+
+    // Hidden when every pixel under the box holds something nearer than its nearest point.
+    // Whole groups of 4 are read: the pixels past the rectangle can only keep the box visible.
+    minX &= ~3;
+#if NORA_SIMD_SSE
+    const __m128 boxDepth = _mm_set1_ps(depth);
+    for (int y = minY; y <= maxY; ++y) {
+        const float* row = &m_depth[static_cast<std::size_t>(y) * WIDTH];
+        for (int x = minX; x <= maxX; x += 4) {
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth))) {
+                return true;
+            }
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; ++y) {
+        const float* row = &m_depth[static_cast<std::size_t>(y) * WIDTH];
+        for (int x = minX; x <= maxX; ++x) {
+            if (row[x] >= depth) {
+                return true;
+            }
+        }
+    }
+#endif
+    return false;
+}
+
+void OcclusionCuller::Cull(const glm::mat4& viewProjection, std::vector<Entity*>& visible) {
+    m_stats = Stats();
+    Begin(viewProjection);
+
+    // Occluders by the part of the screen they cover, the ones reaching past the near plane first
+    m_occluders.clear();
+    m_meshes.resize(visible.size());
+    for (std::size_t i = 0; i < visible.size(); ++i) {
+        const RenderComponent* mesh = visible[i]->GetComponent<RenderComponent>();
+        m_meshes[i] = mesh;
+        if (!mesh->IsOccluder() || mesh->OccluderTriangles().empty()) {
+            continue;
+        }
+
+        const Aabb box = mesh->LocalBounds().Transformed(visible[i]->GetTransform().GetRenderMatrix());
+        int minX, minY, maxX, maxY;
+        float depth;
+        float area = 1.0f;
+        if (!box.IsEmpty() && Project(box, minX, minY, maxX, maxY, depth)) {
+            area = static_cast<float>(std::max(0, maxX - minX + 1) * std::max(0, maxY - minY + 1)) / (WIDTH * HEIGHT);
+        }
+        if (area >= MIN_OCCLUDER_AREA) {
+            m_occluders.push_back({ i, area });
+        }
+    }
+    if (m_occluders.empty()) {
+        return;
+    }
+    std::sort(m_occluders.begin(), m_occluders.end(), [](const Occluder& a, const Occluder& b) {
+        return a.area > b.area;
+    });
+
+    m_drawn.assign(visible.size(), 0);
+    for (const Occluder& occluder : m_occluders) {
+        Entity* entity = visible[occluder.index];
+        const std::vector<glm::vec3>& triangles = m_meshes[occluder.index]->OccluderTriangles();
+        if (m_stats.triangles + triangles.size() / 3 > TRIANGLE_BUDGET) {
+            continue;
+        }
+        m_stats.triangles += RenderTriangles(triangles, entity->GetTransform().GetRenderMatrix());
+        m_drawn[occluder.index] = 1;
+        ++m_stats.occluders;
+    }
+
+    // The drawn occluders would hide themselves
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < visible.size(); ++i) {
+        Entity* entity = visible[i];
+        if (!m_drawn[i]) {
+            ++m_stats.tested;
+            if (!IsVisible(m_meshes[i]->LocalBounds().Transformed(entity->GetTransform().GetRenderMatrix()))) {
+                ++m_stats.occluded;
+                continue;
+            }
+        }
+        visible[kept++] = entity;
+    }
+    visible.resize(kept);
+}
@@ -0,0 +1,160 @@
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/Shader.hpp"
+#include "World/Mesh/RenderComponent.hpp"
+#include "World/Mesh/3DModel/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void RenderQueue::Begin(const glm::mat4& view, const glm::mat4& projection, float farPlane) {
+    m_view = view;
+    m_projection = projection;
+    m_depthRow = -glm::vec4(view[0][2], view[1][2], view[2][2], view[3][2]);
+    m_depthScale = farPlane > 0.0f ? static_cast<float>((1u << DEPTH_BITS) - 1) / farPlane : 0.0f;
+    m_packets.clear();
+    m_slots.clear();
+    m_entries.clear();
+}
+
+std::uint32_t RenderQueue::ProgramSlot(const Shader* shader) {
+    // A handful of shaders: a scan beats any map
+    for (std::size_t i = 0; i < m_programs.size(); ++i) {
+        if (m_programs[i].shader == shader) {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+    m_programs.push_back({ shader, shader ? glGetUniformLocation(shader->ID, "instance") : -1 });
+    return static_cast<std::uint32_t>(m_programs.size() - 1);
+}
+
+void RenderQueue::Push(Pass pass, const Packet& packet, const glm::vec3& position) {
+    const std::uint32_t slot = ProgramSlot(packet.shader);
+    const float distance = glm::dot(m_depthRow, glm::vec4(position, 1.0f));
+    const std::uint64_t depth = static_cast<std::uint64_t>(std::clamp(distance * m_depthScale, 0.0f, static_cast<float>((1u << DEPTH_BITS) - 1)));
+    const std::uint64_t program = slot & 0xFF;
+    // A material is keyed by its first texture: meshes sharing it mostly share the others too
+    unsigned int textureName = packet.texture;
+    if (packet.material) {
+        textureName = packet.material->m_Textures.empty() ? 0 : packet.material->m_Textures[0].ID;
+    }
+    const std::uint64_t texture = textureName & 0xFFFF;
+    const std::uint64_t vertexArray = packet.vertexArray & 0xFFFF;
+
+    std::uint64_t key = static_cast<std::uint64_t>(pass) << 62;
+    if (pass == Pass::Opaque) {
+        key |= program << 54 | texture << 38 | vertexArray << 22 | depth;
+    } else {
+        key |= (((std::uint64_t(1) << DEPTH_BITS) - 1) - depth) << 40 | program << 32 | texture << 16 | vertexArray;
+    }
+
+    m_entries.push_back({ key, static_cast<std::uint32_t>(m_packets.size()) });
+    m_packets.push_back(packet);
+    m_slots.push_back(slot);
+}
+
+void RenderQueue::Sort() {
+    const std::size_t count = m_entries.size();
+    m_scratch.resize(count);
+
+    // Every byte's histogram in one read of the keys
+    std::size_t histograms[8][256] = {};
+    for (const Entry& entry : m_entries) {
+        for (int byte = 0; byte < 8; ++byte) {
+            ++histograms[byte][(entry.key >> (byte * 8)) & 0xFF];
+        }
+    }
+
+    for (int byte = 0; byte < 8; ++byte) {
+        std::size_t* histogram = histograms[byte];
+        const int shift = byte * 8;
+        // All keys share this byte: the pass wouldn't move anything
+        if (count == 0 || histogram[(m_entries[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            const std::size_t size = histogram[digit];
+            histogram[digit] = offset;
+            offset += size;
+        }
+        for (const Entry& entry : m_entries) {
+            m_scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        m_entries.swap(m_scratch);
+    }
+}
+
+void RenderQueue::Submit() {
+    m_stats = Stats();
+
+    // Unknown until the first draw sets them
+    constexpr unsigned int UNKNOWN = ~0u;
+    unsigned int program = UNKNOWN;
+    unsigned int texture = UNKNOWN;
+    unsigned int vertexArray = UNKNOWN;
+    const Mesh* material = nullptr;
+
+    for (const Entry& entry : m_entries) {
+        const Packet& packet = m_packets[entry.index];
+        ++m_stats.draws;
+
+        if (packet.immediate) {
+            packet.immediate->Render(*packet.shader, m_view, m_projection);
+            program = packet.shader->ID;
+            texture = vertexArray = UNKNOWN;
+            material = nullptr;
+            continue;
+        }
+
+        if (packet.shader->ID != program) {
+            packet.shader->Use();
+            program = packet.shader->ID;
+            // The samplers a material sets are uniforms of the program
+            material = nullptr;
+            ++m_stats.programBinds;
+        } else {
+            ++m_stats.programBindsSkipped;
+        }
+
+        if (packet.material) {
+            if (!material || !material->SameTextures(*packet.material)) {
+                packet.material->BindTextures(*packet.shader);
+                material = packet.material;
+                texture = UNKNOWN;
+                ++m_stats.textureBinds;
+            } else {
+                ++m_stats.textureBindsSkipped;
+            }
+        } else if (packet.texture != texture) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, packet.texture);
+            texture = packet.texture;
+            material = nullptr;
+            ++m_stats.textureBinds;
+        } else {
+            ++m_stats.textureBindsSkipped;
+        }
+
+        if (packet.vertexArray != vertexArray) {
+            glBindVertexArray(packet.vertexArray);
+            vertexArray = packet.vertexArray;
+            ++m_stats.vertexArrayBinds;
+        } else {
+            ++m_stats.vertexArrayBindsSkipped;
+        }
+
+        glUniform1i(m_programs[m_slots[entry.index]].instanceLocation, packet.instance);
+        if (packet.indexed) {
+            glDrawElements(packet.primitive, packet.count, GL_UNSIGNED_INT, nullptr);
+        } else {
+            glDrawArrays(packet.primitive, 0, packet.count);
+        }
+    }
+
+    if (!m_entries.empty()) {
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
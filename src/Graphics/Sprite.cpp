@@ -1,5 +1,6 @@
 #include "Graphics/Sprite.hpp"
 #include "World/Entity.hpp"
+#include "Graphics/RenderQueue.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -45,20 +46,24 @@ void Sprite::SetupMesh() {
     glBindVertexArray(0);
 }
 
+std::shared_ptr<Component> Sprite::Clone() const {
+    std::shared_ptr<Sprite> clone = ComponentPool<Sprite>::Create();
+    clone->m_texture = m_texture;
+    clone->m_occluder = m_occluder;
+    return clone;
+}
+
 void Sprite::Start() {
     SetupMesh();
 }
 
-void Sprite::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+void Sprite::Render(Shader& shader, const glm::mat4& /*viewMatrix*/, const glm::mat4& /*projectionMatrix*/) {
     shader.Use();
     if (m_texture) {
         m_texture->Bind(0);
     }
 
-    shader.SetMat4("projection", projectionMatrix);
-    shader.SetMat4("view", viewMatrix);
-    glm::mat4 modelMatrix = m_owner->GetTransform().GetModelMatrix();
-    shader.SetMat4("model", modelMatrix);
+    shader.SetInt("instance", static_cast<int>(GetOwner()->GetId()));
 
     glBindVertexArray(m_VAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -69,6 +74,10 @@ void Sprite::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4
     }
 }
 
+void Sprite::Enqueue(RenderQueue& queue, Shader& shader) {
+    EnqueueArrays(queue, shader, m_VAO, 6);
+}
+
 std::string Sprite::ShaderType() {
     return "mesh";
 }
@@ -1,7 +1,7 @@
 #include "Graphics/Texture.hpp"
 #include <iostream>
 
-Texture::Texture(const std::string& path, bool hasAlpha, std::string type) : ID(0), m_path(path), m_type(type) {
+Texture::Texture(const std::string& path, bool hasAlpha, std::string type) : ID(0), m_path(path), m_type(type), m_hasAlpha(hasAlpha) {
     glGenTextures(1, &ID);
     glBindTexture(GL_TEXTURE_2D, ID);
 
@@ -42,10 +42,14 @@ void Texture::Unbind(unsigned int unit) const {
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-std::string Texture::Path() {
+std::string Texture::Path() const {
     return m_path;
 }
 
-std::string Texture::Type() {
+std::string Texture::Type() const {
     return m_type;
 }
+
+bool Texture::HasAlpha() const {
+    return m_hasAlpha;
+}
@@ -0,0 +1,95 @@
+#include "Graphics/TransformBuffer.hpp"
+#include "World/Entity.hpp"
+
+#include <algorithm>
+
+void TransformBuffer::Update() {
+    m_uploaded = 0;
+    m_changed.clear();
+    bool complete = Registry::ConsumeChanges(m_changes, m_changed);
+
+    const std::size_t slots = Registry::EntitySlots();
+    if (slots > m_capacity || m_buffer == 0) {
+        Reallocate(std::max({ slots, m_capacity * 2, std::size_t(1024) }));
+        complete = false;
+    }
+
+    // First frame, history lost or new storage: everything goes up
+    if (!complete) {
+        for (EntityId id = 0; id < slots; ++id) {
+            if (Entity* entity = Registry::GetEntity(id)) {
+                m_matrices[id] = entity->GetTransform().GetRenderMatrix();
+            }
+        }
+        Upload(0, slots);
+        return;
+    }
+
+    if (m_changed.empty()) {
+        return;
+    }
+
+    std::sort(m_changed.begin(), m_changed.end());
+    for (EntityId id : m_changed) {
+        m_matrices[id] = Registry::GetEntity(id)->GetTransform().GetRenderMatrix();
+    }
+
+    std::size_t begin = m_changed[0];
+    std::size_t end = begin + 1;
+    for (std::size_t i = 1; i < m_changed.size(); ++i) {
+        if (m_changed[i] > end + MERGE_GAP) {
+            Upload(begin, end);
+            begin = m_changed[i];
+        }
+        end = m_changed[i] + 1;
+    }
+    Upload(begin, end);
+}
+
+void TransformBuffer::Bind() const {
+    glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void TransformBuffer::Release() {
+    if (m_texture != 0) {
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+    }
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_capacity = 0;
+    m_changes = ChangeCursor();
+}
+
+void TransformBuffer::Reallocate(std::size_t capacity) {
+    if (m_buffer == 0) {
+        glGenBuffers(1, &m_buffer);
+        glGenTextures(1, &m_texture);
+    }
+
+    m_capacity = capacity;
+    m_matrices.resize(capacity, glm::mat4(1.0f));
+
+    glBindBuffer(GL_TEXTURE_BUFFER, m_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void TransformBuffer::Upload(std::size_t begin, std::size_t end) {
+    if (begin >= end) {
+        return;
+    }
+
+    m_uploaded += end - begin;
+    glBindBuffer(GL_TEXTURE_BUFFER, m_buffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, begin * sizeof(glm::mat4), (end - begin) * sizeof(glm::mat4), &m_matrices[begin]);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
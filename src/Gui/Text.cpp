@@ -13,6 +13,14 @@ Text::~Text() {
     }
 }
 
+std::shared_ptr<Component> Text::Clone() const {
+    std::shared_ptr<Text> clone = ComponentPool<Text>::Create();
+    clone->font = font;
+    clone->text = text;
+    clone->color = color;
+    return clone;
+}
+
 void Text::Start() {
     SetupMesh();
 }
@@ -55,8 +63,8 @@ void Text::Render(Shader& shader) {
     GL_CHECK_ERROR("Text::Render - After SetInt text sampler");
 
     // Récupérer la position de base et l'échelle depuis le Transform de l'entité
-    glm::vec3 owner_position = m_owner->GetTransform().GetLocalPosition();
-    glm::vec3 owner_scale = m_owner->GetTransform().GetLocalScale();
+    glm::vec3 owner_position = GetOwner()->GetTransform().GetLocalPosition();
+    glm::vec3 owner_scale = GetOwner()->GetTransform().GetLocalScale();
 
     float cursor_x = owner_position.x; // Position x de départ du texte
     float baseline_y = owner_position.y; // Position y de la ligne de base du texte
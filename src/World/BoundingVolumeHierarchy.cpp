@@ -0,0 +1,554 @@
+#include "World/BoundingVolumeHierarchy.hpp"
+#include "World/Entity.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace {
+    bool SameBox(const Aabb& a, const Aabb& b) {
+        return a.min == b.min && a.max == b.max;
+    }
+
+    // The sphere holds the whole box when it holds its farthest corner
+    bool SphereContains(const glm::vec3& center, float radius, const Aabb& box) {
+        const glm::vec3 farthest = glm::max(glm::abs(center - box.min), glm::abs(box.max - center));
+        return glm::dot(farthest, farthest) <= radius * radius;
+    }
+}
+
+void BoundingVolumeHierarchy::Set(Entity* entity, const Aabb& bounds) {
+    const EntityId id = entity->GetId();
+    if (id >= m_leaves.size()) {
+        m_leaves.resize(id + 1, NULL_NODE);
+    }
+
+    std::int32_t leaf = m_leaves[id];
+    if (leaf == NULL_NODE) {
+        leaf = AllocateNode();
+        m_nodes[leaf].entity = entity;
+        m_nodes[leaf].box = bounds.Inflated(MARGIN);
+        m_bounds[leaf] = bounds;
+        m_leaves[id] = leaf;
+        ++m_leafCount;
+        InsertLeaf(leaf);
+        return;
+    }
+
+    m_bounds[leaf] = bounds;
+    if (m_nodes[leaf].box.Contains(bounds)) {
+        return;
+    }
+
+    // Moved out of its margin: the ancestors catch up in Refit
+    m_nodes[leaf].box = bounds.Inflated(MARGIN);
+    m_enlarged.push_back(leaf);
+}
+
+void BoundingVolumeHierarchy::Remove(EntityId entity) {
+    if (!Contains(entity)) {
+        return;
+    }
+
+    const std::int32_t leaf = m_leaves[entity];
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+    m_leaves[entity] = NULL_NODE;
+    --m_leafCount;
+}
+
+Aabb BoundingVolumeHierarchy::GetBounds(EntityId entity) const {
+    return Contains(entity) ? m_bounds[m_leaves[entity]] : Aabb();
+}
+
+void BoundingVolumeHierarchy::Build(const std::vector<std::pair<Entity*, Aabb>>& entities) {
+    Clear();
+    ++m_stats.builds;
+    m_nodes.reserve(entities.size() * 2);
+    m_bounds.reserve(entities.size() * 2);
+
+    std::vector<std::int32_t> leaves;
+    leaves.reserve(entities.size());
+    for (const auto& [entity, bounds] : entities) {
+        const EntityId id = entity->GetId();
+        if (id >= m_leaves.size()) {
+            m_leaves.resize(id + 1, NULL_NODE);
+        }
+        if (m_leaves[id] != NULL_NODE) {
+            continue;
+        }
+
+        const std::int32_t leaf = AllocateNode();
+        m_nodes[leaf].entity = entity;
+        m_nodes[leaf].box = bounds.Inflated(MARGIN);
+        m_bounds[leaf] = bounds;
+        m_leaves[id] = leaf;
+        leaves.push_back(leaf);
+    }
+
+    m_leafCount = leaves.size();
+    m_root = BuildTopDown(leaves);
+    m_builtCost = Cost();
+}
+
+void BoundingVolumeHierarchy::Refit() {
+    ++m_stats.refits;
+    for (std::int32_t leaf : m_enlarged) {
+        // Removed since (the node may even be an internal one by now)
+        if (m_nodes[leaf].entity) {
+            FitUpwards(m_nodes[leaf].parent);
+        }
+    }
+    m_enlarged.clear();
+
+    if (m_leafCount > 2 && Cost() > m_builtCost * REBUILD_RATIO) {
+        Rebuild();
+    }
+}
+
+void BoundingVolumeHierarchy::Rebuild() {
+    std::vector<std::pair<Entity*, Aabb>> entities;
+    entities.reserve(m_leafCount);
+    for (std::size_t node = 0; node < m_nodes.size(); ++node) {
+        if (m_nodes[node].entity) {
+            entities.emplace_back(m_nodes[node].entity, m_bounds[node]);
+        }
+    }
+    Build(entities);
+}
+
+void BoundingVolumeHierarchy::Clear() {
+    m_nodes.clear();
+    m_bounds.clear();
+    std::fill(m_leaves.begin(), m_leaves.end(), NULL_NODE);
+    m_enlarged.clear();
+    m_root = NULL_NODE;
+    m_free = NULL_NODE;
+    m_leafCount = 0;
+    m_internalArea = 0.0;
+    m_builtCost = 0.0f;
+}
+
+void BoundingVolumeHierarchy::Query(const Aabb& box, std::vector<Entity*>& out) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    std::vector<std::int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const std::int32_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[index];
+        if (!box.Intersects(node.box)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            if (box.Intersects(m_bounds[index])) {
+                out.push_back(node.entity);
+            }
+        }
+        else if (box.Contains(node.box)) {
+            CollectLeaves(index, out);
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::Query(const Frustum& frustum, std::vector<Entity*>& out) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    std::vector<std::int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const std::int32_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[index];
+        const Frustum::Test test = frustum.Classify(node.box);
+        if (test == Frustum::Test::Outside) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            if (frustum.Intersects(m_bounds[index])) {
+                out.push_back(node.entity);
+            }
+        }
+        else if (test == Frustum::Test::Inside) {
+            CollectLeaves(index, out);
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QuerySphere(const glm::vec3& center, float radius, std::vector<Entity*>& out) const {
+    if (m_root == NULL_NODE) {
+        return;
+    }
+
+    std::vector<std::int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const std::int32_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[index];
+        if (!node.box.Intersects(center, radius)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            if (m_bounds[index].Intersects(center, radius)) {
+                out.push_back(node.entity);
+            }
+        }
+        else if (SphereContains(center, radius, node.box)) {
+            CollectLeaves(index, out);
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::Nearest(const glm::vec3& point, std::size_t k, std::vector<Entity*>& out, float maxDistance) const {
+    if (m_root == NULL_NODE || k == 0) {
+        return;
+    }
+
+    using Candidate = std::pair<float, std::int32_t>;
+
+    // Nodes closest first; the k best leaves so far, farthest on top
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> nodes;
+    std::priority_queue<Candidate> best;
+
+    // A node's box holds its leaves' exact ones, so it is never farther than them
+    float limit = maxDistance * maxDistance;
+    nodes.emplace(m_nodes[m_root].box.DistanceSquared(point), m_root);
+    while (!nodes.empty() && nodes.top().first <= limit) {
+        const std::int32_t index = nodes.top().second;
+        nodes.pop();
+
+        const Node& node = m_nodes[index];
+        if (node.IsLeaf()) {
+            const float distance = m_bounds[index].DistanceSquared(point);
+            if (distance > limit) {
+                continue;
+            }
+            best.emplace(distance, index);
+            if (best.size() > k) {
+                best.pop();
+            }
+            if (best.size() == k) {
+                limit = best.top().first;
+            }
+            continue;
+        }
+
+        for (std::int32_t child : { node.left, node.right }) {
+            const float distance = m_nodes[child].box.DistanceSquared(point);
+            if (distance <= limit) {
+                nodes.emplace(distance, child);
+            }
+        }
+    }
+
+    const std::size_t first = out.size();
+    out.resize(first + best.size());
+    for (std::size_t i = out.size(); i > first; --i) {
+        out[i - 1] = m_nodes[best.top().second].entity;
+        best.pop();
+    }
+}
+
+std::size_t BoundingVolumeHierarchy::Depth() const {
+    if (m_root == NULL_NODE) {
+        return 0;
+    }
+
+    std::size_t depth = 0;
+    std::vector<std::pair<std::int32_t, std::size_t>> stack = { { m_root, 1 } };
+    while (!stack.empty()) {
+        const auto [index, level] = stack.back();
+        stack.pop_back();
+
+        depth = std::max(depth, level);
+        if (!m_nodes[index].IsLeaf()) {
+            stack.emplace_back(m_nodes[index].left, level + 1);
+            stack.emplace_back(m_nodes[index].right, level + 1);
+        }
+    }
+    return depth;
+}
+
+float BoundingVolumeHierarchy::Cost() const {
+    if (m_root == NULL_NODE) {
+        return 0.0f;
+    }
+    const float rootArea = m_nodes[m_root].box.SurfaceArea();
+    return rootArea > 0.0f ? static_cast<float>(m_internalArea / rootArea) : 0.0f;
+}
+
+std::int32_t BoundingVolumeHierarchy::AllocateNode() {
+    if (m_free != NULL_NODE) {
+        const std::int32_t node = m_free;
+        m_free = m_nodes[node].parent;
+        m_nodes[node] = Node();
+        return node;
+    }
+
+    m_nodes.emplace_back();
+    m_bounds.emplace_back();
+    return static_cast<std::int32_t>(m_nodes.size() - 1);
+}
+
+void BoundingVolumeHierarchy::FreeNode(std::int32_t node) {
+    if (!m_nodes[node].IsLeaf()) {
+        m_internalArea -= m_nodes[node].box.SurfaceArea();
+    }
+    m_nodes[node] = Node();
+    m_nodes[node].parent = m_free;
+    m_free = node;
+}
+
+void BoundingVolumeHierarchy::SetBox(std::int32_t node, const Aabb& box) {
+    if (!m_nodes[node].IsLeaf()) {
+        m_internalArea += box.SurfaceArea() - m_nodes[node].box.SurfaceArea();
+    }
+    m_nodes[node].box = box;
+}
+
+void BoundingVolumeHierarchy::InsertLeaf(std::int32_t leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Going down, until pairing the leaf with the node here costs less than with either child:
+    // a new parent costs its area, and every node it goes through grows
+    const Aabb box = m_nodes[leaf].box;
+    std::int32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = node.box.SurfaceArea();
+        const float combined = Aabb::Union(node.box, box).SurfaceArea();
+        const float cost = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+
+        auto descendCost = [&](std::int32_t child) {
+            const Node& childNode = m_nodes[child];
+            const float childCombined = Aabb::Union(childNode.box, box).SurfaceArea();
+            return inherited + (childNode.IsLeaf() ? childCombined : childCombined - childNode.box.SurfaceArea());
+        };
+        const float leftCost = descendCost(node.left);
+        const float rightCost = descendCost(node.right);
+
+        if (cost < leftCost && cost < rightCost) {
+            break;
+        }
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+
+    const std::int32_t sibling = index;
+    const std::int32_t grandParent = m_nodes[sibling].parent;
+    const std::int32_t parent = AllocateNode();
+    m_nodes[parent].parent = grandParent;
+    m_nodes[parent].left = sibling;
+    m_nodes[parent].right = leaf;
+    SetBox(parent, Aabb::Union(box, m_nodes[sibling].box));
+    m_nodes[sibling].parent = parent;
+    m_nodes[leaf].parent = parent;
+
+    if (grandParent == NULL_NODE) {
+        m_root = parent;
+        return;
+    }
+    if (m_nodes[grandParent].left == sibling) {
+        m_nodes[grandParent].left = parent;
+    }
+    else {
+        m_nodes[grandParent].right = parent;
+    }
+    FitUpwards(grandParent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(std::int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    const std::int32_t parent = m_nodes[leaf].parent;
+    const std::int32_t grandParent = m_nodes[parent].parent;
+    const std::int32_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE) {
+        m_root = sibling;
+    }
+    else if (m_nodes[grandParent].left == parent) {
+        m_nodes[grandParent].left = sibling;
+    }
+    else {
+        m_nodes[grandParent].right = sibling;
+    }
+
+    FreeNode(parent);
+    m_nodes[leaf].parent = NULL_NODE;
+    FitUpwards(grandParent);
+}
+
+void BoundingVolumeHierarchy::FitUpwards(std::int32_t node) {
+    while (node != NULL_NODE) {
+        const Aabb box = Aabb::Union(m_nodes[m_nodes[node].left].box, m_nodes[m_nodes[node].right].box);
+        if (SameBox(box, m_nodes[node].box)) {
+            return;
+        }
+        SetBox(node, box);
+        node = m_nodes[node].parent;
+    }
+}
+
+std::int32_t BoundingVolumeHierarchy::BuildTopDown(std::vector<std::int32_t>& leaves) {
+    if (leaves.empty()) {
+        return NULL_NODE;
+    }
+
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+        std::int32_t parent;
+        bool left;
+    };
+
+    std::vector<glm::vec3> centroids(m_nodes.size());
+    for (std::int32_t leaf : leaves) {
+        centroids[leaf] = m_nodes[leaf].box.Center();
+    }
+
+    std::int32_t root = NULL_NODE;
+    std::vector<Range> stack = { { 0, leaves.size(), NULL_NODE, false } };
+    while (!stack.empty()) {
+        const Range range = stack.back();
+        stack.pop_back();
+
+        std::int32_t node;
+        if (range.end - range.begin == 1) {
+            node = leaves[range.begin];
+        }
+        else {
+            Aabb box;
+            Aabb centroidBox;
+            for (std::size_t i = range.begin; i < range.end; ++i) {
+                box.Expand(m_nodes[leaves[i]].box);
+                centroidBox.Expand(centroids[leaves[i]]);
+            }
+
+            const auto first = leaves.begin() + range.begin;
+            const auto last = leaves.begin() + range.end;
+            const glm::vec3 spread = centroidBox.max - centroidBox.min;
+            const int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+            auto split = first + (last - first) / 2;
+
+            if (spread[axis] > 0.0f) {
+                // Binned SAH: the boundary between bins minimizing area x count on both sides
+                const float scale = SAH_BINS / spread[axis];
+                auto binOf = [&](std::int32_t leaf) {
+                    const std::size_t bin = static_cast<std::size_t>((centroids[leaf][axis] - centroidBox.min[axis]) * scale);
+                    return std::min(bin, SAH_BINS - 1);
+                };
+
+                Aabb binBoxes[SAH_BINS];
+                std::size_t binCounts[SAH_BINS] = {};
+                for (auto it = first; it != last; ++it) {
+                    const std::size_t bin = binOf(*it);
+                    binBoxes[bin].Expand(m_nodes[*it].box);
+                    ++binCounts[bin];
+                }
+
+                float rightCosts[SAH_BINS] = {};
+                Aabb accumulated;
+                std::size_t count = 0;
+                for (std::size_t bin = SAH_BINS - 1; bin > 0; --bin) {
+                    accumulated.Expand(binBoxes[bin]);
+                    count += binCounts[bin];
+                    rightCosts[bin] = accumulated.SurfaceArea() * count;
+                }
+
+                std::size_t bestBin = 0;
+                float bestCost = std::numeric_limits<float>::max();
+                accumulated = Aabb();
+                count = 0;
+                for (std::size_t bin = 1; bin < SAH_BINS; ++bin) {
+                    accumulated.Expand(binBoxes[bin - 1]);
+                    count += binCounts[bin - 1];
+                    const float cost = accumulated.SurfaceArea() * count + rightCosts[bin];
+                    if (count > 0 && cost < bestCost) {
+                        bestCost = cost;
+                        bestBin = bin;
+                    }
+                }
+
+                const auto partitioned = std::partition(first, last, [&](std::int32_t leaf) { return binOf(leaf) < bestBin; });
+                if (partitioned != first && partitioned != last) {
+                    split = partitioned;
+                }
+                else {
+                    std::nth_element(first, split, last, [&](std::int32_t a, std::int32_t b) {
+                        return centroids[a][axis] < centroids[b][axis];
+                    });
+                }
+            }
+
+            node = AllocateNode();
+            m_nodes[node].box = box;
+            m_internalArea += box.SurfaceArea();
+
+            const std::size_t middle = static_cast<std::size_t>(split - leaves.begin());
+            stack.push_back({ range.begin, middle, node, true });
+            stack.push_back({ middle, range.end, node, false });
+        }
+
+        m_nodes[node].parent = range.parent;
+        if (range.parent == NULL_NODE) {
+            root = node;
+        }
+        else if (range.left) {
+            m_nodes[range.parent].left = node;
+        }
+        else {
+            m_nodes[range.parent].right = node;
+        }
+    }
+    return root;
+}
+
+void BoundingVolumeHierarchy::CollectLeaves(std::int32_t node, std::vector<Entity*>& out) const {
+    std::vector<std::int32_t> stack = { node };
+    while (!stack.empty()) {
+        const std::int32_t index = stack.back();
+        stack.pop_back();
+
+        if (m_nodes[index].IsLeaf()) {
+            out.push_back(m_nodes[index].entity);
+        }
+        else {
+            stack.push_back(m_nodes[index].left);
+            stack.push_back(m_nodes[index].right);
+        }
+    }
+}
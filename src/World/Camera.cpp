@@ -1,17 +1,55 @@
 #include "World/Camera.hpp"
 #include "World/Entity.hpp"
 
+#include <cstring>
+
 Camera::Camera(const glm::vec3 &worldUp, float yaw, float pitch)
 : WorldUp(worldUp), Yaw(yaw), Pitch(pitch), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM) {
     UpdateCameraVectors();
 }
 
+std::shared_ptr<Component> Camera::Clone() const {
+    return ComponentPool<Camera>::Create(*this);
+}
+
+namespace {
+    struct CameraState {
+        glm::vec3 worldUp;
+        float yaw;
+        float pitch;
+        float movementSpeed;
+        float mouseSensitivity;
+        float zoom;
+    };
+}
+
+std::size_t Camera::StateSize() const {
+    return sizeof(CameraState);
+}
+
+void Camera::SaveState(void* out) const {
+    const CameraState state { WorldUp, Yaw, Pitch, MovementSpeed, MouseSensitivity, Zoom };
+    std::memcpy(out, &state, sizeof(state));
+}
+
+void Camera::LoadState(const void* in) {
+    CameraState state;
+    std::memcpy(&state, in, sizeof(state));
+    WorldUp = state.worldUp;
+    Yaw = state.yaw;
+    Pitch = state.pitch;
+    MovementSpeed = state.movementSpeed;
+    MouseSensitivity = state.mouseSensitivity;
+    Zoom = state.zoom;
+    UpdateCameraVectors();
+}
+
 glm::mat4 Camera::GetViewMatrix() const {
-    const glm::vec3 position = m_owner->GetTransform().GetGlobalPosition();
+    const glm::vec3 position = GetOwner()->GetTransform().GetRenderMatrix()[3];
     return glm::lookAt(position, position + Front, Up);
 }
 
-void Camera::Update() {
+void Camera::LateUpdate() {
     UpdateCameraVectors();
 }
 
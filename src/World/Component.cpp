@@ -0,0 +1,13 @@
+#include "World/Component.hpp"
+#include "World/Entity.hpp"
+
+void Component::SetOwner(Entity* owner) {
+    m_owner = owner ? owner->GetHandle() : EntityHandle{};
+}
+
+void Component::MarkChanged() {
+    m_changeTick = Registry::CurrentTick();
+    if (GetOwner()) {
+        Registry::MarkChanged(m_owner.index);
+    }
+}
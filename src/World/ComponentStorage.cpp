@@ -0,0 +1,48 @@
+#include "World/ComponentStorage.hpp"
+#include "World/Component.hpp"
+
+void ComponentStorage::Reserve(std::size_t count, EntityId maxEntity) {
+    m_entities.reserve(m_entities.size() + count);
+    m_components.reserve(m_components.size() + count);
+    if (maxEntity != INVALID_ENTITY && maxEntity >= m_sparse.size()) {
+        m_sparse.resize(maxEntity + 1, INVALID_INDEX);
+    }
+}
+
+bool ComponentStorage::Insert(EntityId entity, std::shared_ptr<Component> component) {
+    if (entity >= m_sparse.size()) {
+        m_sparse.resize(entity + 1, INVALID_INDEX);
+    }
+
+    if (m_sparse[entity] != INVALID_INDEX) {
+        return false;
+    }
+
+    m_sparse[entity] = static_cast<std::uint32_t>(m_components.size());
+    m_entities.push_back(entity);
+    m_components.push_back(std::move(component));
+    return true;
+}
+
+std::shared_ptr<Component> ComponentStorage::Remove(EntityId entity) {
+    if (!Contains(entity)) {
+        return nullptr;
+    }
+
+    const std::uint32_t index = m_sparse[entity];
+    const std::uint32_t last = static_cast<std::uint32_t>(m_components.size() - 1);
+    std::shared_ptr<Component> removed = std::move(m_components[index]);
+
+    // Keep the dense arrays packed by moving the last element into the hole
+    if (index != last) {
+        m_components[index] = std::move(m_components[last]);
+        m_entities[index] = m_entities[last];
+        m_sparse[m_entities[index]] = index;
+    }
+
+    m_components.pop_back();
+    m_entities.pop_back();
+    m_sparse[entity] = INVALID_INDEX;
+
+    return removed;
+}
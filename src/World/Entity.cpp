@@ -0,0 +1,35 @@
+#include "World/Entity.hpp"
+#include "World/Scene.hpp"
+
+void Entity::SetName(const std::string& name) {
+    if (name == m_name) {
+        return;
+    }
+
+    const std::string previous = std::move(m_name);
+    m_name = name;
+    if (Scene* scene = GetScene()) {
+        scene->OnEntityRenamed(this, previous);
+    }
+}
+
+void Entity::SetTags(TagMask tags) {
+    if (tags == m_tags) {
+        return;
+    }
+
+    const TagMask previous = m_tags;
+    m_tags = tags;
+    if (Scene* scene = GetScene()) {
+        scene->OnEntityRetagged(this, previous);
+    }
+}
+
+void Entity::Destroy() {
+    if (m_parent) {
+        m_parent->RemoveChild(this);
+    }
+    else if (Scene* scene = GetScene()) {
+        scene->RemoveEntity(this);
+    }
+}
@@ -0,0 +1,137 @@
+#include "World/EntityCommandBuffer.hpp"
+#include "World/Entity.hpp"
+#include "World/Scene.hpp"
+
+#include <iostream>
+
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::Create() {
+    return RecordCreate({}, false);
+}
+
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::Create(EntityHandle parent) {
+    return RecordCreate({ parent }, true);
+}
+
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::Create(PendingEntity parent) {
+    return RecordCreate({ {}, parent.index }, true);
+}
+
+EntityCommandBuffer::PendingEntity EntityCommandBuffer::RecordCreate(Target parent, bool hasParent) {
+    Command command{ CommandType::Create, parent };
+    command.hasParent = hasParent;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.push_back(std::move(command));
+    return { m_pendingCount++ };
+}
+
+void EntityCommandBuffer::Destroy(EntityHandle entity) {
+    Record({ CommandType::Destroy, { entity } });
+}
+
+void EntityCommandBuffer::AddComponent(EntityHandle entity, std::shared_ptr<Component> component) {
+    Record({ CommandType::AddComponent, { entity }, std::move(component) });
+}
+
+void EntityCommandBuffer::AddComponent(PendingEntity entity, std::shared_ptr<Component> component) {
+    Record({ CommandType::AddComponent, { {}, entity.index }, std::move(component) });
+}
+
+void EntityCommandBuffer::RemoveComponent(EntityHandle entity, ComponentTypeId type) {
+    Command command{ CommandType::RemoveComponent, { entity } };
+    command.componentType = type;
+    Record(std::move(command));
+}
+
+void EntityCommandBuffer::Record(Command command) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.push_back(std::move(command));
+}
+
+std::size_t EntityCommandBuffer::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_commands.size();
+}
+
+bool EntityCommandBuffer::Empty() const {
+    return Size() == 0;
+}
+
+void EntityCommandBuffer::Playback(Scene& scene) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_commands.empty()) {
+            return;
+        }
+        m_playing.swap(m_commands);
+        m_pendingCount = 0;
+    }
+
+    m_created.clear();
+    auto resolve = [this](const Target& target) -> Entity* {
+        if (target.pending == NO_PENDING) {
+            return Registry::Resolve(target.handle);
+        }
+        return target.pending < m_created.size() ? Registry::Resolve(m_created[target.pending]) : nullptr;
+    };
+
+    for (Command& command : m_playing) {
+        switch (command.type) {
+            case CommandType::Create: {
+                if (!command.hasParent) {
+                    std::shared_ptr<Entity> entity = Entity::Create();
+                    m_created.push_back(entity->GetHandle());
+                    scene.AddEntity(std::move(entity));
+                }
+                else if (Entity* parent = resolve(command.target)) {
+                    auto entity = std::make_unique<Entity>();
+                    m_created.push_back(entity->GetHandle());
+                    parent->AddChild(std::move(entity));
+                }
+                else {
+                    // Keep the pending indices aligned, the parent is gone so this one never resolves
+                    m_created.emplace_back();
+                }
+                break;
+            }
+
+            case CommandType::Destroy: {
+                if (Entity* entity = resolve(command.target)) {
+                    entity->Destroy();
+                }
+                break;
+            }
+
+            case CommandType::AddComponent: {
+                Entity* entity = resolve(command.target);
+                if (!entity) {
+                    break;
+                }
+
+                Component* component = command.component.get();
+                entity->AddComponent(std::move(command.component));
+
+                // Components added to a running scene still get their Start
+                Scene* owner = entity->GetScene();
+                if (owner && owner->IsStarted()) {
+                    try {
+                        component->Start();
+                    }
+                    catch (const py::cast_error& e) {
+                        std::cerr << "Error while calling component Start" << std::endl;
+                    }
+                }
+                break;
+            }
+
+            case CommandType::RemoveComponent: {
+                if (Entity* entity = resolve(command.target)) {
+                    entity->RemoveComponent(command.componentType);
+                }
+                break;
+            }
+        }
+    }
+
+    m_playing.clear();
+}
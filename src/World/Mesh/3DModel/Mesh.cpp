@@ -10,6 +10,18 @@ Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices,
 }
 
 void Mesh::Draw(Shader& shader) {
+    BindTextures(shader);
+
+    // draw mesh
+    glBindVertexArray(m_VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(m_Indices.size()), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+
+    // always good practice to set everything back to defaults once configured.
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::BindTextures(Shader& shader) const {
     // bind appropriate textures
     unsigned int diffuseNr = 1;
     unsigned int specularNr = 1;
@@ -37,14 +49,18 @@ void Mesh::Draw(Shader& shader) {
         // and finally bind the texture
         glBindTexture(GL_TEXTURE_2D, m_Textures[i].ID);
     }
+}
 
-    // draw mesh
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(m_Indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    // always good practice to set everything back to defaults once configured.
-    glActiveTexture(GL_TEXTURE0);
+bool Mesh::SameTextures(const Mesh& other) const {
+    if (m_Textures.size() != other.m_Textures.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_Textures.size(); ++i) {
+        if (m_Textures[i].ID != other.m_Textures[i].ID) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void Mesh::SetupMesh() {
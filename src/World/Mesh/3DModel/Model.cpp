@@ -1,5 +1,8 @@
 #include "World/Mesh/3DModel/Model.hpp"
 #include "Core/Debug.hpp"
+#include "World/ComponentPool.hpp"
+#include "World/Entity.hpp"
+#include "Graphics/RenderQueue.hpp"
 
 Model::Model(std::string path_) {
     path = path_;
@@ -7,16 +10,41 @@ Model::Model(std::string path_) {
 
 Model::~Model() {}
 
+// Loaded again by the clone's Start
+std::shared_ptr<Component> Model::Clone() const {
+    std::shared_ptr<Model> clone = ComponentPool<Model>::Create(path);
+    clone->m_texture = m_texture;
+    clone->m_occluder = m_occluder;
+    return clone;
+}
+
 void Model::Start() {
     LoadModel();
 }
 
-void Model::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+void Model::Render(Shader& shader, const glm::mat4& /*viewMatrix*/, const glm::mat4& /*projectionMatrix*/) {
+    shader.Use();
+    shader.SetInt("instance", static_cast<int>(GetOwner()->GetId()));
+
     for (unsigned int i = 0; i < meshes.size(); i++) {
         meshes[i].Draw(shader);
     }
 }
 
+void Model::Enqueue(RenderQueue& queue, Shader& shader) {
+    const glm::vec3 position = GetOwner()->GetTransform().GetRenderMatrix()[3];
+    for (const Mesh& mesh : meshes) {
+        RenderQueue::Packet packet;
+        packet.shader = &shader;
+        packet.material = &mesh;
+        packet.vertexArray = mesh.m_VAO;
+        packet.count = static_cast<GLsizei>(mesh.m_Indices.size());
+        packet.indexed = true;
+        packet.instance = static_cast<int>(GetOwner()->GetId());
+        queue.Push(RenderQueue::Pass::Opaque, packet, position);
+    }
+}
+
 std::string Model::ShaderType() {
     return "3d_model";
 }
@@ -24,7 +52,7 @@ std::string Model::ShaderType() {
 void Model::LoadModel() {
     // read file via ASSIMP
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenBoundingBoxes);
 
     // check for errors
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) { // if is Not Zero
@@ -38,6 +66,10 @@ void Model::LoadModel() {
 
     // process ASSIMP's root node recursively
     ProcessNode(scene->mRootNode, scene);
+    PickOccluders(scene);
+
+    // the bounds are known from now on: the scene's BVH picks them up with the change
+    MarkChanged();
 }
 
 void Model::ProcessNode(aiNode* node, const aiScene* scene) {
@@ -46,6 +78,8 @@ void Model::ProcessNode(aiNode* node, const aiScene* scene) {
         // the node object only contains indices to index the actual objects in the scene. 
         // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+        m_bounds.Expand(glm::vec3(mesh->mAABB.mMin.x, mesh->mAABB.mMin.y, mesh->mAABB.mMin.z));
+        m_bounds.Expand(glm::vec3(mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z));
         meshes.push_back(ProcessMesh(mesh, scene));
     }
 
@@ -55,6 +89,34 @@ void Model::ProcessNode(aiNode* node, const aiScene* scene) {
     }
 }
 
+void Model::PickOccluders(const aiScene* scene) {
+    m_occluderTriangles.clear();
+    const float area = m_bounds.SurfaceArea();
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        const aiMesh* mesh = scene->mMeshes[i];
+        const Aabb box(glm::vec3(mesh->mAABB.mMin.x, mesh->mAABB.mMin.y, mesh->mAABB.mMin.z),
+            glm::vec3(mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z));
+        if (mesh->mNumFaces > MAX_OCCLUDER_TRIANGLES || box.SurfaceArea() < area * OCCLUDER_AREA_FRACTION) {
+            continue;
+        }
+
+        for (unsigned int j = 0; j < mesh->mNumFaces; j++) {
+            const aiFace& face = mesh->mFaces[j];
+            if (face.mNumIndices != 3) {
+                continue;
+            }
+            for (unsigned int k = 0; k < 3; k++) {
+                const aiVector3D& vertex = mesh->mVertices[face.mIndices[k]];
+                m_occluderTriangles.emplace_back(vertex.x, vertex.y, vertex.z);
+            }
+        }
+    }
+
+    if (!m_occluderTriangles.empty()) {
+        SetOccluder(true);
+    }
+}
+
 Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene) {
     // data to fill
     std::vector<MeshVertex> vertices;
@@ -1,6 +1,7 @@
 #include "World/Mesh/CapsuleMesh.hpp"
 #include "World/Entity.hpp"
 #include "Graphics/Shader.hpp"
+#include "Graphics/RenderQueue.hpp"
 #include <cmath>
 #include <iostream>
 
@@ -18,6 +19,10 @@ m_cylinderStacks(cylinderStacks) {
     if (m_sectorCount == 0) m_sectorCount = 1;
     if (m_hemisphereStacks == 0) m_hemisphereStacks = 1;
     if (m_cylinderStacks == 0) m_cylinderStacks = 1;
+
+    // Square section inscribed in the circle, along the cylinder
+    const float side = m_radius * 0.7071f;
+    m_occluderTriangles = BoxTriangles(Aabb(glm::vec3(-side, -side, -m_cylinderHeight / 2.0f), glm::vec3(side, side, m_cylinderHeight / 2.0f)));
 }
 
 CapsuleMesh::~CapsuleMesh() {
@@ -215,32 +220,29 @@ void CapsuleMesh::SetupMesh() {
     glBindVertexArray(0); // Unbind VAO
 }
 
+std::shared_ptr<Component> CapsuleMesh::Clone() const {
+    std::shared_ptr<CapsuleMesh> clone = ComponentPool<CapsuleMesh>::Create(m_radius, m_cylinderHeight, m_sectorCount, m_hemisphereStacks, m_cylinderStacks);
+    clone->m_texture = m_texture;
+    clone->m_occluder = m_occluder;
+    return clone;
+}
+
 void CapsuleMesh::Start() {
     SetupMesh();
 }
 
-void CapsuleMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
-    if (m_VAO == 0 || m_vertices.empty()) return; // Ne rien faire si non initialisé
+void CapsuleMesh::Render(Shader& shader, const glm::mat4& /*viewMatrix*/, const glm::mat4& /*projectionMatrix*/) {
+    Entity* owner = GetOwner();
+    if (m_VAO == 0 || m_vertices.empty() || !owner) return; // Ne rien faire si non initialisé
 
     shader.Use();
     if (m_texture) {
         m_texture->Bind(0);
     }
 
-    shader.SetMat4("projection", projectionMatrix);
-    shader.SetMat4("view", viewMatrix);
-
-    // Assurez-vous que m_owner est défini et que GetTransform() est valide
-    if (m_owner) {
-        glm::mat4 modelMatrix = m_owner->GetTransform().GetModelMatrix();
-        shader.SetMat4("model", modelMatrix);
-   } else {
-       // Gérer le cas où m_owner n'est pas défini, peut-être utiliser une matrice identité
-       shader.SetMat4("model", glm::mat4(1.0f));
-       // std::cerr << "CapsuleMesh::Render - m_owner is null!" << std::endl; // Optionnel: log
-   }
+    shader.SetInt("instance", static_cast<int>(owner->GetId()));
 
-   glBindVertexArray(m_VAO);
+    glBindVertexArray(m_VAO);
 
     // Le nombre de sommets à dessiner est m_vertices.size() / 5 (car chaque sommet a 5 floats: x,y,z,u,v)
     glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size() / 5));
@@ -251,6 +253,12 @@ void CapsuleMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm:
     }
 }
 
+void CapsuleMesh::Enqueue(RenderQueue& queue, Shader& shader) {
+    if (m_VAO == 0 || m_vertices.empty() || !GetOwner()) return;
+
+    EnqueueArrays(queue, shader, m_VAO, static_cast<GLsizei>(m_vertices.size() / 5));
+}
+
 std::string CapsuleMesh::ShaderType() {
     return "mesh";
 }
@@ -1,6 +1,7 @@
 #include "World/Mesh/CuboidMesh.hpp"
 #include "World/Entity.hpp"
 #include "Graphics/Shader.hpp"
+#include "Graphics/RenderQueue.hpp"
 #include <iostream>
 
 const float CuboidMesh::s_vertices[180] = {
@@ -83,19 +84,23 @@ void CuboidMesh::SetupMesh() {
     glBindVertexArray(0);
 }
 
+// The GL buffers are created by Start, a clone only carries the settings
+std::shared_ptr<Component> CuboidMesh::Clone() const {
+    std::shared_ptr<CuboidMesh> clone = ComponentPool<CuboidMesh>::Create();
+    clone->m_texture = m_texture;
+    clone->m_occluder = m_occluder;
+    return clone;
+}
+
 void CuboidMesh::Start() {
     SetupMesh();
 }
 
-void CuboidMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+void CuboidMesh::Render(Shader& shader, const glm::mat4& /*viewMatrix*/, const glm::mat4& /*projectionMatrix*/) {
     shader.Use();
     m_texture->Bind(0);
 
-    shader.SetMat4("projection", projectionMatrix);
-    shader.SetMat4("view", viewMatrix);
-
-    glm::mat4 modelMatrix = m_owner->GetTransform().GetModelMatrix();
-    shader.SetMat4("model", modelMatrix);
+    shader.SetInt("instance", static_cast<int>(GetOwner()->GetId()));
 
     glBindVertexArray(m_VAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
@@ -104,6 +109,10 @@ void CuboidMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::
     m_texture->Unbind(0);
 }
 
+void CuboidMesh::Enqueue(RenderQueue& queue, Shader& shader) {
+    EnqueueArrays(queue, shader, m_VAO, 36);
+}
+
 std::string CuboidMesh::ShaderType() {
     return "mesh";
 }
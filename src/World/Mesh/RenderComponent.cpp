@@ -0,0 +1,23 @@
+#include "World/Mesh/RenderComponent.hpp"
+#include "World/Entity.hpp"
+#include "Graphics/RenderQueue.hpp"
+
+void RenderComponent::Enqueue(RenderQueue& queue, Shader& shader) {
+    RenderQueue::Packet packet;
+    packet.shader = &shader;
+    packet.immediate = this;
+    queue.Push(RenderQueue::Pass::Opaque, packet, GetOwner()->GetTransform().GetRenderMatrix()[3]);
+}
+
+void RenderComponent::EnqueueArrays(RenderQueue& queue, Shader& shader, unsigned int vertexArray, GLsizei count) {
+    RenderQueue::Packet packet;
+    packet.shader = &shader;
+    packet.texture = m_texture ? m_texture->ID : 0;
+    packet.vertexArray = vertexArray;
+    packet.count = count;
+    packet.instance = static_cast<int>(GetOwner()->GetId());
+
+    const bool transparent = m_texture && m_texture->HasAlpha();
+    queue.Push(transparent ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque, packet,
+               GetOwner()->GetTransform().GetRenderMatrix()[3]);
+}
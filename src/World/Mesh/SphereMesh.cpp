@@ -1,5 +1,6 @@
 #include "World/Mesh/SphereMesh.hpp"
 #include "World/Entity.hpp"
+#include "Graphics/RenderQueue.hpp"
 #include <cmath>
 #include <iostream>
 
@@ -90,19 +91,22 @@ void SphereMesh::SetupMesh() {
     glBindVertexArray(0);
 }
 
+std::shared_ptr<Component> SphereMesh::Clone() const {
+    std::shared_ptr<SphereMesh> clone = ComponentPool<SphereMesh>::Create(m_sectorCount, m_stackCount);
+    clone->m_texture = m_texture;
+    clone->m_occluder = m_occluder;
+    return clone;
+}
+
 void SphereMesh::Start() {
     SetupMesh();
 }
 
-void SphereMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+void SphereMesh::Render(Shader& shader, const glm::mat4& /*viewMatrix*/, const glm::mat4& /*projectionMatrix*/) {
     shader.Use();
     m_texture->Bind(0);
 
-    shader.SetMat4("projection", projectionMatrix);
-    shader.SetMat4("view", viewMatrix);
-
-    glm::mat4 modelMatrix = m_owner->GetTransform().GetModelMatrix();
-    shader.SetMat4("model", modelMatrix);
+    shader.SetInt("instance", static_cast<int>(GetOwner()->GetId()));
 
     glBindVertexArray(m_VAO);
     glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size() / 5));
@@ -111,6 +115,10 @@ void SphereMesh::Render(Shader& shader, const glm::mat4& viewMatrix, const glm::
     m_texture->Unbind(0);
 }
 
+void SphereMesh::Enqueue(RenderQueue& queue, Shader& shader) {
+    EnqueueArrays(queue, shader, m_VAO, static_cast<GLsizei>(m_vertices.size() / 5));
+}
+
 std::string SphereMesh::ShaderType() {
     return "mesh";
 }
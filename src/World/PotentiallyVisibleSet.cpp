@@ -0,0 +1,775 @@
+#include "World/PotentiallyVisibleSet.hpp"
+#include "World/Scene.hpp"
+#include "World/Entity.hpp"
+#include "World/Mesh/RenderComponent.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace {
+    constexpr std::size_t ALIGNMENT = 8;
+
+    // Voxels are shrunk by this fraction for the surface test: a face lying on a voxel's side
+    // doesn't pass through either of them
+    constexpr float SURFACE_EPSILON = 1e-3f;
+
+    std::size_t Align(std::size_t offset) {
+        return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // SplitMix64: the same numbers on every platform, which the standard distributions don't promise
+    class Random {
+        public:
+            explicit Random(std::uint64_t seed) : m_state(seed) {}
+
+            std::uint64_t Next() {
+                std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+
+            // [0, 1)
+            float Unit() {
+                return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f);
+            }
+
+            // [0, count)
+            std::uint32_t Below(std::uint32_t count) {
+                return static_cast<std::uint32_t>(((Next() >> 32) * count) >> 32);
+            }
+
+        private:
+            std::uint64_t m_state;
+    };
+
+    // Separating axis test of a triangle against a box (Akenine-Möller)
+    bool TriangleOverlapsBox(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& center, const glm::vec3& half) {
+        const glm::vec3 v[3] = { a - center, b - center, c - center };
+        const glm::vec3 edges[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+
+        const auto separated = [&v, &half](const glm::vec3& axis) {
+            const float p0 = glm::dot(v[0], axis);
+            const float p1 = glm::dot(v[1], axis);
+            const float p2 = glm::dot(v[2], axis);
+            const float radius = glm::dot(half, glm::abs(axis));
+            return std::min({ p0, p1, p2 }) > radius || std::max({ p0, p1, p2 }) < -radius;
+        };
+
+        for (int axis = 0; axis < 3; ++axis) {
+            if (std::min({ v[0][axis], v[1][axis], v[2][axis] }) > half[axis] || std::max({ v[0][axis], v[1][axis], v[2][axis] }) < -half[axis]) {
+                return false;
+            }
+        }
+        if (separated(glm::cross(edges[0], edges[1]))) {
+            return false;
+        }
+        for (const glm::vec3& edge : edges) {
+            for (int axis = 0; axis < 3; ++axis) {
+                glm::vec3 unit(0.0f);
+                unit[axis] = 1.0f;
+                if (separated(glm::cross(unit, edge))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    struct VoxelGrid {
+        glm::vec3 origin;
+        float size;
+        glm::ivec3 dimensions;
+        std::vector<unsigned char> solid;
+
+        bool Inside(const glm::ivec3& voxel) const {
+            return voxel.x >= 0 && voxel.y >= 0 && voxel.z >= 0
+                && voxel.x < dimensions.x && voxel.y < dimensions.y && voxel.z < dimensions.z;
+        }
+
+        std::size_t Index(const glm::ivec3& voxel) const {
+            return static_cast<std::size_t>(voxel.x) + static_cast<std::size_t>(dimensions.x) * (voxel.y + static_cast<std::size_t>(dimensions.y) * voxel.z);
+        }
+
+        glm::ivec3 Voxel(std::size_t index) const {
+            const std::size_t x = index % dimensions.x;
+            const std::size_t y = (index / dimensions.x) % dimensions.y;
+            const std::size_t z = index / (static_cast<std::size_t>(dimensions.x) * dimensions.y);
+            return glm::ivec3(x, y, z);
+        }
+
+        glm::ivec3 VoxelAt(const glm::vec3& position) const {
+            return glm::ivec3(glm::floor((position - origin) / size));
+        }
+
+        // Walks the voxels the segment crosses (Amanatides and Woo), false at the first solid one
+        bool Clear(const glm::vec3& from, const glm::vec3& to) const {
+            const glm::vec3 start = (from - origin) / size;
+            const glm::vec3 direction = (to - origin) / size - start;
+            glm::ivec3 voxel = glm::ivec3(glm::floor(start));
+            const glm::ivec3 last = VoxelAt(to);
+
+            glm::ivec3 step;
+            glm::vec3 next, delta;
+            for (int axis = 0; axis < 3; ++axis) {
+                if (direction[axis] > 0.0f) {
+                    step[axis] = 1;
+                    delta[axis] = 1.0f / direction[axis];
+                    next[axis] = (voxel[axis] + 1 - start[axis]) * delta[axis];
+                } else if (direction[axis] < 0.0f) {
+                    step[axis] = -1;
+                    delta[axis] = -1.0f / direction[axis];
+                    next[axis] = (start[axis] - voxel[axis]) * delta[axis];
+                } else {
+                    step[axis] = 0;
+                    delta[axis] = next[axis] = std::numeric_limits<float>::infinity();
+                }
+            }
+
+            while (Inside(voxel)) {
+                if (solid[Index(voxel)]) {
+                    return false;
+                }
+                if (voxel == last) {
+                    break;
+                }
+                const int axis = next.x < next.y ? (next.x < next.z ? 0 : 2) : (next.y < next.z ? 1 : 2);
+                if (next[axis] > 1.0f) {
+                    break;
+                }
+                voxel[axis] += step[axis];
+                next[axis] += delta[axis];
+            }
+            return true;
+        }
+    };
+
+    // Voxels entirely inside the closed parts of the triangles (world space), within their bounds plus a
+    // margin. The centers are flooded from the margin, stepping to a neighbor unless a triangle lies
+    // across the way; a voxel is inside when its center wasn't reached and no triangle passes through it.
+    // Faces exactly between two voxels still stop the flood, and gaps between triangles only let it leak.
+    void InteriorVoxels(const VoxelGrid& grid, const std::vector<glm::vec3>& triangles, std::vector<std::size_t>& out) {
+        Aabb bounds;
+        for (const glm::vec3& vertex : triangles) {
+            bounds.Expand(vertex);
+        }
+        const glm::ivec3 low = glm::max(grid.VoxelAt(bounds.min) - 1, glm::ivec3(0));
+        const glm::ivec3 high = glm::min(grid.VoxelAt(bounds.max) + 1, grid.dimensions - 1);
+        const glm::ivec3 size = high - low + 1;
+        if (glm::any(glm::lessThan(size, glm::ivec3(3)))) {
+            return;
+        }
+
+        // Bit a: the step to the next voxel along axis a crosses a triangle
+        constexpr unsigned char SURFACE = 8;
+        constexpr unsigned char OUTSIDE = 16;
+        std::vector<unsigned char> flags(static_cast<std::size_t>(size.x) * size.y * size.z, 0);
+        const auto local = [&size](const glm::ivec3& voxel) {
+            return static_cast<std::size_t>(voxel.x) + static_cast<std::size_t>(size.x) * (voxel.y + static_cast<std::size_t>(size.y) * voxel.z);
+        };
+        // Voxel coordinates relative to `low`, centers at + 0.5
+        const glm::vec3 base = grid.origin + glm::vec3(low) * grid.size;
+
+        const glm::vec3 half(grid.size * 0.5f * (1.0f - SURFACE_EPSILON));
+        for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+            const glm::vec3 a = (triangles[i] - base) / grid.size;
+            const glm::vec3 b = (triangles[i + 1] - base) / grid.size;
+            const glm::vec3 c = (triangles[i + 2] - base) / grid.size;
+            const glm::ivec3 from = glm::max(glm::ivec3(glm::floor(glm::min(a, glm::min(b, c)))), glm::ivec3(0));
+            const glm::ivec3 to = glm::min(glm::ivec3(glm::floor(glm::max(a, glm::max(b, c)))), size - 1);
+
+            for (int z = from.z; z <= to.z; ++z) {
+                for (int y = from.y; y <= to.y; ++y) {
+                    for (int x = from.x; x <= to.x; ++x) {
+                        const glm::vec3 center = base + (glm::vec3(x, y, z) + 0.5f) * grid.size;
+                        if (TriangleOverlapsBox(triangles[i], triangles[i + 1], triangles[i + 2], center, half)) {
+                            flags[local({ x, y, z })] |= SURFACE;
+                        }
+                    }
+                }
+            }
+
+            // Steps along each axis: lines through the centers of the other two, crossing the triangle
+            // where it projects over them
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            for (int axis = 0; axis < 3; ++axis) {
+                if (normal[axis] == 0.0f) {
+                    continue;
+                }
+                const int u = (axis + 1) % 3;
+                const int v = (axis + 2) % 3;
+                const float area = (b[u] - a[u]) * (c[v] - a[v]) - (b[v] - a[v]) * (c[u] - a[u]);
+                const float epsilon = 1e-5f * std::abs(area);
+                for (int j = std::max(0, from[v] - 1); j <= std::min(size[v] - 1, to[v] + 1); ++j) {
+                    for (int k = std::max(0, from[u] - 1); k <= std::min(size[u] - 1, to[u] + 1); ++k) {
+                        const float pu = k + 0.5f;
+                        const float pv = j + 0.5f;
+                        // Twice the signed areas, inclusive edges: leaks between triangles are the thing to avoid
+                        const float w0 = (b[u] - pu) * (c[v] - pv) - (b[v] - pv) * (c[u] - pu);
+                        const float w1 = (c[u] - pu) * (a[v] - pv) - (c[v] - pv) * (a[u] - pu);
+                        const float w2 = (a[u] - pu) * (b[v] - pv) - (a[v] - pv) * (b[u] - pu);
+                        const bool inside = area > 0.0f
+                            ? w0 >= -epsilon && w1 >= -epsilon && w2 >= -epsilon
+                            : w0 <= epsilon && w1 <= epsilon && w2 <= epsilon;
+                        if (!inside) {
+                            continue;
+                        }
+
+                        // Where the plane is along the line, then the step from center to center crossing it
+                        const float position = a[axis] - (normal[u] * (pu - a[u]) + normal[v] * (pv - a[v])) / normal[axis];
+                        const int step = static_cast<int>(std::floor(position - 0.5f));
+                        if (step >= 0 && step + 1 < size[axis]) {
+                            glm::ivec3 voxel;
+                            voxel[axis] = step;
+                            voxel[u] = k;
+                            voxel[v] = j;
+                            flags[local(voxel)] |= static_cast<unsigned char>(1 << axis);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::deque<glm::ivec3> open;
+        const auto reach = [&](const glm::ivec3& voxel) {
+            unsigned char& value = flags[local(voxel)];
+            if (!(value & OUTSIDE)) {
+                value |= OUTSIDE;
+                open.push_back(voxel);
+            }
+        };
+        for (int z = 0; z < size.z; ++z) {
+            for (int y = 0; y < size.y; ++y) {
+                for (int x = 0; x < size.x; ++x) {
+                    if (x == 0 || y == 0 || z == 0 || x == size.x - 1 || y == size.y - 1 || z == size.z - 1) {
+                        reach({ x, y, z });
+                    }
+                }
+            }
+        }
+        while (!open.empty()) {
+            const glm::ivec3 voxel = open.front();
+            open.pop_front();
+            for (int axis = 0; axis < 3; ++axis) {
+                glm::ivec3 next = voxel;
+                next[axis] += 1;
+                if (next[axis] < size[axis] && !(flags[local(voxel)] & (1 << axis))) {
+                    reach(next);
+                }
+                glm::ivec3 previous = voxel;
+                previous[axis] -= 1;
+                if (previous[axis] >= 0 && !(flags[local(previous)] & (1 << axis))) {
+                    reach(previous);
+                }
+            }
+        }
+
+        for (int z = 0; z < size.z; ++z) {
+            for (int y = 0; y < size.y; ++y) {
+                for (int x = 0; x < size.x; ++x) {
+                    if (!(flags[local({ x, y, z })] & (SURFACE | OUTSIDE))) {
+                        out.push_back(grid.Index(low + glm::ivec3(x, y, z)));
+                    }
+                }
+            }
+        }
+    }
+
+    Aabb WorldBounds(const Entity& entity) {
+        return entity.GetComponent<RenderComponent>()->LocalBounds().Transformed(entity.GetTransform().GetModelMatrix());
+    }
+}
+
+std::vector<Entity*> PotentiallyVisibleSet::CollectObjects(const std::vector<std::shared_ptr<Entity>>& roots) {
+    // Depth first, children in order: the order the scene file stores them in
+    std::vector<Entity*> objects;
+    std::vector<Entity*> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        stack.push_back(it->get());
+    }
+    while (!stack.empty()) {
+        Entity* entity = stack.back();
+        stack.pop_back();
+        if (entity->IsStatic() && entity->GetComponent<RenderComponent>()) {
+            objects.push_back(entity);
+        }
+        const auto& children = entity->GetChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back(it->get());
+        }
+    }
+    return objects;
+}
+
+std::uint64_t PotentiallyVisibleSet::HashObjects(const std::vector<Entity*>& objects) {
+    // FNV-1a over the names and local positions (to 1/16), known as soon as the entities are built:
+    // before any asset is loaded and any world matrix computed
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    const auto mix = [&hash](const void* data, std::size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    };
+
+    const std::uint64_t count = objects.size();
+    mix(&count, sizeof(count));
+    for (const Entity* entity : objects) {
+        const std::string& name = entity->GetName();
+        mix(name.data(), name.size());
+        const glm::vec3& position = entity->GetTransform().GetLocalPosition();
+        for (int axis = 0; axis < 3; ++axis) {
+            const std::int32_t value = static_cast<std::int32_t>(std::lround(position[axis] * 16.0f));
+            mix(&value, sizeof(value));
+        }
+    }
+    return hash;
+}
+
+void PotentiallyVisibleSet::Bake(const Scene& scene, const Settings& settings) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<Entity*> objects = CollectObjects(scene.GetRootEntities());
+
+    std::vector<Aabb> objectBounds(objects.size());
+    Aabb level;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        objectBounds[i] = WorldBounds(*objects[i]);
+        level.Expand(objectBounds[i]);
+    }
+
+    // Cells aligned on multiples of their size with one spare around the level
+    const int voxelsPerCell = std::max(1, settings.voxelsPerCell);
+    m_cellSize = settings.cellSize;
+    if (level.IsEmpty()) {
+        level = Aabb(glm::vec3(0.0f), glm::vec3(0.0f));
+    }
+    m_origin = (glm::floor(level.min / m_cellSize) - 1.0f) * m_cellSize;
+    m_dimensions = glm::ivec3(glm::floor((level.max - m_origin) / m_cellSize)) + 2;
+    m_bounds = Aabb(m_origin, m_origin + glm::vec3(m_dimensions) * m_cellSize);
+    const std::size_t cellCount = static_cast<std::size_t>(m_dimensions.x) * m_dimensions.y * m_dimensions.z;
+    if (cellCount > MAX_CELLS) {
+        throw std::runtime_error("PotentiallyVisibleSet: the level needs " + std::to_string(cellCount) + " cells, more than "
+            + std::to_string(MAX_CELLS) + ": raise the cell size");
+    }
+
+    VoxelGrid grid;
+    grid.origin = m_origin;
+    grid.size = m_cellSize / voxelsPerCell;
+    grid.dimensions = m_dimensions * voxelsPerCell;
+    grid.solid.assign(static_cast<std::size_t>(grid.dimensions.x) * grid.dimensions.y * grid.dimensions.z, 0);
+
+    // Solid voxels, one mesh per job. Each marks its own list, merged in order afterwards.
+    std::vector<std::vector<std::size_t>> interiors(objects.size());
+    JobSystem::ParallelFor(objects.size(), 1, [&](std::size_t begin, std::size_t end) {
+        std::vector<glm::vec3> triangles;
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::vector<glm::vec3>& local = objects[i]->GetComponent<RenderComponent>()->OccluderTriangles();
+            if (local.empty()) {
+                continue;
+            }
+            const glm::mat4& model = objects[i]->GetTransform().GetModelMatrix();
+            triangles.clear();
+            for (const glm::vec3& vertex : local) {
+                triangles.push_back(glm::vec3(model * glm::vec4(vertex, 1.0f)));
+            }
+            InteriorVoxels(grid, triangles, interiors[i]);
+        }
+    });
+    for (const std::vector<std::size_t>& interior : interiors) {
+        for (std::size_t index : interior) {
+            grid.solid[index] = 1;
+        }
+    }
+
+    // Connected regions of open voxels: no ray gets from one to another, so cells sharing none
+    // can't see each other and need no ray at all (the inside and the outside of a closed level)
+    std::vector<std::uint32_t> regionOf(grid.solid.size(), NONE);
+    std::uint32_t regionCount = 0;
+    std::vector<std::size_t> pending;
+    for (std::size_t seed = 0; seed < grid.solid.size(); ++seed) {
+        if (grid.solid[seed] || regionOf[seed] != NONE) {
+            continue;
+        }
+        regionOf[seed] = regionCount;
+        pending.push_back(seed);
+        while (!pending.empty()) {
+            const glm::ivec3 voxel = grid.Voxel(pending.back());
+            pending.pop_back();
+            for (int axis = 0; axis < 3; ++axis) {
+                for (int side : { -1, 1 }) {
+                    glm::ivec3 neighbor = voxel;
+                    neighbor[axis] += side;
+                    if (!grid.Inside(neighbor)) {
+                        continue;
+                    }
+                    const std::size_t index = grid.Index(neighbor);
+                    if (!grid.solid[index] && regionOf[index] == NONE) {
+                        regionOf[index] = regionCount;
+                        pending.push_back(index);
+                    }
+                }
+            }
+        }
+        ++regionCount;
+    }
+
+    // Open voxels and regions of each cell, and the cells having some
+    std::vector<std::uint32_t> openOf(cellCount, NONE); // cell -> index among the open cells
+    std::vector<std::uint32_t> openCells;
+    std::vector<std::size_t> voxelStart(1, 0);
+    std::vector<std::size_t> voxels;
+    std::vector<std::size_t> regionStart(1, 0);
+    std::vector<std::uint32_t> regions; // sorted per cell
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        const glm::ivec3 corner = glm::ivec3(cell % m_dimensions.x, (cell / m_dimensions.x) % m_dimensions.y,
+            cell / (static_cast<std::size_t>(m_dimensions.x) * m_dimensions.y)) * voxelsPerCell;
+        const std::size_t before = voxels.size();
+        for (int z = 0; z < voxelsPerCell; ++z) {
+            for (int y = 0; y < voxelsPerCell; ++y) {
+                for (int x = 0; x < voxelsPerCell; ++x) {
+                    const std::size_t index = grid.Index(corner + glm::ivec3(x, y, z));
+                    if (!grid.solid[index]) {
+                        voxels.push_back(index);
+                    }
+                }
+            }
+        }
+        if (voxels.size() != before) {
+            openOf[cell] = static_cast<std::uint32_t>(openCells.size());
+            openCells.push_back(static_cast<std::uint32_t>(cell));
+            voxelStart.push_back(voxels.size());
+
+            const std::size_t first = regions.size();
+            for (std::size_t i = before; i < voxels.size(); ++i) {
+                regions.push_back(regionOf[voxels[i]]);
+            }
+            std::sort(regions.begin() + first, regions.end());
+            regions.erase(std::unique(regions.begin() + first, regions.end()), regions.end());
+            regionStart.push_back(regions.size());
+        }
+    }
+    const auto shareRegion = [&regions, &regionStart](std::size_t i, std::size_t j) {
+        std::size_t a = regionStart[i];
+        std::size_t b = regionStart[j];
+        while (a < regionStart[i + 1] && b < regionStart[j + 1]) {
+            if (regions[a] == regions[b]) {
+                return true;
+            }
+            regions[a] < regions[b] ? ++a : ++b;
+        }
+        return false;
+    };
+
+    // Open cells overlapped by each mesh, none for the meshes without bounds (always visible). Rows only
+    // ask whether a cell sees these, the pairs of two cells holding no mesh are left untraced.
+    std::vector<std::vector<std::uint32_t>> objectCells(objects.size());
+    std::vector<char> holdsObject(openCells.size(), 0);
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        if (objectBounds[i].IsEmpty()) {
+            continue;
+        }
+        const glm::ivec3 low = glm::clamp(glm::ivec3(glm::floor((objectBounds[i].min - m_origin) / m_cellSize)), glm::ivec3(0), m_dimensions - 1);
+        const glm::ivec3 high = glm::clamp(glm::ivec3(glm::floor((objectBounds[i].max - m_origin) / m_cellSize)), glm::ivec3(0), m_dimensions - 1);
+        for (int z = low.z; z <= high.z; ++z) {
+            for (int y = low.y; y <= high.y; ++y) {
+                for (int x = low.x; x <= high.x; ++x) {
+                    const std::uint32_t open = openOf[x + static_cast<std::size_t>(m_dimensions.x) * (y + static_cast<std::size_t>(m_dimensions.y) * z)];
+                    if (open != NONE) {
+                        objectCells[i].push_back(open);
+                        holdsObject[open] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    // Cell to cell visibility. Row i holds the pairs (i, j > i), each with its own random sequence so
+    // the rays don't depend on which worker traced what; mirrored once all rows are done.
+    const std::size_t openCount = openCells.size();
+    const std::size_t words = (openCount + 63) / 64;
+    std::vector<std::uint64_t> sees(openCount * words, 0);
+    const int rays = std::max(1, settings.raysPerPair);
+    const auto samplePoint = [&](std::size_t open, Random& random) {
+        const std::size_t first = voxelStart[open];
+        const std::size_t count = voxelStart[open + 1] - first;
+        const glm::ivec3 voxel = grid.Voxel(voxels[first + random.Below(static_cast<std::uint32_t>(count))]);
+        const glm::vec3 offset(random.Unit(), random.Unit(), random.Unit());
+        return grid.origin + (glm::vec3(voxel) + offset) * grid.size;
+    };
+    JobSystem::ParallelFor(openCount, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::uint64_t* row = &sees[i * words];
+            row[i / 64] |= std::uint64_t(1) << (i % 64);
+            for (std::size_t j = i + 1; j < openCount; ++j) {
+                if (!(holdsObject[i] || holdsObject[j]) || !shareRegion(i, j)) {
+                    continue;
+                }
+                Random random((static_cast<std::uint64_t>(i) << 32) | j);
+                for (int ray = 0; ray < rays; ++ray) {
+                    if (grid.Clear(samplePoint(i, random), samplePoint(j, random))) {
+                        row[j / 64] |= std::uint64_t(1) << (j % 64);
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    for (std::size_t i = 0; i < openCount; ++i) {
+        for (std::size_t j = i + 1; j < openCount; ++j) {
+            if ((sees[i * words + j / 64] >> (j % 64)) & 1) {
+                sees[j * words + i / 64] |= std::uint64_t(1) << (i % 64);
+            }
+        }
+    }
+
+    // Meshes visible from each open cell
+    const std::size_t rowBytes = (objects.size() + 7) / 8;
+    std::vector<std::vector<unsigned char>> rows(openCount);
+    JobSystem::ParallelFor(openCount, 16, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t open = begin; open < end; ++open) {
+            std::vector<unsigned char>& row = rows[open];
+            row.assign(rowBytes, 0);
+            const std::uint64_t* seen = &sees[open * words];
+            for (std::size_t i = 0; i < objects.size(); ++i) {
+                bool visible = objectBounds[i].IsEmpty();
+                for (std::size_t k = 0; k < objectCells[i].size() && !visible; ++k) {
+                    const std::uint32_t other = objectCells[i][k];
+                    visible = (seen[other / 64] >> (other % 64)) & 1;
+                }
+                if (visible) {
+                    row[i >> 3] |= static_cast<unsigned char>(1 << (i & 7));
+                }
+            }
+        }
+    });
+
+    // Compressed in cell order, cells seeing the same meshes sharing their row
+    m_offsets.assign(cellCount, NONE);
+    m_rows.clear();
+    std::map<std::vector<unsigned char>, std::uint32_t> shared;
+    std::vector<unsigned char> compressed;
+    for (std::size_t open = 0; open < openCount; ++open) {
+        auto [it, inserted] = shared.emplace(std::move(rows[open]), static_cast<std::uint32_t>(m_rows.size()));
+        if (inserted) {
+            compressed.clear();
+            Compress(it->first, compressed);
+            m_rows.insert(m_rows.end(), compressed.begin(), compressed.end());
+        }
+        m_offsets[openCells[open]] = it->second;
+    }
+
+    m_objectCount = static_cast<std::uint32_t>(objects.size());
+    m_objectHash = HashObjects(objects);
+
+    m_stats = Stats();
+    m_stats.cells = cellCount;
+    m_stats.openCells = openCount;
+    m_stats.objects = objects.size();
+    m_stats.solidVoxels = static_cast<std::size_t>(std::count(grid.solid.begin(), grid.solid.end(), 1));
+    m_stats.bytes = m_rows.size();
+
+    Attach(scene);
+    m_stats.bakeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PotentiallyVisibleSet::Compress(const std::vector<unsigned char>& row, std::vector<unsigned char>& out) {
+    for (std::size_t i = 0; i < row.size();) {
+        if (row[i] != 0) {
+            out.push_back(row[i++]);
+            continue;
+        }
+        unsigned char run = 0;
+        while (i < row.size() && row[i] == 0 && run < 255) {
+            ++run;
+            ++i;
+        }
+        out.push_back(0);
+        out.push_back(run);
+    }
+}
+
+void PotentiallyVisibleSet::Decompress(std::uint32_t offset, std::vector<unsigned char>& row) const {
+    row.assign((m_objectCount + 7) / 8, 0);
+    std::size_t position = offset;
+    for (std::size_t i = 0; i < row.size() && position < m_rows.size();) {
+        const unsigned char value = m_rows[position++];
+        if (value != 0) {
+            row[i++] = value;
+        } else if (position < m_rows.size()) {
+            i += m_rows[position++];
+        }
+    }
+}
+
+void PotentiallyVisibleSet::Save(const std::string& path) const {
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.objectCount = m_objectCount;
+    header.cellCount = static_cast<std::uint32_t>(m_offsets.size());
+    for (int axis = 0; axis < 3; ++axis) {
+        header.dimensions[axis] = static_cast<std::uint32_t>(m_dimensions[axis]);
+        header.origin[axis] = m_origin[axis];
+    }
+    header.cellSize = m_cellSize;
+    header.objectHash = m_objectHash;
+    header.offsetsOffset = Align(sizeof(Header));
+    header.dataOffset = Align(header.offsetsOffset + m_offsets.size() * sizeof(std::uint32_t));
+    header.fileSize = header.dataOffset + m_rows.size();
+
+    std::vector<unsigned char> file(header.fileSize, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    if (!m_offsets.empty()) {
+        std::memcpy(&file[header.offsetsOffset], m_offsets.data(), m_offsets.size() * sizeof(std::uint32_t));
+    }
+    if (!m_rows.empty()) {
+        std::memcpy(&file[header.dataOffset], m_rows.data(), m_rows.size());
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        throw std::runtime_error("PotentiallyVisibleSet: can't write '" + path + "'");
+    }
+}
+
+void PotentiallyVisibleSet::Load(const std::string& path) {
+    const MappedFile file(path);
+    const unsigned char* data = file.Data();
+    const auto invalid = [&path](const std::string& reason) {
+        return std::runtime_error("PotentiallyVisibleSet: '" + path + "' " + reason);
+    };
+
+    Header header;
+    if (file.Size() < sizeof(Header)) {
+        throw invalid("is not a PVS file");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw invalid("is not a PVS file");
+    }
+    if (header.version != VERSION) {
+        throw invalid("is version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION));
+    }
+    // Offsets compared by difference: a crafted one can't wrap around
+    if (header.fileSize != file.Size()
+        || header.offsetsOffset < sizeof(Header) || header.offsetsOffset > header.fileSize
+        || header.dataOffset < header.offsetsOffset || header.dataOffset > header.fileSize
+        || (header.dataOffset - header.offsetsOffset) / sizeof(std::uint32_t) < header.cellCount) {
+        throw invalid("is truncated");
+    }
+    if (header.cellCount > MAX_CELLS
+        || header.dimensions[0] > MAX_CELLS || header.dimensions[1] > MAX_CELLS || header.dimensions[2] > MAX_CELLS
+        || std::size_t(header.dimensions[0]) * header.dimensions[1] * header.dimensions[2] != header.cellCount
+        || !(header.cellSize > 0.0f) || !std::isfinite(header.cellSize)
+        || !std::isfinite(header.origin[0]) || !std::isfinite(header.origin[1]) || !std::isfinite(header.origin[2])) {
+        throw invalid("is corrupt");
+    }
+
+    m_objectCount = header.objectCount;
+    m_objectHash = header.objectHash;
+    m_cellSize = header.cellSize;
+    for (int axis = 0; axis < 3; ++axis) {
+        m_dimensions[axis] = static_cast<int>(header.dimensions[axis]);
+        m_origin[axis] = header.origin[axis];
+    }
+    m_bounds = Aabb(m_origin, m_origin + glm::vec3(m_dimensions) * m_cellSize);
+    m_offsets.resize(header.cellCount);
+    std::memcpy(m_offsets.data(), data + header.offsetsOffset, m_offsets.size() * sizeof(std::uint32_t));
+    m_rows.assign(data + header.dataOffset, data + header.fileSize);
+    for (std::uint32_t offset : m_offsets) {
+        if (offset != NONE && offset >= m_rows.size()) {
+            throw invalid("is truncated");
+        }
+    }
+
+    m_attached = false;
+    m_objectOf.clear();
+    m_entities.clear();
+    m_cell = NONE;
+
+    m_stats = Stats();
+    m_stats.cells = m_offsets.size();
+    m_stats.openCells = static_cast<std::size_t>(m_offsets.size() - std::count(m_offsets.begin(), m_offsets.end(), NONE));
+    m_stats.objects = m_objectCount;
+    m_stats.bytes = m_rows.size();
+}
+
+bool PotentiallyVisibleSet::Attach(const Scene& scene) {
+    return Attach(scene.GetRootEntities());
+}
+
+bool PotentiallyVisibleSet::Attach(const std::vector<std::shared_ptr<Entity>>& roots) {
+    m_attached = false;
+    m_objectOf.clear();
+    m_entities.clear();
+    m_cell = NONE;
+
+    std::vector<Entity*> objects = CollectObjects(roots);
+    if (objects.size() != m_objectCount || HashObjects(objects) != m_objectHash) {
+        return false;
+    }
+
+    m_objectOf.assign(Registry::EntitySlots(), NONE);
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        m_objectOf[objects[i]->GetId()] = static_cast<std::uint32_t>(i);
+    }
+    m_entities = std::move(objects);
+    m_attached = true;
+    return true;
+}
+
+void PotentiallyVisibleSet::Forget(EntityId id) {
+    if (id < m_objectOf.size() && m_objectOf[id] != NONE) {
+        m_entities[m_objectOf[id]] = nullptr;
+        m_objectOf[id] = NONE;
+    }
+}
+
+std::uint32_t PotentiallyVisibleSet::CellAt(const glm::vec3& position) const {
+    // Checked as floats: a point far away (or NaN) doesn't fit an int
+    const glm::vec3 coordinates = glm::floor((position - m_origin) / m_cellSize);
+    if (!(glm::all(glm::greaterThanEqual(coordinates, glm::vec3(0.0f))) && glm::all(glm::lessThan(coordinates, glm::vec3(m_dimensions))))) {
+        return NONE;
+    }
+    const glm::ivec3 cell = glm::ivec3(coordinates);
+    const std::size_t index = cell.x + static_cast<std::size_t>(m_dimensions.x) * (cell.y + static_cast<std::size_t>(m_dimensions.y) * cell.z);
+    return m_offsets[index] == NONE ? NONE : static_cast<std::uint32_t>(index);
+}
+
+bool PotentiallyVisibleSet::SetViewpoint(const glm::vec3& position) {
+    const std::uint32_t cell = m_attached ? CellAt(position) : NONE;
+    if (cell == NONE) {
+        return false;
+    }
+    if (cell != m_cell) {
+        Decompress(m_offsets[cell], m_row);
+        m_cell = cell;
+    }
+    return true;
+}
+
+std::vector<Entity*> PotentiallyVisibleSet::VisibleEntities(std::uint32_t cell) const {
+    std::vector<Entity*> entities;
+    if (!m_attached || cell >= m_offsets.size() || m_offsets[cell] == NONE) {
+        return entities;
+    }
+
+    std::vector<unsigned char> row;
+    Decompress(m_offsets[cell], row);
+    for (std::size_t i = 0; i < m_entities.size(); ++i) {
+        if (m_entities[i] && (row[i >> 3] >> (i & 7)) & 1) {
+            entities.push_back(m_entities[i]);
+        }
+    }
+    return entities;
+}
@@ -0,0 +1,100 @@
+#include "World/Prefab.hpp"
+#include "World/Entity.hpp"
+#include "World/Component.hpp"
+#include "World/Registry.hpp"
+#include "Core/Debug.hpp"
+
+#include <algorithm>
+#include <typeinfo>
+
+Prefab::Prefab(const Entity& root) {
+    Capture(root, NO_PARENT);
+}
+
+void Prefab::Capture(const Entity& entity, std::uint32_t parent) {
+    const Transform& transform = entity.GetTransform();
+
+    Node node;
+    node.parent = parent;
+    node.position = transform.GetLocalPosition();
+    node.rotation = transform.GetLocalRotation();
+    node.scale = transform.GetLocalScale();
+    node.enabled = entity.IsEnabled();
+    node.isStatic = entity.IsStatic();
+    node.name = entity.GetName();
+    node.tags = entity.GetTags();
+
+    auto capture = [&node](const Component& component) {
+        std::shared_ptr<Component> copy = component.Clone();
+        if (!copy) {
+            Debug::Warning(std::string("Prefab: ") + typeid(component).name() + " can't be cloned, left out");
+            return false;
+        }
+        node.components.push_back(std::move(copy));
+        return true;
+    };
+
+    for (const auto& component : entity.Components()) {
+        if (!capture(*component)) {
+            continue;
+        }
+
+        const ComponentTypeId type = Registry::TypeIdOf(typeid(*component));
+        auto it = std::find_if(m_componentCounts.begin(), m_componentCounts.end(), [type](const auto& count) {
+            return count.first == type;
+        });
+        if (it == m_componentCounts.end()) {
+            m_componentCounts.emplace_back(type, 1);
+        }
+        else {
+            ++it->second;
+        }
+    }
+    for (const auto& script : entity.Scripts()) {
+        capture(*script);
+    }
+
+    const std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.push_back(std::move(node));
+
+    for (const auto& child : entity.GetChildren()) {
+        Capture(*child, index);
+    }
+}
+
+std::shared_ptr<Entity> Prefab::Build() const {
+    if (m_nodes.empty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Entity> root = Entity::Create();
+    std::vector<Entity*> built;
+    built.reserve(m_nodes.size());
+
+    for (const Node& node : m_nodes) {
+        Entity* entity = root.get();
+        if (node.parent != NO_PARENT) {
+            auto child = std::make_unique<Entity>();
+            entity = child.get();
+            built[node.parent]->AddChild(std::move(child));
+        }
+        built.push_back(entity);
+
+        Transform& transform = entity->GetTransform();
+        transform.SetLocalPosition(node.position);
+        transform.SetLocalRotation(node.rotation);
+        transform.SetLocalScale(node.scale);
+        entity->SetEnabled(node.enabled);
+        entity->SetStatic(node.isStatic);
+        entity->SetName(node.name);
+        entity->SetTags(node.tags);
+
+        for (const auto& component : node.components) {
+            if (std::shared_ptr<Component> copy = component->Clone()) {
+                entity->AddComponent(std::move(copy));
+            }
+        }
+    }
+
+    return root;
+}
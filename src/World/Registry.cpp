@@ -0,0 +1,520 @@
+#include "World/Registry.hpp"
+#include "World/Component.hpp"
+#include "World/Entity.hpp"
+#include "World/Scene.hpp"
+#include "Api/PythonComponentWrapper.hpp"
+#include "Core/Debug.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+ComponentTypeId Registry::TypeIdOf(const std::type_info& type) {
+    auto it = s_typeIds.find(type);
+    if (it != s_typeIds.end()) {
+        return it->second;
+    }
+
+    if (s_typeIds.size() >= MAX_COMPONENT_TYPES) {
+        throw std::runtime_error("Registry: too many component types registered");
+    }
+
+    const ComponentTypeId id = static_cast<ComponentTypeId>(s_typeIds.size());
+    s_typeIds.emplace(type, id);
+    SetPhases(id, ALL_PHASES);
+    return id;
+}
+
+ComponentTypeId Registry::TypeIdOf(const std::type_info& type, PhaseMask phases) {
+    const ComponentTypeId id = TypeIdOf(type);
+    SetPhases(id, phases);
+    return id;
+}
+
+void Registry::SetPhases(ComponentTypeId type, PhaseMask phases) {
+    s_phases[type] = phases;
+
+    // Rebuilt in type id order, which is the dispatch order within a phase
+    for (std::size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase) {
+        std::vector<ComponentTypeId>& types = s_phaseTypes[phase];
+        types.clear();
+        for (ComponentTypeId id = 0; id < TypeCount(); ++id) {
+            if (s_phases[id] & PhaseBit(static_cast<UpdatePhase>(phase))) {
+                types.push_back(id);
+            }
+        }
+    }
+}
+
+ComponentTypeId Registry::TypeCount() {
+    return static_cast<ComponentTypeId>(s_typeIds.size());
+}
+
+const std::vector<ComponentTypeId>& Registry::BaseTypes(ComponentTypeId type) {
+    return s_baseTypes[type];
+}
+
+void Registry::AddBaseType(ComponentTypeId type, ComponentTypeId base) {
+    // Keep the list transitively closed so a lookup never has to walk the hierarchy
+    std::vector<ComponentTypeId> added = { base };
+    added.insert(added.end(), s_baseTypes[base].begin(), s_baseTypes[base].end());
+
+    std::vector<ComponentTypeId>& bases = s_baseTypes[type];
+    for (ComponentTypeId id : added) {
+        if (id != type && std::find(bases.begin(), bases.end(), id) == bases.end()) {
+            bases.push_back(id);
+        }
+    }
+}
+
+void Registry::BindPythonType(const void* pyType, ComponentTypeId type) {
+    s_pythonTypeIds[pyType] = type;
+}
+
+bool Registry::FindPythonType(const void* pyType, ComponentTypeId& type) {
+    auto it = s_pythonTypeIds.find(pyType);
+    if (it == s_pythonTypeIds.end()) {
+        return false;
+    }
+
+    type = it->second;
+    return true;
+}
+
+ComponentTypeId Registry::RegisterScriptType(const void* pyType) {
+    ComponentTypeId id;
+    if (FindPythonType(pyType, id)) {
+        return id;
+    }
+
+    id = static_cast<ComponentTypeId>(MAX_COMPONENT_TYPES + s_scriptStorages.size());
+    s_scriptStorages.emplace_back();
+    BindPythonType(pyType, id);
+    return id;
+}
+
+EntityId Registry::CreateEntity(Entity* entity) {
+    EntityId id;
+    if (!s_freeIds.empty()) {
+        id = s_freeIds.back();
+        s_freeIds.pop_back();
+    }
+    else {
+        id = static_cast<EntityId>(s_entities.size());
+        s_entities.emplace_back();
+    }
+
+    // The generation survives the slot being recycled
+    EntityRecord& record = s_entities[id];
+    record.entity = entity;
+    record.scene = nullptr;
+    record.signature.reset();
+    record.enabled = true;
+    record.isStatic = false;
+    record.activeInHierarchy = true;
+    record.staticInHierarchy = false;
+    record.changeTick = 0;
+    MarkChanged(id);
+    return id;
+}
+
+void Registry::DestroyEntity(EntityId entity) {
+    if (entity >= s_entities.size() || s_entities[entity].entity == nullptr) {
+        return;
+    }
+
+    // Last look at a complete entity. Taken before the record: an OnDestroy may create entities.
+    Entity* owner = s_entities[entity].entity;
+    for (ComponentTypeId type = 0; type < TypeCount(); ++type) {
+        if (s_entities[entity].signature.test(type)) {
+            s_storages[type].Get(entity)->OnDestroy();
+        }
+    }
+    for (const auto& script : owner->Scripts()) {
+        script->OnDestroy();
+    }
+
+    EntityRecord& record = s_entities[entity];
+    if (record.scene) {
+        record.scene->OnEntityRemoved(record.entity);
+    }
+
+    for (ComponentTypeId type = 0; type < TypeCount(); ++type) {
+        if (record.signature.test(type)) {
+            s_storages[type].Remove(entity);
+            for (ComponentTypeId base : s_baseTypes[type]) {
+                s_views[base].Remove(entity);
+            }
+        }
+    }
+
+    for (const auto& script : record.entity->Scripts()) {
+        for (ComponentTypeId type : script->TypeIds()) {
+            if (IsScriptType(type)) {
+                s_scriptStorages[type - MAX_COMPONENT_TYPES].Remove(entity);
+            }
+            else {
+                s_views[type].Remove(entity);
+            }
+        }
+        RemovePhaseScripts(script.get());
+    }
+
+    record.entity = nullptr;
+    record.scene = nullptr;
+    record.signature.reset();
+    ++record.generation;
+    s_freeIds.push_back(entity);
+}
+
+void Registry::ReserveEntities(std::size_t count) {
+    if (count > s_freeIds.size()) {
+        s_entities.reserve(s_entities.size() + count - s_freeIds.size());
+    }
+}
+
+// New entities get the recycled ids first, then ids past the end: the sparse arrays are sized for those
+void Registry::ReserveComponents(ComponentTypeId type, std::size_t count, std::size_t entityCount) {
+    const std::size_t fresh = entityCount > s_freeIds.size() ? entityCount - s_freeIds.size() : 0;
+    const EntityId maxEntity = fresh > 0 ? static_cast<EntityId>(s_entities.size() + fresh - 1) : INVALID_ENTITY;
+
+    s_storages[type].Reserve(count, maxEntity);
+    for (ComponentTypeId base : s_baseTypes[type]) {
+        s_views[base].Reserve(count, maxEntity);
+    }
+}
+
+Entity* Registry::GetEntity(EntityId entity) {
+    return entity < s_entities.size() ? s_entities[entity].entity : nullptr;
+}
+
+Scene* Registry::GetScene(EntityId entity) {
+    return entity < s_entities.size() ? s_entities[entity].scene : nullptr;
+}
+
+void Registry::SetScene(EntityId entity, Scene* scene) {
+    if (entity >= s_entities.size() || s_entities[entity].scene == scene) {
+        return;
+    }
+
+    EntityRecord& record = s_entities[entity];
+    if (record.scene) {
+        record.scene->OnEntityRemoved(record.entity);
+    }
+
+    record.scene = scene;
+    if (scene) {
+        scene->OnEntityAdded(record.entity);
+    }
+}
+
+void Registry::SetEnabled(EntityId entity, bool enabled) {
+    EntityRecord& record = s_entities[entity];
+    if (record.enabled == enabled) {
+        return;
+    }
+
+    record.enabled = enabled;
+    InheritFlags(entity);
+    MarkChanged(entity);
+}
+
+void Registry::SetStatic(EntityId entity, bool isStatic) {
+    EntityRecord& record = s_entities[entity];
+    if (record.isStatic == isStatic) {
+        return;
+    }
+
+    record.isStatic = isStatic;
+    InheritFlags(entity);
+}
+
+// Only the toggled subtree is visited, and a child whose inherited flags didn't change stops the walk:
+// its own subtree was resolved against the same values
+void Registry::InheritFlags(EntityId entity) {
+    EntityRecord& record = s_entities[entity];
+    bool active = record.enabled;
+    bool isStatic = record.isStatic;
+    if (Entity* parent = record.entity->GetParent()) {
+        const EntityRecord& parentRecord = s_entities[parent->GetId()];
+        active = active && parentRecord.activeInHierarchy;
+        isStatic = isStatic || parentRecord.staticInHierarchy;
+    }
+
+    record.activeInHierarchy = active;
+    record.staticInHierarchy = isStatic;
+    for (const auto& child : record.entity->GetChildren()) {
+        const EntityRecord& childRecord = s_entities[child->GetId()];
+        if (childRecord.activeInHierarchy != (childRecord.enabled && active)
+            || childRecord.staticInHierarchy != (childRecord.isStatic || isStatic)) {
+            InheritFlags(child->GetId());
+        }
+    }
+}
+
+void Registry::MarkTransformDirty(EntityId entity) {
+    std::lock_guard<std::mutex> lock(s_dirtyMutex);
+    s_dirtyTransforms.push_back(entity);
+}
+
+void Registry::MarkChanged(EntityId entity) {
+    std::lock_guard<std::mutex> lock(s_changeMutex);
+    LogChange(entity);
+}
+
+// One lock for the lot, the scene logs its recomputed transforms this way
+void Registry::MarkChanged(const std::vector<Entity*>& entities, std::size_t first) {
+    std::lock_guard<std::mutex> lock(s_changeMutex);
+    for (std::size_t i = first; i < entities.size(); ++i) {
+        LogChange(entities[i]->GetId());
+    }
+}
+
+void Registry::LogChange(EntityId entity) {
+    EntityRecord& record = s_entities[entity];
+    if (record.changeTick != s_changeTick || record.changePosition < s_changeRead) {
+        std::vector<EntityId>& log = s_changeLog.back();
+        record.changeTick = s_changeTick;
+        record.changePosition = static_cast<std::uint32_t>(log.size());
+        log.push_back(entity);
+    }
+}
+
+void Registry::NextTick() {
+    std::lock_guard<std::mutex> lock(s_changeMutex);
+    ++s_changeTick;
+    s_changeRead = 0;
+
+    // The oldest tick is dropped (its vector reused) once the history is full
+    if (s_changeLog.size() >= CHANGE_HISTORY) {
+        std::vector<EntityId> reused = std::move(s_changeLog.front());
+        s_changeLog.pop_front();
+        ++s_changeLogBegin;
+        reused.clear();
+        s_changeLog.push_back(std::move(reused));
+    }
+    else {
+        s_changeLog.emplace_back();
+    }
+}
+
+bool Registry::ConsumeChanges(ChangeCursor& cursor, std::vector<EntityId>& out) {
+    std::lock_guard<std::mutex> lock(s_changeMutex);
+    const bool complete = cursor.tick != 0 && cursor.tick >= s_changeLogBegin;
+
+    if (complete) {
+        for (ChangeTick tick = cursor.tick; tick <= s_changeTick; ++tick) {
+            const std::vector<EntityId>& log = s_changeLog[tick - s_changeLogBegin];
+            for (std::size_t i = tick == cursor.tick ? cursor.position : 0; i < log.size(); ++i) {
+                // An entity changed again later is listed under its last entry only
+                const EntityRecord& record = s_entities[log[i]];
+                if (record.changeTick == tick && record.changePosition == i && record.entity) {
+                    out.push_back(log[i]);
+                }
+            }
+        }
+    }
+
+    cursor.tick = s_changeTick;
+    cursor.position = static_cast<std::uint32_t>(s_changeLog.back().size());
+    s_changeRead = cursor.position;
+    return complete;
+}
+
+const ComponentSignature& Registry::Signature(EntityId entity) {
+    return s_entities[entity].signature;
+}
+
+bool Registry::AddComponent(EntityId entity, std::shared_ptr<Component> component) {
+    const ComponentTypeId type = TypeIdOf(typeid(*component));
+    if (s_storages[type].Contains(entity)) {
+        Debug::Warning(std::string("Registry: entity already has a ") + typeid(*component).name() + ", remove it before adding another");
+        return false;
+    }
+
+    // The latest native component of a base type is the one the base view points at
+    for (ComponentTypeId base : s_baseTypes[type]) {
+        s_views[base].Remove(entity);
+        s_views[base].Insert(entity, component);
+    }
+
+    s_storages[type].Insert(entity, std::move(component));
+    s_entities[entity].signature.set(type);
+    MarkChanged(entity);
+
+    if (Scene* scene = s_entities[entity].scene) {
+        scene->OnComponentAdded(s_entities[entity].entity);
+    }
+    return true;
+}
+
+std::shared_ptr<Component> Registry::RemoveComponent(EntityId entity, ComponentTypeId type) {
+    EntityRecord& record = s_entities[entity];
+
+    for (ComponentTypeId concrete = 0; concrete < TypeCount(); ++concrete) {
+        const auto& bases = s_baseTypes[concrete];
+        if (!record.signature.test(concrete) || (concrete != type && std::find(bases.begin(), bases.end(), type) == bases.end())) {
+            continue;
+        }
+
+        std::shared_ptr<Component> removed = s_storages[concrete].Remove(entity);
+        record.signature.reset(concrete);
+        MarkChanged(entity);
+
+        // A base view may now have to point at another component of the entity sharing that base
+        for (ComponentTypeId base : bases) {
+            if (s_views[base].Get(entity) != removed.get()) {
+                continue;
+            }
+
+            s_views[base].Remove(entity);
+            RefillView(entity, base);
+        }
+
+        if (record.scene) {
+            record.scene->OnComponentRemoved(record.entity);
+        }
+        return removed;
+    }
+
+    return nullptr;
+}
+
+void Registry::RefillView(EntityId entity, ComponentTypeId base, const PythonComponentWrapper* removed) {
+    const EntityRecord& record = s_entities[entity];
+
+    for (ComponentTypeId type = 0; type < TypeCount(); ++type) {
+        const auto& bases = s_baseTypes[type];
+        if (record.signature.test(type) && std::find(bases.begin(), bases.end(), base) != bases.end()) {
+            s_views[base].Insert(entity, s_storages[type].GetShared(entity));
+            return;
+        }
+    }
+
+    for (const auto& script : record.entity->Scripts()) {
+        const auto& ids = script->TypeIds();
+        if (script.get() != removed && script->NativeComponent() && std::find(ids.begin(), ids.end(), base) != ids.end()) {
+            s_views[base].Insert(entity, script->NativeComponent());
+            return;
+        }
+    }
+}
+
+ComponentStorage* Registry::Lookup(ComponentTypeId type, EntityId entity) {
+    if (IsScriptType(type)) {
+        const std::size_t index = type - MAX_COMPONENT_TYPES;
+        return index < s_scriptStorages.size() ? &s_scriptStorages[index] : nullptr;
+    }
+
+    if (s_storages[type].Contains(entity)) {
+        return &s_storages[type];
+    }
+
+    return &s_views[type];
+}
+
+Component* Registry::GetComponent(EntityId entity, ComponentTypeId type) {
+    ComponentStorage* storage = Lookup(type, entity);
+    return storage ? storage->Get(entity) : nullptr;
+}
+
+std::shared_ptr<Component> Registry::GetSharedComponent(EntityId entity, ComponentTypeId type) {
+    ComponentStorage* storage = Lookup(type, entity);
+    return storage ? storage->GetShared(entity) : nullptr;
+}
+
+ComponentStorage& Registry::Storage(ComponentTypeId type) {
+    return s_storages[type];
+}
+
+void Registry::AddScript(EntityId entity, const std::shared_ptr<PythonComponentWrapper>& script) {
+    for (ComponentTypeId type : script->TypeIds()) {
+        if (IsScriptType(type)) {
+            ComponentStorage& storage = s_scriptStorages[type - MAX_COMPONENT_TYPES];
+            // First instance of a class wins, like a scan in attachment order would
+            if (!storage.Contains(entity)) {
+                storage.Insert(entity, script);
+            }
+        }
+        else if (script->NativeComponent() && !s_views[type].Contains(entity)) {
+            s_views[type].Insert(entity, script->NativeComponent());
+        }
+    }
+
+    for (std::size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase) {
+        if (script->Phases() & PhaseBit(static_cast<UpdatePhase>(phase))) {
+            script->SetPhaseSlot(static_cast<UpdatePhase>(phase), static_cast<std::uint32_t>(s_phaseScripts[phase].size()));
+            s_phaseScripts[phase].push_back(script.get());
+        }
+    }
+
+    if (Scene* scene = s_entities[entity].scene) {
+        scene->OnComponentAdded(s_entities[entity].entity);
+    }
+}
+
+void Registry::RemoveScript(EntityId entity, const PythonComponentWrapper* script) {
+    EntityRecord& record = s_entities[entity];
+
+    for (ComponentTypeId type : script->TypeIds()) {
+        if (!IsScriptType(type)) {
+            if (script->NativeComponent() && s_views[type].Get(entity) == script->NativeComponent().get()) {
+                s_views[type].Remove(entity);
+                RefillView(entity, type, script);
+            }
+            continue;
+        }
+
+        ComponentStorage& storage = s_scriptStorages[type - MAX_COMPONENT_TYPES];
+        if (storage.Get(entity) != script) {
+            continue;
+        }
+
+        // Another instance of the same class takes over, in attachment order
+        storage.Remove(entity);
+        for (const auto& other : record.entity->Scripts()) {
+            const auto& ids = other->TypeIds();
+            if (other.get() != script && std::find(ids.begin(), ids.end(), type) != ids.end()) {
+                storage.Insert(entity, other);
+                break;
+            }
+        }
+    }
+
+    RemovePhaseScripts(script);
+
+    if (record.scene) {
+        record.scene->OnComponentRemoved(record.entity);
+    }
+}
+
+// O(1) per script: the slot is cleared, CompactScripts packs the lists later
+void Registry::RemovePhaseScripts(const PythonComponentWrapper* script) {
+    for (std::size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase) {
+        std::vector<PythonComponentWrapper*>& scripts = s_phaseScripts[phase];
+        const std::uint32_t slot = script->PhaseSlot(static_cast<UpdatePhase>(phase));
+        if (slot < scripts.size() && scripts[slot] == script) {
+            scripts[slot] = nullptr;
+            s_scriptHoles = true;
+        }
+    }
+}
+
+void Registry::CompactScripts() {
+    if (!s_scriptHoles) {
+        return;
+    }
+
+    for (std::size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase) {
+        std::vector<PythonComponentWrapper*>& scripts = s_phaseScripts[phase];
+        std::size_t kept = 0;
+        for (PythonComponentWrapper* script : scripts) {
+            if (script) {
+                script->SetPhaseSlot(static_cast<UpdatePhase>(phase), static_cast<std::uint32_t>(kept));
+                scripts[kept++] = script;
+            }
+        }
+        scripts.resize(kept);
+    }
+    s_scriptHoles = false;
+}
+
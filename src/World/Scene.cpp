@@ -1,25 +1,476 @@
 #include "World/Scene.hpp"
 #include "World/Component.hpp"
+#include "World/Registry.hpp"
+#include "World/Camera.hpp"
+#include "World/SceneFile.hpp"
+#include "World/Mesh/RenderComponent.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Window.hpp"
+#include "Core/EventBus.hpp"
+#include "Core/Events.hpp"
+#include "Core/Time.hpp"
+#include "Core/Debug.hpp"
+
+#include <fstream>
+
+Scene::~Scene() {
+    for (const auto& entity : m_rootEntities) {
+        if (entity->GetScene() == this) {
+            entity->SetScene(nullptr);
+        }
+    }
+}
+
+Scene::Scene(const Scene& other) : m_rootEntities(other.m_rootEntities), m_pvs(other.m_pvs), m_scheduler(other.m_scheduler) {
+    IndexRoots();
+    for (const auto& entity : m_rootEntities) {
+        entity->SetScene(this);
+    }
+}
+
+Scene& Scene::operator=(const Scene& other) {
+    if (this != &other) {
+        for (const auto& entity : m_rootEntities) {
+            if (entity->GetScene() == this) {
+                entity->SetScene(nullptr);
+            }
+        }
+
+        m_rootEntities = other.m_rootEntities;
+        m_scheduler = other.m_scheduler;
+        m_bvh.Clear();
+        m_bvhChangesRead = ChangeCursor();
+        m_pvs = other.m_pvs;
+        IndexRoots();
+        for (const auto& entity : m_rootEntities) {
+            entity->SetScene(this);
+        }
+    }
+    return *this;
+}
+
+void Scene::IndexRoots() {
+    m_rootSlots.clear();
+    for (std::size_t i = 0; i < m_rootEntities.size(); ++i) {
+        const EntityId id = m_rootEntities[i]->GetId();
+        if (id >= m_rootSlots.size()) {
+            m_rootSlots.resize(id + 1, 0);
+        }
+        m_rootSlots[id] = static_cast<std::uint32_t>(i);
+    }
+}
 
 void Scene::AddEntity(std::shared_ptr<Entity> entity) {
     if (entity->GetParent() == nullptr) {
+        const EntityId id = entity->GetId();
+        if (id >= m_rootSlots.size()) {
+            m_rootSlots.resize(id + 1, 0);
+        }
+        m_rootSlots[id] = static_cast<std::uint32_t>(m_rootEntities.size());
+
+        entity->SetScene(this);
         m_rootEntities.push_back(entity);
     }
 }
 
+void Scene::RemoveEntity(const Entity* entity) {
+    const EntityId id = entity->GetId();
+    if (id >= m_rootSlots.size()) {
+        return;
+    }
+
+    const std::uint32_t slot = m_rootSlots[id];
+    if (slot >= m_rootEntities.size() || m_rootEntities[slot].get() != entity) {
+        return;
+    }
+
+    std::shared_ptr<Entity> root = std::move(m_rootEntities[slot]);
+    if (slot + 1 != m_rootEntities.size()) {
+        m_rootEntities[slot] = std::move(m_rootEntities.back());
+        m_rootSlots[m_rootEntities[slot]->GetId()] = slot;
+    }
+    m_rootEntities.pop_back();
+
+    if (root->GetScene() == this) {
+        root->SetScene(nullptr);
+    }
+}
+
 const std::vector<std::shared_ptr<Entity>>& Scene::GetRootEntities() const {
     return m_rootEntities;
 }
 
+std::vector<EntityHandle> Scene::Instantiate(const Prefab& prefab, const float* transforms, std::size_t count, std::size_t stride) {
+    std::vector<EntityHandle> instances;
+    if (prefab.Size() == 0 || count == 0) {
+        return instances;
+    }
+
+    const std::size_t entityCount = prefab.Size() * count;
+    Registry::ReserveEntities(entityCount);
+    // Children come from the Entity pool, roots (and their shared_ptr control block) from Entity::Create's
+    ComponentPool<Entity>::Reserve(entityCount - count);
+    ComponentPool<Transform>::Reserve(entityCount);
+    for (const auto& [type, perInstance] : prefab.ComponentCounts()) {
+        Registry::ReserveComponents(type, perInstance * count, entityCount);
+    }
+    m_rootEntities.reserve(m_rootEntities.size() + count);
+    instances.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::shared_ptr<Entity> root = prefab.Build();
+
+        const float* row = transforms + i * stride;
+        Transform& transform = root->GetTransform();
+        transform.SetLocalPosition({ row[0], row[1], row[2] });
+        if (stride >= 6) {
+            transform.SetLocalRotation({ row[3], row[4], row[5] });
+        }
+        if (stride >= 9) {
+            transform.SetLocalScale({ row[6], row[7], row[8] });
+        }
+
+        instances.push_back(root->GetHandle());
+        AddEntity(root);
+
+        // Same as components added through the command buffer
+        if (m_isStarted) {
+            root->Start();
+        }
+    }
+
+    return instances;
+}
+
+SceneQuery& Scene::Query(std::vector<ComponentTypeId> types) {
+    std::sort(types.begin(), types.end());
+    types.erase(std::unique(types.begin(), types.end()), types.end());
+
+    for (const auto& query : m_queries) {
+        if (query->Types() == types) {
+            return *query;
+        }
+    }
+
+    m_queries.push_back(std::make_unique<SceneQuery>(std::move(types)));
+    SceneQuery& query = *m_queries.back();
+    for (const auto& entity : m_rootEntities) {
+        CollectMatches(query, entity.get());
+    }
+    return query;
+}
+
+void Scene::CollectMatches(SceneQuery& query, Entity* entity) const {
+    if (query.Matches(*entity)) {
+        query.Add(entity);
+    }
+
+    for (const auto& child : entity->GetChildren()) {
+        CollectMatches(query, child.get());
+    }
+}
+
+void Scene::OnEntityAdded(Entity* entity) {
+    m_index.Add(entity);
+    EventBus::Publish(EntitySpawnedEvent{ entity->GetHandle() });
+    for (const auto& query : m_queries) {
+        if (query->Matches(*entity)) {
+            query->Add(entity);
+        }
+    }
+}
+
+void Scene::OnEntityRemoved(Entity* entity) {
+    m_index.Remove(entity);
+    m_bvh.Remove(entity->GetId());
+    if (m_pvs) {
+        m_pvs->Forget(entity->GetId());
+    }
+    for (const auto& query : m_queries) {
+        query->Remove(entity);
+    }
+}
+
+void Scene::OnComponentAdded(Entity* entity) {
+    for (const auto& query : m_queries) {
+        if (!query->Contains(entity->GetId()) && query->Matches(*entity)) {
+            query->Add(entity);
+        }
+    }
+}
+
+void Scene::OnEntityRenamed(Entity* entity, const std::string& previous) {
+    m_index.Rename(entity, previous);
+}
+
+void Scene::OnEntityRetagged(Entity* entity, TagMask previous) {
+    m_index.Retag(entity, previous);
+}
+
+void Scene::OnComponentRemoved(Entity* entity) {
+    for (const auto& query : m_queries) {
+        if (query->Contains(entity->GetId()) && !query->Matches(*entity)) {
+            query->Remove(entity);
+        }
+    }
+}
+
+SceneSnapshot Scene::Snapshot(const SceneSnapshot* previous) const {
+    SceneSnapshot snapshot;
+    snapshot.Capture(*this, previous);
+    return snapshot;
+}
+
+void Scene::Restore(const SceneSnapshot& snapshot) {
+    snapshot.Apply(*this);
+}
+
+void Scene::Save(const std::string& path) const {
+    SceneFile::Write(*this, path);
+    if (m_pvs) {
+        m_pvs->Save(path + ".pvs");
+    }
+}
+
+std::vector<EntityHandle> Scene::Load(const std::string& path) {
+    const std::vector<std::shared_ptr<Entity>> roots = SceneFile::Read(path);
+
+    std::vector<EntityHandle> handles;
+    handles.reserve(roots.size());
+    m_rootEntities.reserve(m_rootEntities.size() + roots.size());
+    for (const auto& root : roots) {
+        handles.push_back(root->GetHandle());
+        AddEntity(root);
+        if (m_isStarted) {
+            root->Start();
+        }
+    }
+
+    // The PVS is a cache: a broken or stale one only costs the culling it would have done
+    const std::string pvsPath = path + ".pvs";
+    if (std::ifstream(pvsPath).good()) {
+        auto pvs = std::make_shared<PotentiallyVisibleSet>();
+        try {
+            pvs->Load(pvsPath);
+        }
+        catch (const std::exception& e) {
+            Debug::Warning(std::string("Scene: loaded without its PVS, ") + e.what());
+            return handles;
+        }
+
+        // Matched against the meshes of this file only, whatever else the scene holds
+        if (pvs->Attach(roots)) {
+            m_pvs = std::move(pvs);
+        }
+        else {
+            Debug::Warning("Scene: '" + pvsPath + "' doesn't match the scene, baked for another version of the level?");
+        }
+    }
+    return handles;
+}
+
+PotentiallyVisibleSet& Scene::BakePvs(const PotentiallyVisibleSet::Settings& settings) {
+    auto pvs = std::make_shared<PotentiallyVisibleSet>();
+    pvs->Bake(*this, settings);
+    m_pvs = std::move(pvs);
+    return *m_pvs;
+}
+
+bool Scene::SetPvs(std::shared_ptr<PotentiallyVisibleSet> pvs) {
+    if (pvs && !pvs->Attach(*this)) {
+        m_pvs.reset();
+        return false;
+    }
+    m_pvs = std::move(pvs);
+    return true;
+}
+
 void Scene::Start() {
+    m_isStarted = true;
     for (const auto& entity : m_rootEntities) {
         entity->Start();
     }
 }
 
+// Only dirty transforms and their descendants are recomputed. Entities queued by another
+// scene (or not in any scene yet) are kept for later.
+void Scene::UpdateTransforms() {
+    std::vector<EntityId>& dirty = Registry::DirtyTransforms();
+    const std::size_t firstChanged = m_changedEntities.size();
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < dirty.size(); ++i) {
+        Entity* entity = Registry::GetEntity(dirty[i]);
+        if (!entity || !entity->GetTransform().IsDirty()) {
+            continue;
+        }
+
+        // Disabled subtrees keep their entries until they are enabled again
+        if (entity->GetScene() != this || !entity->IsActive()) {
+            dirty[kept++] = dirty[i];
+            continue;
+        }
+
+        // Start from the topmost dirty ancestor so a child is never computed from a stale parent
+        Entity* root = entity;
+        for (Entity* parent = entity->GetParent(); parent; parent = parent->GetParent()) {
+            if (parent->GetTransform().IsDirty()) {
+                root = parent;
+            }
+        }
+        root->UpdateTransforms(m_changedEntities);
+    }
+    dirty.resize(kept);
+
+    Registry::MarkChanged(m_changedEntities, firstChanged);
+}
+
+namespace {
+    Aabb WorldBounds(const Entity& entity, const RenderComponent& mesh) {
+        return mesh.LocalBounds().Transformed(entity.GetTransform().GetModelMatrix());
+    }
+}
+
+BoundingVolumeHierarchy& Scene::GetBvh() {
+    m_bvhChanges.clear();
+
+    // First use or history lost: built again from every mesh of the scene
+    if (!Registry::ConsumeChanges(m_bvhChangesRead, m_bvhChanges)) {
+        std::vector<std::pair<Entity*, Aabb>> entities;
+        for (Entity* entity : Query<RenderComponent>()) {
+            const Aabb bounds = WorldBounds(*entity, *entity->GetComponent<RenderComponent>());
+            if (!bounds.IsEmpty()) {
+                entities.emplace_back(entity, bounds);
+            }
+        }
+        m_bvh.Build(entities);
+        return m_bvh;
+    }
+
+    for (EntityId id : m_bvhChanges) {
+        Entity* entity = Registry::GetEntity(id);
+        if (entity->GetScene() != this) {
+            continue;
+        }
+
+        const RenderComponent* mesh = entity->GetComponent<RenderComponent>();
+        const Aabb bounds = mesh ? WorldBounds(*entity, *mesh) : Aabb();
+        if (bounds.IsEmpty()) {
+            m_bvh.Remove(id);
+        }
+        else {
+            m_bvh.Set(entity, bounds);
+        }
+    }
+    m_bvh.Refit();
+    return m_bvh;
+}
+
+const std::vector<Entity*>& Scene::GetChangedEntities() const {
+    return m_changedEntities;
+}
+
+void Scene::BeginFrame() {
+    m_changedEntities.clear();
+}
+
+// Native components of the types overriding the phase, one packed storage at a time, split across
+// the JobSystem workers. A native update may only touch its own component and entity.
+void Scene::DispatchNative(UpdatePhase phase, void (Component::*method)()) {
+    for (ComponentTypeId type : Registry::PhaseTypes(phase)) {
+        const ComponentStorage& storage = Registry::Storage(type);
+        JobSystem::ParallelFor(storage.Size(), UPDATE_GRAIN, [this, &storage, method](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const EntityId entity = storage.Entities()[i];
+                if (Registry::GetScene(entity) != this || !Registry::IsUpdated(entity)) {
+                    continue;
+                }
+
+                try {
+                    (storage.Components()[i].get()->*method)();
+                }
+                catch (const std::exception& e) {
+                    Debug::Error(std::string("Scene: native component update failed, ") + e.what());
+                }
+            }
+        });
+    }
+}
+
+// Python components stay on the main thread, which holds the GIL
+void Scene::DispatchScripts(UpdatePhase phase, void (PythonComponentWrapper::*method)()) {
+    const auto& scripts = Registry::Scripts(phase);
+    for (std::size_t i = 0; i < scripts.size(); ++i) {
+        PythonComponentWrapper* script = scripts[i];
+        if (!script) {
+            continue;
+        }
+
+        const EntityId entity = script->GetOwnerHandle().index;
+        if (Registry::GetScene(entity) == this && Registry::IsUpdated(entity)) {
+            (script->*method)();
+        }
+    }
+}
+
+void Scene::FixedUpdate() {
+    // What moved during the previous step is at rest until this step moves it again
+    m_interpolatedEntities.clear();
+    for (EntityHandle handle : m_interpolated) {
+        if (Entity* entity = Registry::Resolve(handle)) {
+            entity->GetTransform().ResetInterpolation();
+            m_interpolatedEntities.push_back(entity);
+        }
+    }
+    Registry::MarkChanged(m_interpolatedEntities);
+    m_interpolated.clear();
+
+    DispatchNative(UpdatePhase::FixedUpdate, &Component::FixedUpdate);
+    DispatchScripts(UpdatePhase::FixedUpdate, &PythonComponentWrapper::FixedUpdate);
+
+    const std::size_t first = m_changedEntities.size();
+    UpdateTransforms();
+    for (std::size_t i = first; i < m_changedEntities.size(); ++i) {
+        m_interpolated.push_back(m_changedEntities[i]->GetHandle());
+    }
+}
+
 void Scene::Update() {
-    for (const auto& entity : m_rootEntities) {
-        entity->Update();
+    UpdateTransforms();
+
+    DispatchNative(UpdatePhase::Update, &Component::Update);
+
+    // Python updates are the expensive ones: the scheduler spreads them by priority and distance
+    Camera* camera = GetActiveCamera();
+    const Entity* viewer = camera ? camera->GetOwner() : nullptr;
+    const glm::vec3 position = viewer ? viewer->GetTransform().GetGlobalPosition() : glm::vec3(0.0f);
+    m_scheduler.Run(Registry::Scripts(UpdatePhase::Update), this, viewer ? &position : nullptr, Time::DeltaTime());
+}
+
+Camera* Scene::GetActiveCamera() {
+    for (Entity* entity : Query<Camera>()) {
+        if (entity->IsActive()) {
+            return entity->GetComponent<Camera>();
+        }
+    }
+    return nullptr;
+}
+
+// Runs on up to date world matrices, so followers see where their targets ended up this frame
+void Scene::LateUpdate() {
+    UpdateTransforms();
+
+    DispatchNative(UpdatePhase::LateUpdate, &Component::LateUpdate);
+    DispatchScripts(UpdatePhase::LateUpdate, &PythonComponentWrapper::LateUpdate);
+}
+
+void Scene::InterpolateTransforms(float alpha) {
+    m_interpolatedEntities.clear();
+    for (EntityHandle handle : m_interpolated) {
+        if (Entity* entity = Registry::Resolve(handle)) {
+            entity->GetTransform().Interpolate(alpha);
+            m_interpolatedEntities.push_back(entity);
+        }
     }
+    Registry::MarkChanged(m_interpolatedEntities);
 }
@@ -0,0 +1,698 @@
+#include "World/SceneFile.hpp"
+#include "World/Scene.hpp"
+#include "World/Entity.hpp"
+#include "World/Registry.hpp"
+#include "World/Camera.hpp"
+#include "World/Mesh/CuboidMesh.hpp"
+#include "World/Mesh/SphereMesh.hpp"
+#include "World/Mesh/CapsuleMesh.hpp"
+#include "World/Mesh/3DModel/Model.hpp"
+#include "Graphics/Sprite.hpp"
+#include "Api/PythonComponentWrapper.hpp"
+#include "Core/AssetsManager.hpp"
+#include "Core/Debug.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    constexpr std::size_t ALIGNMENT = 8;
+
+    std::size_t Align(std::size_t offset) {
+        return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    template<typename T>
+    void Append(std::vector<unsigned char>& out, const T& value) {
+        const std::size_t offset = out.size();
+        out.resize(offset + sizeof(T));
+        std::memcpy(&out[offset], &value, sizeof(T));
+    }
+
+    // Each string is stored once, records refer to it by index
+    class StringTable {
+        public:
+            std::uint32_t Add(const std::string& value) {
+                auto [it, inserted] = m_indices.emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+                if (inserted) {
+                    m_strings.push_back(&it->first);
+                }
+                return it->second;
+            }
+
+            // [offset, length] per string, then the characters
+            void Write(std::vector<unsigned char>& out) const {
+                std::uint32_t offset = 0;
+                for (const std::string* value : m_strings) {
+                    Append(out, offset);
+                    Append(out, static_cast<std::uint32_t>(value->size()));
+                    offset += static_cast<std::uint32_t>(value->size());
+                }
+                for (const std::string* value : m_strings) {
+                    out.insert(out.end(), value->begin(), value->end());
+                }
+            }
+
+            std::size_t Size() const {
+                return m_strings.size();
+            }
+
+        private:
+            std::unordered_map<std::string, std::uint32_t> m_indices;
+            std::vector<const std::string*> m_strings;
+    };
+
+    // Python components deriving from a render component hold the texture on their native part
+    template<typename C>
+    C* NativePart(C* component) {
+        if (auto* script = dynamic_cast<const PythonComponentWrapper*>(component)) {
+            return script->NativeComponent().get();
+        }
+        return component;
+    }
+
+    // "module:QualifiedName" of a Python component's class
+    std::string PythonClassName(const py::handle& type) {
+        return py::str(type.attr("__module__")).cast<std::string>() + ":" + py::str(type.attr("__qualname__")).cast<std::string>();
+    }
+
+    // The class of a Python component, only looked up in the modules the game already imported: a
+    // file never imports anything. Null when it isn't there or isn't a component class.
+    py::object FindPythonClass(const std::string& name) {
+        const std::size_t colon = name.find(':');
+        py::dict modules = py::module_::import("sys").attr("modules");
+        if (colon == std::string::npos || !modules.contains(name.substr(0, colon))) {
+            return py::object();
+        }
+        py::object object = modules[name.substr(0, colon).c_str()];
+
+        std::size_t begin = colon + 1;
+        while (begin <= name.size()) {
+            std::size_t end = name.find('.', begin);
+            if (end == std::string::npos) {
+                end = name.size();
+            }
+            const std::string attribute = name.substr(begin, end - begin);
+            if (!py::hasattr(object, attribute.c_str())) {
+                return py::object();
+            }
+            object = object.attr(attribute.c_str());
+            begin = end + 1;
+        }
+
+        if (!PyType_Check(object.ptr()) || !PyObject_IsSubclass(object.ptr(), py::type::of<Component>().ptr())) {
+            return py::object();
+        }
+        return object;
+    }
+
+    // Python component state, as plain data only: restoring it runs no code of the file's choosing.
+    // A tag byte, then for ints and floats 8 bytes, for str and bytes a length and the bytes, for
+    // list, tuple and dict a count and the items (keys and values alternating).
+    enum StateTag : unsigned char {
+        STATE_NONE,
+        STATE_FALSE,
+        STATE_TRUE,
+        STATE_INT,
+        STATE_FLOAT,
+        STATE_STR,
+        STATE_BYTES,
+        STATE_LIST,
+        STATE_TUPLE,
+        STATE_DICT
+    };
+
+    // Deeper is a cycle or a crafted file
+    constexpr int MAX_STATE_DEPTH = 64;
+
+    // Throws for the values that aren't plain data (classes, engine objects...), and ints beyond 64 bits
+    void EncodeState(const py::handle& value, std::vector<unsigned char>& out, int depth = 0) {
+        if (depth > MAX_STATE_DEPTH) {
+            throw std::runtime_error("nested too deep");
+        }
+
+        const auto appendSize = [&out](std::size_t size) {
+            if (size > 0xFFFFFFFFu) {
+                throw std::runtime_error("too large");
+            }
+            Append(out, static_cast<std::uint32_t>(size));
+        };
+
+        if (value.is_none()) {
+            out.push_back(STATE_NONE);
+        }
+        else if (py::isinstance<py::bool_>(value)) {
+            out.push_back(value.cast<bool>() ? STATE_TRUE : STATE_FALSE);
+        }
+        else if (py::isinstance<py::int_>(value)) {
+            out.push_back(STATE_INT);
+            Append(out, value.cast<std::int64_t>());
+        }
+        else if (py::isinstance<py::float_>(value)) {
+            out.push_back(STATE_FLOAT);
+            Append(out, value.cast<double>());
+        }
+        else if (py::isinstance<py::str>(value) || py::isinstance<py::bytes>(value)) {
+            const bool text = py::isinstance<py::str>(value);
+            const std::string bytes = text ? value.cast<std::string>() : std::string(value.cast<py::bytes>());
+            out.push_back(text ? STATE_STR : STATE_BYTES);
+            appendSize(bytes.size());
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+        else if (py::isinstance<py::list>(value) || py::isinstance<py::tuple>(value)) {
+            py::sequence items = py::reinterpret_borrow<py::sequence>(value);
+            out.push_back(py::isinstance<py::list>(value) ? STATE_LIST : STATE_TUPLE);
+            appendSize(items.size());
+            for (const py::handle& item : items) {
+                EncodeState(item, out, depth + 1);
+            }
+        }
+        else if (py::isinstance<py::dict>(value)) {
+            py::dict items = py::reinterpret_borrow<py::dict>(value);
+            out.push_back(STATE_DICT);
+            appendSize(items.size());
+            for (const auto& [key, item] : items) {
+                EncodeState(key, out, depth + 1);
+                EncodeState(item, out, depth + 1);
+            }
+        }
+        else {
+            throw std::runtime_error(py::str(py::type::handle_of(value).attr("__name__")).cast<std::string>() + " is not plain data");
+        }
+    }
+
+    // Throws when the bytes don't hold one complete value
+    py::object DecodeState(const unsigned char*& data, const unsigned char* end, int depth = 0) {
+        if (depth > MAX_STATE_DEPTH) {
+            throw std::runtime_error("nested too deep");
+        }
+
+        const auto read = [&data, end](void* out, std::size_t size) {
+            if (static_cast<std::size_t>(end - data) < size) {
+                throw std::runtime_error("truncated");
+            }
+            std::memcpy(out, data, size);
+            data += size;
+        };
+        const auto readSize = [&read]() {
+            std::uint32_t size;
+            read(&size, sizeof(size));
+            return std::size_t(size);
+        };
+
+        unsigned char tag;
+        read(&tag, 1);
+        switch (tag) {
+            case STATE_NONE:
+                return py::none();
+            case STATE_FALSE:
+            case STATE_TRUE:
+                return py::bool_(tag == STATE_TRUE);
+            case STATE_INT: {
+                std::int64_t value;
+                read(&value, sizeof(value));
+                return py::int_(value);
+            }
+            case STATE_FLOAT: {
+                double value;
+                read(&value, sizeof(value));
+                return py::float_(value);
+            }
+            case STATE_STR:
+            case STATE_BYTES: {
+                const std::size_t size = readSize();
+                if (static_cast<std::size_t>(end - data) < size) {
+                    throw std::runtime_error("truncated");
+                }
+                const char* bytes = reinterpret_cast<const char*>(data);
+                data += size;
+                if (tag == STATE_STR) {
+                    return py::str(bytes, size);
+                }
+                return py::bytes(bytes, size);
+            }
+            case STATE_LIST:
+            case STATE_TUPLE: {
+                // Every item takes at least its tag: a count past the data is a broken file
+                const std::size_t size = readSize();
+                if (static_cast<std::size_t>(end - data) < size) {
+                    throw std::runtime_error("truncated");
+                }
+                py::list items;
+                for (std::size_t i = 0; i < size; ++i) {
+                    items.append(DecodeState(data, end, depth + 1));
+                }
+                if (tag == STATE_TUPLE) {
+                    return py::tuple(items);
+                }
+                return std::move(items);
+            }
+            case STATE_DICT: {
+                const std::size_t size = readSize();
+                if (static_cast<std::size_t>(end - data) < size * 2) {
+                    throw std::runtime_error("truncated");
+                }
+                py::dict items;
+                for (std::size_t i = 0; i < size; ++i) {
+                    py::object key = DecodeState(data, end, depth + 1);
+                    items[key] = DecodeState(data, end, depth + 1);
+                }
+                return std::move(items);
+            }
+            default:
+                throw std::runtime_error("unknown value tag " + std::to_string(tag));
+        }
+    }
+}
+
+std::vector<SceneFile::Entry>& SceneFile::Entries() {
+    static std::vector<Entry> entries = [] {
+        Codec sphere;
+        sphere.save = [](const Component& component, std::vector<unsigned char>& out) {
+            const auto& mesh = static_cast<const SphereMesh&>(component);
+            Append(out, mesh.GetSectorCount());
+            Append(out, mesh.GetStackCount());
+        };
+        sphere.load = [](const std::string&, const unsigned char* data, std::size_t size) -> std::shared_ptr<Component> {
+            unsigned int counts[2] = { 36, 18 };
+            if (size == sizeof(counts)) {
+                std::memcpy(counts, data, sizeof(counts));
+            }
+            return ComponentPool<SphereMesh>::Create(counts[0], counts[1]);
+        };
+
+        struct CapsuleShape {
+            float radius;
+            float cylinderHeight;
+            unsigned int sectorCount;
+            unsigned int hemisphereStacks;
+            unsigned int cylinderStacks;
+        };
+        Codec capsule;
+        capsule.save = [](const Component& component, std::vector<unsigned char>& out) {
+            const auto& mesh = static_cast<const CapsuleMesh&>(component);
+            Append(out, CapsuleShape { mesh.GetRadius(), mesh.GetCylinderHeight(), mesh.GetSectorCount(), mesh.GetHemisphereStacks(), mesh.GetCylinderStacks() });
+        };
+        capsule.load = [](const std::string&, const unsigned char* data, std::size_t size) -> std::shared_ptr<Component> {
+            if (size != sizeof(CapsuleShape)) {
+                return ComponentPool<CapsuleMesh>::Create();
+            }
+            CapsuleShape shape;
+            std::memcpy(&shape, data, sizeof(shape));
+            return ComponentPool<CapsuleMesh>::Create(shape.radius, shape.cylinderHeight, shape.sectorCount, shape.hemisphereStacks, shape.cylinderStacks);
+        };
+
+        Codec model;
+        model.asset = [](const Component& component) {
+            return static_cast<const Model&>(component).path;
+        };
+        model.save = [](const Component&, std::vector<unsigned char>&) {};
+        model.load = [](const std::string& asset, const unsigned char*, std::size_t) -> std::shared_ptr<Component> {
+            return ComponentPool<Model>::Create(asset);
+        };
+
+        return std::vector<Entry> {
+            { "Camera", &typeid(Camera), StateCodec<Camera>() },
+            { "CuboidMesh", &typeid(CuboidMesh), StateCodec<CuboidMesh>() },
+            { "SphereMesh", &typeid(SphereMesh), std::move(sphere) },
+            { "CapsuleMesh", &typeid(CapsuleMesh), std::move(capsule) },
+            { "Sprite", &typeid(Sprite), StateCodec<Sprite>() },
+            { "Model", &typeid(Model), std::move(model) },
+        };
+    }();
+    return entries;
+}
+
+void SceneFile::RegisterComponent(const std::string& name, const std::type_info& type, Codec codec) {
+    for (Entry& entry : Entries()) {
+        if (entry.name == name || *entry.type == type) {
+            entry = Entry { name, &type, std::move(codec) };
+            return;
+        }
+    }
+    Entries().push_back({ name, &type, std::move(codec) });
+}
+
+const SceneFile::Entry* SceneFile::FindEntry(const std::string& name) {
+    for (const Entry& entry : Entries()) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const SceneFile::Entry* SceneFile::FindEntry(const std::type_info& type) {
+    for (const Entry& entry : Entries()) {
+        if (*entry.type == type) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void SceneFile::Write(const Scene& scene, const std::string& path) {
+    StringTable strings;
+    std::vector<EntityRecord> entities;
+    std::vector<unsigned char> components;
+    std::vector<unsigned char> payload;
+    std::uint32_t componentCount = 0;
+    std::uint32_t rootCount = 0;
+    TagMask usedTags = 0;
+    std::unordered_set<std::string> leftOut;
+
+    // The payload is the component's bytes
+    auto writeComponent = [&](std::uint32_t entity, const Component& component, const std::string& type, std::uint32_t asset, std::uint32_t flags) {
+        ComponentRecord record { entity, strings.Add(type), asset, NONE, flags, 0 };
+        const auto* render = dynamic_cast<const RenderComponent*>(NativePart(&component));
+        if (render && render->GetSharedTexture()) {
+            record.texture = strings.Add(render->GetSharedTexture()->Path());
+            record.flags |= render->GetSharedTexture()->HasAlpha() ? COMPONENT_TEXTURE_ALPHA : 0;
+        }
+        if (render && render->IsOccluder()) {
+            record.flags |= COMPONENT_OCCLUDER;
+        }
+
+        record.size = static_cast<std::uint32_t>(payload.size());
+        Append(components, record);
+        components.insert(components.end(), payload.begin(), payload.end());
+        components.resize(Align(components.size()));
+        ++componentCount;
+    };
+
+    // Parents first: depth first with an explicit stack, children pushed in reverse to keep their order
+    std::vector<std::pair<const Entity*, std::uint32_t>> stack;
+    const auto& roots = scene.GetRootEntities();
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        if ((*it)->GetScene() == &scene) {
+            stack.emplace_back(it->get(), NONE);
+        }
+    }
+
+    while (!stack.empty()) {
+        const auto [entity, parent] = stack.back();
+        stack.pop_back();
+
+        const std::uint32_t index = static_cast<std::uint32_t>(entities.size());
+        const Transform& transform = entity->GetTransform();
+        const glm::vec3& position = transform.GetLocalPosition();
+        const glm::vec3& rotation = transform.GetLocalRotation();
+        const glm::vec3& scale = transform.GetLocalScale();
+        const glm::quat& quaternion = transform.GetLocalRotationQuat();
+
+        EntityRecord record {};
+        record.parent = parent;
+        record.name = entity->GetName().empty() ? NONE : strings.Add(entity->GetName());
+        record.flags = (entity->IsEnabled() ? FLAG_ENABLED : 0) | (entity->IsStatic() ? FLAG_STATIC : 0);
+        std::memcpy(record.position, &position[0], sizeof(record.position));
+        std::memcpy(record.rotation, &rotation[0], sizeof(record.rotation));
+        std::memcpy(record.scale, &scale[0], sizeof(record.scale));
+        const float xyzw[4] = { quaternion.x, quaternion.y, quaternion.z, quaternion.w };
+        std::memcpy(record.quaternion, xyzw, sizeof(record.quaternion));
+        record.tags = entity->GetTags();
+        entities.push_back(record);
+
+        usedTags |= record.tags;
+        rootCount += parent == NONE ? 1 : 0;
+
+        for (const auto& component : entity->Components()) {
+            const Entry* entry = FindEntry(typeid(*component));
+            if (!entry) {
+                if (leftOut.insert(typeid(*component).name()).second) {
+                    Debug::Warning(std::string("SceneFile: ") + typeid(*component).name() + " has no codec, left out");
+                }
+                continue;
+            }
+
+            payload.clear();
+            entry->codec.save(*component, payload);
+            const std::uint32_t asset = entry->codec.asset ? strings.Add(entry->codec.asset(*component)) : NONE;
+            writeComponent(index, *component, entry->name, asset, 0);
+        }
+
+        for (const auto& script : entity->Scripts()) {
+            payload.clear();
+            try {
+                EncodeState(script->GetPythonState(), payload);
+            }
+            catch (const std::exception& e) {
+                payload.clear();
+                Debug::Warning(std::string("SceneFile: state of a Python component isn't plain data, saved without it: ") + e.what());
+            }
+            writeComponent(index, *script, PythonClassName(py::type::handle_of(script->PyComponent())), NONE, COMPONENT_PYTHON);
+        }
+
+        const auto& children = entity->GetChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+
+    Header header {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entityCount = static_cast<std::uint32_t>(entities.size());
+    header.rootCount = rootCount;
+    header.componentCount = componentCount;
+    for (std::size_t bit = 0; bit < MAX_FILE_TAGS; ++bit) {
+        const std::string& name = SceneIndex::TagName(TagMask(1) << bit);
+        header.tags[bit] = (usedTags >> bit) & 1 && !name.empty() ? strings.Add(name) : NONE;
+    }
+    header.stringCount = static_cast<std::uint32_t>(strings.Size());
+
+    header.entitiesOffset = Align(sizeof(Header));
+    header.componentsOffset = Align(header.entitiesOffset + entities.size() * sizeof(EntityRecord));
+    header.stringsOffset = Align(header.componentsOffset + components.size());
+
+    std::vector<unsigned char> stringData;
+    strings.Write(stringData);
+    header.fileSize = header.stringsOffset + stringData.size();
+
+    std::vector<unsigned char> file(header.fileSize, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    if (!entities.empty()) {
+        std::memcpy(&file[header.entitiesOffset], entities.data(), entities.size() * sizeof(EntityRecord));
+    }
+    if (!components.empty()) {
+        std::memcpy(&file[header.componentsOffset], components.data(), components.size());
+    }
+    if (!stringData.empty()) {
+        std::memcpy(&file[header.stringsOffset], stringData.data(), stringData.size());
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        throw std::runtime_error("SceneFile: can't write '" + path + "'");
+    }
+}
+
+std::vector<std::shared_ptr<Entity>> SceneFile::Read(const std::string& path) {
+    const MappedFile file(path);
+    const unsigned char* data = file.Data();
+    const auto invalid = [&path](const std::string& reason) {
+        return std::runtime_error("SceneFile: '" + path + "' " + reason);
+    };
+
+    Header header;
+    if (file.Size() < sizeof(Header)) {
+        throw invalid("is not a scene file");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw invalid("is not a scene file");
+    }
+    if (header.version != VERSION) {
+        throw invalid("is version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION));
+    }
+
+    const std::size_t stringTableSize = std::size_t(header.stringCount) * 2 * sizeof(std::uint32_t);
+    if (header.fileSize != file.Size()
+        || header.entitiesOffset % ALIGNMENT != 0 || header.componentsOffset % ALIGNMENT != 0 || header.stringsOffset % ALIGNMENT != 0
+        || header.entitiesOffset + std::size_t(header.entityCount) * sizeof(EntityRecord) > header.componentsOffset
+        || header.componentsOffset > header.stringsOffset
+        || header.stringsOffset + stringTableSize > header.fileSize) {
+        throw invalid("is truncated");
+    }
+
+    // The mapping is page aligned and so are the sections within it (8 bytes)
+    const auto* records = reinterpret_cast<const EntityRecord*>(data + header.entitiesOffset);
+    const auto* stringTable = reinterpret_cast<const std::uint32_t*>(data + header.stringsOffset);
+    const char* characters = reinterpret_cast<const char*>(data + header.stringsOffset + stringTableSize);
+    const std::size_t characterCount = header.fileSize - header.stringsOffset - stringTableSize;
+
+    const auto string = [&](std::uint32_t index) {
+        if (index >= header.stringCount) {
+            return std::string();
+        }
+        const std::uint32_t offset = stringTable[index * 2];
+        const std::uint32_t length = stringTable[index * 2 + 1];
+        if (std::size_t(offset) + length > characterCount) {
+            throw invalid("is truncated");
+        }
+        return std::string(characters + offset, length);
+    };
+
+    // Component records are walked once to resolve their types and count them, for preallocation
+    struct TypeSlot {
+        bool resolved = false;
+        const Entry* entry = nullptr;
+        py::object pythonClass;
+        std::size_t count = 0;
+    };
+    std::unordered_map<std::uint32_t, TypeSlot> types;
+    std::vector<std::pair<const ComponentRecord*, const TypeSlot*>> components;
+    components.reserve(header.componentCount);
+
+    for (std::size_t offset = header.componentsOffset; components.size() < header.componentCount;) {
+        if (offset + sizeof(ComponentRecord) > header.stringsOffset) {
+            throw invalid("is truncated");
+        }
+        const auto* record = reinterpret_cast<const ComponentRecord*>(data + offset);
+        offset = Align(offset + sizeof(ComponentRecord) + record->size);
+        if (offset > header.stringsOffset || record->entity >= header.entityCount) {
+            throw invalid("is truncated");
+        }
+        TypeSlot& slot = types[record->type];
+        components.emplace_back(record, &slot);
+        ++slot.count;
+        if (slot.resolved) {
+            continue;
+        }
+
+        slot.resolved = true;
+        const std::string name = string(record->type);
+        if (!(record->flags & COMPONENT_PYTHON)) {
+            slot.entry = FindEntry(name);
+            if (!slot.entry) {
+                Debug::Warning("SceneFile: no codec for " + name + ", left out");
+            }
+        }
+        else if (!Py_IsInitialized()) {
+            Debug::Warning("SceneFile: Python component " + name + " left out, the interpreter is not running");
+        }
+        else {
+            try {
+                slot.pythonClass = FindPythonClass(name);
+                if (!slot.pythonClass) {
+                    Debug::Warning("SceneFile: Python component " + name + " left out, no such component class among the imported modules");
+                }
+            }
+            catch (const py::error_already_set& e) {
+                Debug::Warning("SceneFile: Python component " + name + " left out: " + e.what());
+            }
+        }
+    }
+
+    const std::size_t entityCount = header.entityCount;
+    Registry::ReserveEntities(entityCount);
+    // Children come from the Entity pool, roots (and their shared_ptr control block) from Entity::Create's
+    ComponentPool<Entity>::Reserve(entityCount - std::min<std::size_t>(header.rootCount, entityCount));
+    ComponentPool<Transform>::Reserve(entityCount);
+    for (const auto& [index, slot] : types) {
+        if (slot.entry) {
+            Registry::ReserveComponents(Registry::TypeIdOf(*slot.entry->type), slot.count, entityCount);
+        }
+    }
+
+    // Tag bits of the file to the ones of this process
+    TagMask tagBits[MAX_FILE_TAGS];
+    bool remapTags = false;
+    for (std::size_t bit = 0; bit < MAX_FILE_TAGS; ++bit) {
+        tagBits[bit] = header.tags[bit] != NONE ? SceneIndex::Tag(string(header.tags[bit])) : TagMask(1) << bit;
+        remapTags |= tagBits[bit] != TagMask(1) << bit;
+    }
+
+    std::vector<std::shared_ptr<Entity>> roots;
+    roots.reserve(header.rootCount);
+    std::vector<Entity*> built;
+    built.reserve(entityCount);
+
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        const EntityRecord& record = records[i];
+
+        Entity* entity = nullptr;
+        if (record.parent == NONE) {
+            roots.push_back(Entity::Create());
+            entity = roots.back().get();
+        }
+        else if (record.parent < i) {
+            auto child = std::make_unique<Entity>();
+            entity = child.get();
+            built[record.parent]->AddChild(std::move(child));
+        }
+        else {
+            throw invalid("has a child stored before its parent");
+        }
+        built.push_back(entity);
+
+        Transform& transform = entity->GetTransform();
+        transform.SetLocal(
+            { record.position[0], record.position[1], record.position[2] },
+            { record.rotation[0], record.rotation[1], record.rotation[2] },
+            { record.quaternion[3], record.quaternion[0], record.quaternion[1], record.quaternion[2] },
+            { record.scale[0], record.scale[1], record.scale[2] });
+        entity->SetEnabled((record.flags & FLAG_ENABLED) != 0);
+        entity->SetStatic((record.flags & FLAG_STATIC) != 0);
+
+        if (record.name != NONE) {
+            entity->SetName(string(record.name));
+        }
+
+        TagMask tags = record.tags;
+        if (remapTags) {
+            tags = 0;
+            for (TagMask rest = record.tags; rest; rest &= rest - 1) {
+                std::size_t bit = 0;
+                while (!((rest >> bit) & 1)) {
+                    ++bit;
+                }
+                tags |= tagBits[bit];
+            }
+        }
+        entity->SetTags(tags);
+    }
+
+    for (const auto& [record, slot] : components) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(record + 1);
+        Entity* entity = built[record->entity];
+
+        std::shared_ptr<Component> component;
+        if (slot->entry) {
+            component = slot->entry->codec.load(string(record->asset), bytes, record->size);
+        }
+        else if (slot->pythonClass) {
+            try {
+                // The class runs its __init__, then gets the saved attributes
+                auto script = std::make_shared<PythonComponentWrapper>(slot->pythonClass());
+                if (record->size != 0) {
+                    const unsigned char* state = bytes;
+                    script->SetPythonState(DecodeState(state, bytes + record->size));
+                }
+                component = std::move(script);
+            }
+            catch (const std::exception& e) {
+                Debug::Warning("SceneFile: Python component " + string(record->type) + " left out: " + e.what());
+            }
+        }
+        if (!component) {
+            continue;
+        }
+
+        if (record->texture != NONE || (record->flags & COMPONENT_OCCLUDER)) {
+            if (auto* render = dynamic_cast<RenderComponent*>(NativePart(component.get()))) {
+                if (record->texture != NONE) {
+                    render->SetTexture(AssetsManager::LoadTexture(string(record->texture), (record->flags & COMPONENT_TEXTURE_ALPHA) != 0));
+                }
+                render->SetOccluder((record->flags & COMPONENT_OCCLUDER) != 0);
+            }
+        }
+        entity->AddComponent(std::move(component));
+    }
+
+    return roots;
+}
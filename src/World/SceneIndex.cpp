@@ -0,0 +1,165 @@
+#include "World/SceneIndex.hpp"
+#include "World/Entity.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    const std::vector<Entity*> s_none;
+
+    std::size_t BitIndex(TagMask tag) {
+        std::size_t index = 0;
+        while (!(tag & 1)) {
+            tag >>= 1;
+            ++index;
+        }
+        return index;
+    }
+}
+
+TagMask SceneIndex::Tag(const std::string& name) {
+    auto it = s_tagBits.find(name);
+    if (it != s_tagBits.end()) {
+        return it->second;
+    }
+
+    if (s_tagBits.size() >= MAX_TAGS) {
+        throw std::runtime_error("SceneIndex: too many tags, can't add '" + name + "'");
+    }
+
+    const std::size_t index = s_tagBits.size();
+    const TagMask bit = TagMask(1) << index;
+    s_tagBits.emplace(name, bit);
+    s_tagNames[index] = name;
+    return bit;
+}
+
+const std::string& SceneIndex::TagName(TagMask tag) {
+    static const std::string unnamed;
+    return tag != 0 && (tag & (tag - 1)) == 0 ? s_tagNames[BitIndex(tag)] : unnamed;
+}
+
+void SceneIndex::Bucket::Insert(Entity* entity, EntityId id) {
+    if (id >= sparse.size()) {
+        sparse.resize(id + 1, INVALID_INDEX);
+    }
+    if (sparse[id] != INVALID_INDEX) {
+        return;
+    }
+
+    sparse[id] = static_cast<std::uint32_t>(entities.size());
+    entities.push_back(entity);
+}
+
+void SceneIndex::Bucket::Erase(EntityId id) {
+    if (id >= sparse.size() || sparse[id] == INVALID_INDEX) {
+        return;
+    }
+
+    const std::uint32_t index = sparse[id];
+    Entity* last = entities.back();
+    entities[index] = last;
+    sparse[last->GetId()] = index;
+
+    entities.pop_back();
+    sparse[id] = INVALID_INDEX;
+}
+
+void SceneIndex::Add(Entity* entity) {
+    AddName(entity, entity->GetName());
+    AddTags(entity, entity->GetTags());
+}
+
+void SceneIndex::Remove(Entity* entity) {
+    RemoveName(entity, entity->GetName());
+    RemoveTags(entity, entity->GetTags());
+}
+
+void SceneIndex::Rename(Entity* entity, const std::string& previous) {
+    RemoveName(entity, previous);
+    AddName(entity, entity->GetName());
+}
+
+void SceneIndex::Retag(Entity* entity, TagMask previous) {
+    const TagMask tags = entity->GetTags();
+    RemoveTags(entity, previous & ~tags);
+    AddTags(entity, tags & ~previous);
+}
+
+Entity* SceneIndex::Find(const std::string& name) const {
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second.front() : nullptr;
+}
+
+const std::vector<Entity*>& SceneIndex::FindAll(const std::string& name) const {
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : s_none;
+}
+
+void SceneIndex::FindTagged(TagMask mask, std::vector<Entity*>& out) const {
+    if (mask == 0) {
+        return;
+    }
+
+    const std::vector<Entity*>* smallest = nullptr;
+    for (TagMask rest = mask; rest; rest &= rest - 1) {
+        const std::vector<Entity*>& bucket = m_tags[BitIndex(rest)].entities;
+        if (!smallest || bucket.size() < smallest->size()) {
+            smallest = &bucket;
+        }
+    }
+
+    for (Entity* entity : *smallest) {
+        if ((entity->GetTags() & mask) == mask) {
+            out.push_back(entity);
+        }
+    }
+}
+
+const std::vector<Entity*>& SceneIndex::Tagged(TagMask tag) const {
+    return tag != 0 ? m_tags[BitIndex(tag)].entities : s_none;
+}
+
+void SceneIndex::Clear() {
+    m_names.clear();
+    for (Bucket& bucket : m_tags) {
+        bucket.entities.clear();
+        bucket.sparse.clear();
+    }
+}
+
+void SceneIndex::AddName(Entity* entity, const std::string& name) {
+    if (!name.empty()) {
+        m_names[name].push_back(entity);
+    }
+}
+
+void SceneIndex::RemoveName(Entity* entity, const std::string& name) {
+    if (name.empty()) {
+        return;
+    }
+
+    auto it = m_names.find(name);
+    if (it == m_names.end()) {
+        return;
+    }
+
+    // Almost always a single entity per name
+    std::vector<Entity*>& entities = it->second;
+    entities.erase(std::remove(entities.begin(), entities.end(), entity), entities.end());
+    if (entities.empty()) {
+        m_names.erase(it);
+    }
+}
+
+void SceneIndex::AddTags(Entity* entity, TagMask tags) {
+    for (; tags; tags &= tags - 1) {
+        m_tags[BitIndex(tags)].Insert(entity, entity->GetId());
+    }
+}
+
+void SceneIndex::RemoveTags(Entity* entity, TagMask tags) {
+    for (; tags; tags &= tags - 1) {
+        m_tags[BitIndex(tags)].Erase(entity->GetId());
+    }
+}
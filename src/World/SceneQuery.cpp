@@ -0,0 +1,43 @@
+#include "World/SceneQuery.hpp"
+#include "World/Entity.hpp"
+#include "World/Registry.hpp"
+
+SceneQuery::SceneQuery(std::vector<ComponentTypeId> types) : m_types(std::move(types)) {}
+
+bool SceneQuery::Matches(const Entity& entity) const {
+    for (ComponentTypeId type : m_types) {
+        if (Registry::GetComponent(entity.GetId(), type) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SceneQuery::Add(Entity* entity) {
+    const EntityId id = entity->GetId();
+    if (Contains(id)) {
+        return;
+    }
+
+    if (id >= m_sparse.size()) {
+        m_sparse.resize(id + 1, INVALID_INDEX);
+    }
+
+    m_sparse[id] = static_cast<std::uint32_t>(m_entities.size());
+    m_entities.push_back(entity);
+}
+
+void SceneQuery::Remove(Entity* entity) {
+    const EntityId id = entity->GetId();
+    if (!Contains(id)) {
+        return;
+    }
+
+    const std::uint32_t index = m_sparse[id];
+    Entity* last = m_entities.back();
+    m_entities[index] = last;
+    m_sparse[last->GetId()] = index;
+
+    m_entities.pop_back();
+    m_sparse[id] = INVALID_INDEX;
+}
@@ -0,0 +1,189 @@
+#include "World/SceneSnapshot.hpp"
+#include "World/Scene.hpp"
+#include "World/Entity.hpp"
+#include "World/Registry.hpp"
+#include "Api/PythonComponentWrapper.hpp"
+
+#include <cstring>
+
+namespace {
+    struct ComponentHeader {
+        std::uint32_t entity;
+        std::uint32_t type;
+        std::uint32_t size;
+    };
+}
+
+static_assert(sizeof(glm::quat) == 16 && sizeof(glm::mat4) == 64, "SceneSnapshot expects packed glm types");
+
+bool SceneSnapshot::Chunk::operator==(const Chunk& other) const {
+    static_assert(sizeof(EntityState) == 128, "EntityState must have no padding to be compared as bytes");
+    return entities.size() == other.entities.size() && components == other.components
+        && std::memcmp(entities.data(), other.entities.data(), entities.size() * sizeof(EntityState)) == 0;
+}
+
+std::size_t SceneSnapshot::Chunk::Bytes() const {
+    return entities.size() * sizeof(EntityState) + components.size();
+}
+
+void SceneSnapshot::Flatten(Entity* entity, std::vector<Entity*>& out) {
+    out.push_back(entity);
+    for (const auto& child : entity->GetChildren()) {
+        Flatten(child.get(), out);
+    }
+}
+
+void SceneSnapshot::CaptureEntity(Entity& entity, const std::vector<ComponentTypeId>& stateful, Chunk& chunk) {
+    const Transform& transform = entity.GetTransform();
+
+    EntityState state {};
+    state.handle = entity.GetHandle();
+    state.position = transform.GetLocalPosition();
+    state.rotation = transform.GetLocalRotation();
+    state.scale = transform.GetLocalScale();
+    state.quaternion = transform.GetLocalRotationQuat();
+    state.modelMatrix = transform.GetModelMatrix();
+    state.flags = (entity.IsEnabled() ? FLAG_ENABLED : 0) | (entity.IsStatic() ? FLAG_STATIC : 0);
+
+    const std::uint32_t index = static_cast<std::uint32_t>(chunk.entities.size());
+    chunk.entities.push_back(state);
+
+    const ComponentSignature& signature = Registry::Signature(entity.GetId());
+    for (ComponentTypeId type : stateful) {
+        if (!signature.test(type)) {
+            continue;
+        }
+
+        const Component* component = Registry::Storage(type).Get(entity.GetId());
+        const std::size_t size = component->StateSize();
+
+        const ComponentHeader header { index, static_cast<std::uint32_t>(type), static_cast<std::uint32_t>(size) };
+        const std::size_t offset = chunk.components.size();
+        chunk.components.resize(offset + sizeof(header) + size);
+        std::memcpy(&chunk.components[offset], &header, sizeof(header));
+        component->SaveState(&chunk.components[offset + sizeof(header)]);
+    }
+}
+
+void SceneSnapshot::Capture(const Scene& scene, const SceneSnapshot* previous) {
+    std::vector<Entity*> entities;
+    for (const auto& root : scene.GetRootEntities()) {
+        if (root->GetScene() == &scene) {
+            m_roots.push_back(root);
+            Flatten(root.get(), entities);
+        }
+    }
+    m_entityCount = entities.size();
+
+    // Only the types with state are looked at per entity
+    std::vector<ComponentTypeId> stateful;
+    for (ComponentTypeId type = 0; type < Registry::TypeCount(); ++type) {
+        const ComponentStorage& storage = Registry::Storage(type);
+        if (storage.Size() > 0 && storage.Get(storage.Entities()[0])->StateSize() > 0) {
+            stateful.push_back(type);
+        }
+    }
+
+    // Chunks are built in a scratch one, only copied out when they differ from the previous snapshot
+    Chunk scratch;
+    for (std::size_t begin = 0; begin < entities.size(); begin += CHUNK_SIZE) {
+        const std::size_t end = std::min(begin + CHUNK_SIZE, entities.size());
+        scratch.entities.clear();
+        scratch.components.clear();
+        scratch.entities.reserve(CHUNK_SIZE);
+        for (std::size_t i = begin; i < end; ++i) {
+            CaptureEntity(*entities[i], stateful, scratch);
+        }
+
+        const std::size_t index = m_chunks.size();
+        if (previous && index < previous->m_chunks.size() && *previous->m_chunks[index] == scratch) {
+            m_chunks.push_back(previous->m_chunks[index]);
+            ++m_sharedChunks;
+        }
+        else {
+            m_ownBytes += scratch.Bytes();
+            m_chunks.push_back(std::make_shared<const Chunk>(std::move(scratch)));
+            scratch = Chunk();
+        }
+    }
+
+    if (Py_IsInitialized()) {
+        for (Entity* entity : entities) {
+            for (const auto& script : entity->Scripts()) {
+                m_scripts.push_back({ script, std::make_shared<const py::object>(script->GetPythonState()) });
+            }
+        }
+    }
+}
+
+void SceneSnapshot::Apply(Scene& scene) const {
+    // Roots added since go (destroyed unless held elsewhere), the ones removed since come back
+    std::vector<bool> isSnapshotRoot(Registry::EntitySlots(), false);
+    for (const auto& root : m_roots) {
+        isSnapshotRoot[root->GetId()] = true;
+    }
+
+    std::vector<Entity*> added;
+    for (const auto& root : scene.GetRootEntities()) {
+        if (!isSnapshotRoot[root->GetId()]) {
+            added.push_back(root.get());
+        }
+    }
+    for (Entity* root : added) {
+        scene.RemoveEntity(root);
+    }
+
+    for (const auto& root : m_roots) {
+        if (root->GetScene() != &scene && !root->GetParent()) {
+            scene.AddEntity(root);
+        }
+    }
+
+    std::vector<Entity*> restored;
+    restored.reserve(m_entityCount);
+
+    for (const auto& chunk : m_chunks) {
+        Entity* entities[CHUNK_SIZE];
+        for (std::size_t i = 0; i < chunk->entities.size(); ++i) {
+            const EntityState& state = chunk->entities[i];
+            Entity* entity = Registry::Resolve(state.handle);
+            entities[i] = entity;
+            if (!entity) {
+                continue;
+            }
+
+            entity->GetTransform().RestoreState(state.position, state.rotation, state.quaternion, state.scale, state.modelMatrix);
+            entity->SetEnabled((state.flags & FLAG_ENABLED) != 0);
+            entity->SetStatic((state.flags & FLAG_STATIC) != 0);
+            restored.push_back(entity);
+        }
+
+        for (std::size_t offset = 0; offset < chunk->components.size();) {
+            ComponentHeader header;
+            std::memcpy(&header, &chunk->components[offset], sizeof(header));
+            const unsigned char* data = &chunk->components[offset + sizeof(header)];
+            offset += sizeof(header) + header.size;
+
+            Entity* entity = entities[header.entity];
+            if (!entity) {
+                continue;
+            }
+
+            // Removed since, or replaced by another type: nothing to put the bytes back into
+            Component* component = Registry::GetComponent(entity->GetId(), static_cast<ComponentTypeId>(header.type));
+            if (component && component->StateSize() == header.size) {
+                component->LoadState(data);
+            }
+        }
+    }
+
+    Registry::MarkChanged(restored);
+
+    if (Py_IsInitialized()) {
+        for (const ScriptState& script : m_scripts) {
+            if (std::shared_ptr<PythonComponentWrapper> wrapper = script.script.lock()) {
+                wrapper->SetPythonState(*static_cast<const py::object*>(script.state.get()));
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "World/UpdateScheduler.hpp"
+#include "World/Entity.hpp"
+#include "World/Registry.hpp"
+#include "Api/PythonComponentWrapper.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+void UpdateScheduler::SetBudget(float milliseconds) {
+    m_budget = std::max(milliseconds, 0.0f);
+}
+
+float UpdateScheduler::Budget() const {
+    return m_budget;
+}
+
+void UpdateScheduler::SetDistances(float nearDistance, float farDistance) {
+    m_nearDistance = std::max(nearDistance, 0.0f);
+    m_farDistance = std::max(farDistance, m_nearDistance);
+}
+
+float UpdateScheduler::NearDistance() const {
+    return m_nearDistance;
+}
+
+float UpdateScheduler::FarDistance() const {
+    return m_farDistance;
+}
+
+std::uint32_t UpdateScheduler::Interval(UpdatePriority priority, std::size_t band) {
+    static constexpr std::uint32_t intervals[UPDATE_PRIORITY_COUNT][3] = {
+        { 1, 1, 1 }, // Critical
+        { 1, 1, 2 }, // High
+        { 1, 2, 4 }, // Normal
+        { 2, 4, MAX_INTERVAL } // Low
+    };
+    return intervals[static_cast<std::size_t>(priority)][std::min<std::size_t>(band, 2)];
+}
+
+std::size_t UpdateScheduler::Band(EntityId entity, const glm::vec3& viewer) const {
+    const Entity* owner = Registry::GetEntity(entity);
+    if (!owner) {
+        return 0;
+    }
+
+    const glm::vec3 offset = owner->GetTransform().GetGlobalPosition() - viewer;
+    const float distance2 = glm::dot(offset, offset);
+    if (distance2 < m_nearDistance * m_nearDistance) {
+        return 0;
+    }
+    return distance2 < m_farDistance * m_farDistance ? 1 : 2;
+}
+
+void UpdateScheduler::Run(const std::vector<PythonComponentWrapper*>& scripts, const Scene* scene, const glm::vec3* viewer, float deltaTime) {
+    using Clock = std::chrono::steady_clock;
+
+    ++m_frame;
+    m_updated = 0;
+    m_deferred = 0;
+
+    const std::size_t count = scripts.size();
+    if (count == 0) {
+        return;
+    }
+
+    // Starting where the budget ran out last time, the same scripts are not always the ones cut
+    const std::size_t start = m_cursor < count ? m_cursor : 0;
+    m_cursor = 0;
+
+    const Clock::time_point begin = Clock::now();
+    bool exhausted = false;
+
+    // By index: an update may add scripts, which wait for the next frame
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::size_t i = (start + k) % count;
+        PythonComponentWrapper* script = scripts[i];
+        if (!script) {
+            continue;
+        }
+
+        const EntityId entity = script->GetOwnerHandle().index;
+        if (Registry::GetScene(entity) != scene || !Registry::IsUpdated(entity)) {
+            continue;
+        }
+
+        ScheduleState& state = script->Schedule();
+        state.pendingDelta += deltaTime;
+
+        const UpdatePriority priority = script->GetUpdatePriority();
+        if (priority != UpdatePriority::Critical) {
+            if (!state.overdue) {
+                const std::uint32_t interval = Interval(priority, viewer ? Band(entity, *viewer) : 0);
+
+                // Offset by the entity index so scripts sharing an interval don't all land on the same frame
+                if ((m_frame + entity) % interval != 0) {
+                    ++m_deferred;
+                    continue;
+                }
+            }
+
+            if (exhausted) {
+                state.overdue = true;
+                ++m_deferred;
+                continue;
+            }
+        }
+
+        script->SetDeltaTime(state.pendingDelta);
+        state.pendingDelta = 0.0f;
+        state.overdue = false;
+        script->Update();
+        ++m_updated;
+
+        if (m_budget > 0.0f && !exhausted) {
+            const std::chrono::duration<float, std::milli> elapsed = Clock::now() - begin;
+            if (elapsed.count() >= m_budget) {
+                exhausted = true;
+                m_cursor = (i + 1) % count;
+            }
+        }
+    }
+}
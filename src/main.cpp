@@ -1,7 +1,14 @@
 #include "Core/Window.hpp"
 #include "Api/Nora.hpp"
+#include "Core/Benchmark.hpp"
+
+#include <cstring>
+
+int main(int argc, char** argv) {
+	if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+		return Benchmark::RunAll();
+	}
 
-int main() {
 	try {
 		py::scoped_interpreter guard{};
 		py::module_ sys = py::module_::import("sys");